@@ -0,0 +1,102 @@
+// Compares per-write transactions with GroupCommitWriter when several
+// threads write to one on-disk database:
+//   per-write    - each write takes the connection and runs in its own
+//                  BEGIN/COMMIT (one fsync per write)
+//   group commit - writes go through GroupCommitWriter and share commits
+//
+// Usage: bench_group_commit [threads] [writes_per_thread] [path]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+
+using namespace sqlgen::literals;
+
+namespace {
+
+struct Account {
+    int64_t id;
+    int64_t balance;
+};
+
+sqlgen::sqlite::Connection setup(const std::string& path, int threads) {
+    std::remove(path.c_str());
+    auto conn = sqlgen::sqlite::connect(path);
+    if (!conn || !conn->execute(sqlgen::create_table<Account>())) {
+        std::fprintf(stderr, "setup failed\n");
+        std::exit(1);
+    }
+
+    std::vector<Account> accounts;
+    for (int t = 0; t < threads; ++t) {
+        accounts.push_back({t, 0});
+    }
+    if (!conn->insert_all(accounts)) {
+        std::fprintf(stderr, "setup failed\n");
+        std::exit(1);
+    }
+    return std::move(*conn);
+}
+
+template <class Write>
+double run(const char* label, int threads, int writes, Write&& write) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < writes; ++i) {
+                auto update = sqlgen::update<Account>(sqlgen::set("balance"_c, i)) | sqlgen::where("id"_c == t);
+                if (!write(update)) {
+                    std::fprintf(stderr, "%s failed\n", label);
+                    std::exit(1);
+                }
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rate = static_cast<double>(threads) * writes / elapsed;
+    std::printf("%-16s %3d threads x %6d writes %9.3f s %12.0f writes/s\n", label, threads, writes, elapsed, rate);
+    return rate;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? std::atoi(argv[1]) : 8;
+    int writes = argc > 2 ? std::atoi(argv[2]) : 200;
+    std::string path = argc > 3 ? argv[3] : "bench_group_commit.db";
+
+    double single;
+    {
+        auto conn = setup(path, threads);
+        std::mutex mutex;
+        single = run("per-write", threads, writes, [&](const auto& update) {
+            std::lock_guard lock(mutex);
+            return conn.begin_transaction() && conn.execute(update) && conn.commit();
+        });
+    }
+
+    double grouped;
+    {
+        sqlgen::sqlite::GroupCommitWriter writer(setup(path, threads));
+        grouped = run("group commit", threads, writes, [&](const auto& update) {
+            return writer.submit(update).get().has_value();
+        });
+        std::printf("  mean batch: %.1f writes\n", writer.stats().mean_batch());
+    }
+
+    std::printf("group / per-write: %.2fx\n", grouped / single);
+    std::remove(path.c_str());
+    return 0;
+}
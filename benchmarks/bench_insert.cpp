@@ -0,0 +1,96 @@
+// Compares the two bulk ingest paths of sqlite::Connection:
+//   insert_all     - one single-row statement, stepped once per row
+//   insert_batched - multi-row VALUES statements sized by the variable limit
+// for a narrow and a wide table.
+//
+// Usage: bench_insert [rows] [chunk_size]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+
+namespace {
+
+struct Narrow {
+    int64_t id;
+    int64_t value;
+    double score;
+};
+
+struct Wide {
+    int64_t id;
+    int64_t a, b, c, d;
+    double e, f, g, h;
+    std::string i, j, k, l;
+    std::optional<std::string> m, n, o;
+};
+
+Narrow make_row(Narrow*, int64_t i) {
+    return {i, i * 7, static_cast<double>(i) * 0.25};
+}
+
+Wide make_row(Wide*, int64_t i) {
+    std::string s = "value-" + std::to_string(i);
+    return {i, i, i + 1, i + 2, i + 3, 0.5, 1.5, 2.5, 3.5, s, s, s, s,
+            s, std::nullopt, i % 2 ? std::optional<std::string>(s) : std::nullopt};
+}
+
+template <class T, class Insert>
+double run(const char* label, size_t rows, Insert&& insert) {
+    auto conn = sqlgen::sqlite::connect(":memory:");
+    if (!conn || !conn->execute(sqlgen::create_table<T>())) {
+        std::fprintf(stderr, "setup failed\n");
+        std::exit(1);
+    }
+
+    std::vector<T> data;
+    data.reserve(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        data.push_back(make_row(static_cast<T*>(nullptr), static_cast<int64_t>(i)));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = insert(*conn, data);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!result) {
+        std::fprintf(stderr, "%s failed: %s\n", label, result.error().c_str());
+        std::exit(1);
+    }
+
+    double rate = static_cast<double>(rows) / elapsed;
+    std::printf("%-28s %10zu rows %9.3f s %12.0f rows/s\n", label, rows, elapsed, rate);
+    return rate;
+}
+
+template <class T>
+void compare(const char* table, size_t rows, size_t chunk_size) {
+    std::printf("%s (%zu fields, up to %zu rows per batched statement)\n", table,
+                sqlgen::Insert<T>::field_count,
+                sqlgen::sqlite::connect(":memory:")->max_insert_rows<T>());
+
+    double loop = run<T>("  insert_all", rows, [&](auto& conn, const auto& data) {
+        return conn.insert_all(data, chunk_size);
+    });
+    double batched = run<T>("  insert_batched", rows, [&](auto& conn, const auto& data) {
+        return conn.insert_batched(data, chunk_size);
+    });
+
+    std::printf("  batched / loop: %.2fx\n\n", batched / loop);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    size_t chunk_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10)
+                                 : sqlgen::sqlite::Connection::default_insert_chunk_size;
+
+    compare<Narrow>("Narrow", rows, chunk_size);
+    compare<Wide>("Wide", rows, chunk_size);
+    return 0;
+}
@@ -0,0 +1,85 @@
+// Measures how fast floating point literals are rendered into SQL text:
+//   to_string + trim - the previous formatting (six fixed decimals)
+//   emit             - shortest round-trip std::to_chars into one buffer
+// and a WHERE clause with a double threshold rendered through to_sql().
+//
+// Usage: bench_literals [values]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+
+using namespace sqlgen::literals;
+
+namespace {
+
+struct Price {
+    int64_t id;
+    double amount;
+};
+
+std::string to_string_trimmed(double value) {
+    std::string str = std::to_string(value);
+    if (str.find('.') != std::string::npos) {
+        str.erase(str.find_last_not_of('0') + 1, std::string::npos);
+        if (str.back() == '.') {
+            str.pop_back();
+        }
+    }
+    return str;
+}
+
+template <class Render>
+void run(const char* label, const std::vector<double>& values, Render&& render) {
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (double value : values) {
+        bytes += render(value);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double rate = static_cast<double>(values.size()) / elapsed;
+    std::printf("%-28s %10zu values %9.3f s %12.0f values/s %8.1f MB/s\n", label, values.size(), elapsed,
+                rate, static_cast<double>(bytes) / elapsed / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    // Prices with cents and a spread of magnitudes, like pricing thresholds
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int64_t> cents(1, 10'000'000);
+    std::uniform_int_distribution<int> scale(0, 6);
+    std::vector<double> values;
+    values.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        double value = static_cast<double>(cents(rng)) / 100.0;
+        for (int s = scale(rng); s > 0; --s) {
+            value /= 10.0;
+        }
+        values.push_back(value);
+    }
+
+    run("  to_string + trim", values, [](double value) {
+        return to_string_trimmed(value).size();
+    });
+
+    std::string buffer;
+    run("  emit", values, [&](double value) {
+        buffer.clear();
+        sqlgen::transpilation::emit(buffer, value);
+        return buffer.size();
+    });
+
+    run("  select ... where to_sql()", values, [](double value) {
+        return (sqlgen::select_from<Price>("id"_c) | sqlgen::where("amount"_c > value)).to_sql().size();
+    });
+    return 0;
+}
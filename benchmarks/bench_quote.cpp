@@ -0,0 +1,77 @@
+// Measures string literal quoting over payloads from 16 B to 1 MB:
+//   per-char  - the previous loop appending one character at a time
+//   memchr    - append_string_literal, bulk-copying the spans between quotes
+// for text without quotes and text with a quote every ~64 bytes.
+//
+// Usage: bench_quote [total_mb]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include "sqlgen/transpilation_core.hpp"
+
+namespace {
+
+void quote_per_char(std::string& out, std::string_view value) {
+    out += '\'';
+    for (char c : value) {
+        if (c == '\'') {
+            out += "''";
+        } else {
+            out += c;
+        }
+    }
+    out += '\'';
+}
+
+std::string make_payload(size_t size, bool with_quotes) {
+    std::mt19937 rng(static_cast<unsigned>(size));
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<int> quote(0, 63);
+    std::string payload(size, ' ');
+    for (char& c : payload) {
+        c = with_quotes && quote(rng) == 0 ? '\'' : static_cast<char>(letter(rng));
+    }
+    return payload;
+}
+
+template <class Quote>
+double run(const std::string& payload, size_t total_bytes, Quote&& quote) {
+    const size_t iterations = total_bytes / payload.size() + 1;
+    std::string out;
+    size_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        out.clear();
+        quote(out, payload);
+        sink += out.size();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (sink == 0) {
+        std::exit(1);
+    }
+    return static_cast<double>(iterations * payload.size()) / elapsed / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t total_mb = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+    const size_t total_bytes = total_mb << 20;
+
+    std::printf("%-10s %-8s %14s %14s %9s\n", "payload", "quotes", "per-char MB/s", "memchr MB/s", "speedup");
+    for (size_t size : {size_t{16}, size_t{256}, size_t{4} << 10, size_t{64} << 10, size_t{1} << 20}) {
+        for (bool with_quotes : {false, true}) {
+            const std::string payload = make_payload(size, with_quotes);
+            double per_char = run(payload, total_bytes, quote_per_char);
+            double memchr = run(payload, total_bytes, sqlgen::transpilation::append_string_literal);
+            std::printf("%-10zu %-8s %14.0f %14.0f %8.1fx\n", size, with_quotes ? "1/64" : "none",
+                        per_char, memchr, memchr / per_char);
+        }
+    }
+    return 0;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -8,6 +9,7 @@
 #include "core.hpp"
 #include "query_clauses.hpp"
 #include "transpilation_sql_gen.hpp"
+#include "transpilation_params.hpp"
 
 namespace sqlgen {
 
@@ -20,74 +22,148 @@ template <class TableType, class FieldsTuple = Nothing, class JoinListType = Not
           class WhereType = Nothing, class GroupByType = Nothing, class HavingType = Nothing,
           class OrderByType = Nothing, class LimitType = Nothing>
 struct SelectFrom {
+    /// Whether the SQL only depends on the table type (SELECT * FROM Table)
+    static constexpr bool static_shape =
+        std::is_same_v<FieldsTuple, Nothing> && std::is_same_v<JoinListType, Nothing> &&
+        std::is_same_v<WhereType, Nothing> && std::is_same_v<GroupByType, Nothing> &&
+        std::is_same_v<HavingType, Nothing> && std::is_same_v<OrderByType, Nothing> &&
+        std::is_same_v<LimitType, Nothing>;
+
+    /// Size hint of the SQL text: exact apart from string values and numbers
+    static constexpr size_t sql_size =
+        7 + (std::is_same_v<FieldsTuple, Nothing>
+                 ? (std::is_same_v<JoinListType, Nothing> ? transpilation::quoted_field_list<TableType>.size()
+                                                          : transpilation::qualified_field_list<TableType>.size())
+                 : transpilation::sql_size_v<FieldsTuple>) +
+        6 + transpilation::quoted_table_name<TableType>.size() +
+        transpilation::clause_sql_size<JoinListType>(1) +
+        transpilation::clause_sql_size<WhereType>(7) +
+        transpilation::clause_sql_size<GroupByType>(10) +
+        transpilation::clause_sql_size<HavingType>(8) +
+        transpilation::clause_sql_size<OrderByType>(10) +
+        transpilation::clause_sql_size<LimitType>(7);
+
     /// Convert to SQL string
-    std::string to_sql() const {
-        std::string sql = "SELECT ";
+    /// A static shape returns a view of text built at compile time
+    std::conditional_t<static_shape, std::string_view, std::string> to_sql() const {
+        if constexpr (static_shape) {
+            return transpilation::static_string<[] {
+                std::string sql;
+                SelectFrom{}.emit(sql);
+                return sql;
+            }>.view();
+        } else {
+            std::string sql;
+            sql.reserve(sql_size);
+            emit(sql);
+            return sql;
+        }
+    }
+
+    /// Append the SQL to out, so callers can reuse one buffer across queries
+    constexpr void emit(std::string& out) const {
+        if constexpr (static_shape) {
+            if !consteval {
+                out += to_sql();
+                return;
+            }
+        }
+
+        out += "SELECT ";
 
         // Add fields
         if constexpr (std::is_same_v<FieldsTuple, Nothing>) {
             // SELECT * - use table prefix if there are JOINs
             if constexpr (!std::is_same_v<JoinListType, Nothing>) {
-                sql += transpilation::select_field_list<TableType>(transpilation::get_table_name<TableType>());
+                transpilation::append_static(out, transpilation::qualified_field_list<TableType>);
             } else {
-                sql += transpilation::select_field_list<TableType>();
+                transpilation::append_static(out, transpilation::quoted_field_list<TableType>);
             }
         } else {
             // SELECT specified fields
-            bool first = true;
-            std::apply([&](const auto&... fields) {
-                (([&] {
-                    if (first) {
-                        sql += transpilation::to_sql(fields);
-                        first = false;
-                    } else {
-                        sql += ", " + transpilation::to_sql(fields);
-                    }
-                }()), ...);
-            }, fields_);
+            transpilation::emit(out, fields_);
         }
 
         // Add FROM
-        sql += " FROM ";
-        sql += transpilation::quote_identifier(transpilation::get_table_name<TableType>());
+        out += " FROM ";
+        transpilation::append_static(out, transpilation::quoted_table_name<TableType>);
 
         // Add JOINs if specified
         if constexpr (!std::is_same_v<JoinListType, Nothing>) {
-            sql += " ";
-            sql += transpilation::joins_sql(joins_);
+            out += ' ';
+            transpilation::emit(out, joins_);
         }
 
         // Add WHERE if specified
         if constexpr (!std::is_same_v<WhereType, Nothing>) {
-            sql += " ";
-            sql += transpilation::where_clause(where_);
+            out += ' ';
+            transpilation::emit_where(out, where_);
         }
 
         // Add GROUP BY if specified
         if constexpr (!std::is_same_v<GroupByType, Nothing>) {
-            sql += " ";
-            sql += transpilation::group_by_sql(group_by_.columns);
+            out += ' ';
+            transpilation::emit_group_by(out, group_by_.columns);
         }
 
         // Add HAVING if specified
         if constexpr (!std::is_same_v<HavingType, Nothing>) {
-            sql += " ";
-            sql += transpilation::having_clause(having_);
+            out += ' ';
+            transpilation::emit_having(out, having_);
         }
 
         // Add ORDER BY if specified
         if constexpr (!std::is_same_v<OrderByType, Nothing>) {
-            sql += " ";
-            sql += transpilation::order_by_sql(order_by_.columns);
+            out += ' ';
+            transpilation::emit_order_by(out, order_by_.columns);
         }
 
         // Add LIMIT if specified
-        if constexpr (!std::is_same_v<LimitType, Nothing>) {
-            sql += " ";
-            sql += transpilation::limit_sql(limit_.limit_value, limit_.offset_value);
+        if constexpr (std::is_same_v<LimitType, Limit>) {
+            out += ' ';
+            transpilation::emit_limit(out, limit_.limit_value, limit_.offset_value);
+        } else if constexpr (!std::is_same_v<LimitType, Nothing>) {
+            out += ' ';
+            transpilation::emit_limit(out, limit_);
         }
+    }
 
-        return sql;
+    /// Convert to SQL with numbered placeholders (?1, ?2, ...) instead of
+    /// inlined literals; returns the SQL together with the typed tuple of
+    /// values to bind. The SQL text only depends on the query type.
+    auto to_parameterized_sql() const {
+        size_t next = 1;
+        auto fields = transpilation::parameterize(fields_, next);
+        auto joins = transpilation::parameterize(joins_, next);
+        auto where = transpilation::parameterize(where_, next);
+        auto group_by = transpilation::parameterize(group_by_, next);
+        auto having = transpilation::parameterize(having_, next);
+        auto order_by = transpilation::parameterize(order_by_, next);
+        auto limit = transpilation::parameterize(limit_, next);
+
+        using Shape = SelectFrom<TableType, decltype(fields), decltype(joins), decltype(where),
+                                 decltype(group_by), decltype(having), decltype(order_by), decltype(limit)>;
+        const Shape shape{
+            .fields_ = fields,
+            .joins_ = joins,
+            .where_ = where,
+            .group_by_ = group_by,
+            .having_ = having,
+            .order_by_ = order_by,
+            .limit_ = limit
+        };
+
+        auto values = params();
+        return transpilation::ParameterizedSql<decltype(values)>{std::string(shape.to_sql()), std::move(values)};
+    }
+
+    /// Values bound by to_parameterized_sql(), without building the SQL
+    auto params() const {
+        return std::tuple_cat(
+            transpilation::bound_values(fields_), transpilation::bound_values(joins_),
+            transpilation::bound_values(where_), transpilation::bound_values(group_by_),
+            transpilation::bound_values(having_), transpilation::bound_values(order_by_),
+            transpilation::bound_values(limit_));
     }
 
     /// Pipe operator for JOINs - single JOIN
@@ -455,23 +531,104 @@ auto select_from(const FieldTypes&... fields) {
 // ============================================================================
 
 /// INSERT query builder
-template <class TableType>
+/// MultiRow builders come from rows(n) and insert n rows per statement
+template <class TableType, class ReturningType = Nothing, bool MultiRow = false>
 struct Insert {
+    /// Number of placeholders per row
+    static constexpr size_t field_count = glz::detail::count_members<TableType>;
+
+    /// Whether the SQL only depends on the table type and or_replace_
+    static constexpr bool static_shape = !MultiRow && std::is_same_v<ReturningType, Nothing>;
+
+    /// Size hint of the SQL text
+    static constexpr size_t sql_size =
+        23 + transpilation::quoted_table_name<TableType>.size() + 2 +
+        transpilation::quoted_field_list<TableType>.size() + 9 + 3 * field_count +
+        transpilation::returning_clause_size<TableType, ReturningType>;
+
     /// Convert to SQL string (returns statement with placeholders)
-    std::string to_sql() const {
-        std::string sql = or_replace_ ? "INSERT OR REPLACE INTO " : "INSERT INTO ";
+    /// A static shape returns a view of text built at compile time
+    std::conditional_t<static_shape, std::string_view, std::string> to_sql() const {
+        if constexpr (static_shape) {
+            return or_replace_
+                ? transpilation::static_string<[] {
+                      std::string sql;
+                      Insert{.or_replace_ = true}.emit(sql);
+                      return sql;
+                  }>.view()
+                : transpilation::static_string<[] {
+                      std::string sql;
+                      Insert{}.emit(sql);
+                      return sql;
+                  }>.view();
+        } else {
+            std::string sql;
+            sql.reserve(sql_size + (rows_ > 1 ? rows_ - 1 : 0) * (3 * field_count + 2));
+            emit(sql);
+            return sql;
+        }
+    }
+
+    /// Append the SQL to out, so callers can reuse one buffer across queries
+    /// With rows(n), the VALUES clause holds n placeholder tuples
+    constexpr void emit(std::string& out) const {
+        if constexpr (static_shape) {
+            if !consteval {
+                out += to_sql();
+                return;
+            }
+        }
 
-        sql += transpilation::quote_identifier(transpilation::get_table_name<TableType>());
-        sql += " (";
-        sql += transpilation::insert_field_list<TableType>();
-        sql += ") VALUES (";
-        sql += transpilation::insert_placeholders<TableType>();
-        sql += ")";
+        out += or_replace_ ? "INSERT OR REPLACE INTO " : "INSERT INTO ";
 
-        return sql;
+        transpilation::append_static(out, transpilation::quoted_table_name<TableType>);
+        out += " (";
+        transpilation::append_insert_field_list<TableType>(out);
+        out += ") VALUES ";
+
+        for (size_t i = 0; i < rows_; ++i) {
+            if (i > 0) out += ", ";
+            out += '(';
+            transpilation::append_insert_placeholders<TableType>(out);
+            out += ')';
+        }
+
+        // Add RETURNING if specified
+        if constexpr (!std::is_same_v<ReturningType, Nothing>) {
+            out += ' ';
+            transpilation::emit_returning<TableType>(out, returning_.columns);
+        }
+    }
+
+    /// Insert n rows per statement (multi-row VALUES)
+    /// Row i binds to parameters i * field_count + 1 .. (i + 1) * field_count
+    /// A VALUES clause needs at least one row, so n = 0 is taken as 1
+    auto rows(size_t n) const {
+        return Insert<TableType, ReturningType, true>{
+            .or_replace_ = or_replace_,
+            .rows_ = std::max<size_t>(n, 1),
+            .returning_ = returning_
+        };
+    }
+
+    /// Pipe operator for RETURNING clause
+    /// The statement then yields one row per inserted row; query it (or
+    /// step it after bind_row) instead of executing it
+    template <class... ColTypes>
+    friend auto operator|(const Insert& i, const Returning<ColTypes...>& r) {
+        static_assert(std::is_same_v<ReturningType, Nothing>,
+                     "Cannot call returning() twice");
+
+        return Insert<TableType, Returning<ColTypes...>, MultiRow>{
+            .or_replace_ = i.or_replace_,
+            .rows_ = i.rows_,
+            .returning_ = r
+        };
     }
 
     bool or_replace_ = false;
+    size_t rows_ = 1;
+    ReturningType returning_{};
 };
 
 /// Create an INSERT INTO Table query
@@ -491,35 +648,67 @@ auto insert_or_replace() {
 // ============================================================================
 
 /// UPDATE query builder
-template <class TableType, class SetsTuple, class WhereType = Nothing>
+template <class TableType, class SetsTuple, class WhereType = Nothing, class ReturningType = Nothing>
 struct Update {
+    /// Size hint of the SQL text
+    static constexpr size_t sql_size =
+        12 + transpilation::quoted_table_name<TableType>.size() +
+        transpilation::sql_size_v<SetsTuple> +
+        transpilation::clause_sql_size<WhereType>(7) +
+        transpilation::returning_clause_size<TableType, ReturningType>;
+
     /// Convert to SQL string
     std::string to_sql() const {
-        std::string sql = "UPDATE ";
+        std::string sql;
+        sql.reserve(sql_size);
+        emit(sql);
+        return sql;
+    }
 
-        sql += transpilation::quote_identifier(transpilation::get_table_name<TableType>());
-        sql += " SET ";
+    /// Append the SQL to out, so callers can reuse one buffer across queries
+    void emit(std::string& out) const {
+        out += "UPDATE ";
+        transpilation::append_static(out, transpilation::quoted_table_name<TableType>);
+        out += " SET ";
 
         // Add SET clauses
-        bool first = true;
-        std::apply([&](const auto&... sets) {
-            (([&] {
-                if (first) {
-                    sql += transpilation::to_sql(sets);
-                    first = false;
-                } else {
-                    sql += ", " + transpilation::to_sql(sets);
-                }
-            }()), ...);
-        }, sets_);
+        transpilation::emit(out, sets_);
 
         // Add WHERE if specified
         if constexpr (!std::is_same_v<WhereType, Nothing>) {
-            sql += " ";
-            sql += transpilation::where_clause(where_);
+            out += ' ';
+            transpilation::emit_where(out, where_);
         }
 
-        return sql;
+        // Add RETURNING if specified
+        if constexpr (!std::is_same_v<ReturningType, Nothing>) {
+            out += ' ';
+            transpilation::emit_returning<TableType>(out, returning_.columns);
+        }
+    }
+
+    /// Convert to SQL with numbered placeholders instead of inlined literals
+    auto to_parameterized_sql() const {
+        size_t next = 1;
+        auto sets = transpilation::parameterize(sets_, next);
+        auto where = transpilation::parameterize(where_, next);
+        auto returning = transpilation::parameterize(returning_, next);
+
+        const Update<TableType, decltype(sets), decltype(where), decltype(returning)> shape{
+            .sets_ = sets,
+            .where_ = where,
+            .returning_ = returning
+        };
+
+        auto values = params();
+        return transpilation::ParameterizedSql<decltype(values)>{shape.to_sql(), std::move(values)};
+    }
+
+    /// Values bound by to_parameterized_sql(), without building the SQL
+    auto params() const {
+        return std::tuple_cat(transpilation::bound_values(sets_),
+                              transpilation::bound_values(where_),
+                              transpilation::bound_values(returning_));
     }
 
     /// Pipe operator for WHERE clause
@@ -528,14 +717,29 @@ struct Update {
         static_assert(std::is_same_v<WhereType, Nothing>,
                      "Cannot call where() twice");
 
-        return Update<TableType, SetsTuple, ConditionType>{
+        return Update<TableType, SetsTuple, ConditionType, ReturningType>{
+            .sets_ = u.sets_,
+            .where_ = w.condition,
+            .returning_ = u.returning_
+        };
+    }
+
+    /// Pipe operator for RETURNING clause
+    template <class... ColTypes>
+    friend auto operator|(const Update& u, const Returning<ColTypes...>& r) {
+        static_assert(std::is_same_v<ReturningType, Nothing>,
+                     "Cannot call returning() twice");
+
+        return Update<TableType, SetsTuple, WhereType, Returning<ColTypes...>>{
             .sets_ = u.sets_,
-            .where_ = w.condition
+            .where_ = u.where_,
+            .returning_ = r
         };
     }
 
     SetsTuple sets_;
     WhereType where_;
+    ReturningType returning_{};
 };
 
 /// Create an UPDATE Table SET ... query
@@ -560,35 +764,87 @@ auto set(const Col& col, const Value& val) {
 // ============================================================================
 
 /// DELETE FROM query builder
-template <class TableType, class WhereType = Nothing>
+template <class TableType, class WhereType = Nothing, class ReturningType = Nothing>
 struct DeleteFrom {
+    /// Size hint of the SQL text
+    static constexpr size_t sql_size =
+        12 + transpilation::quoted_table_name<TableType>.size() +
+        transpilation::clause_sql_size<WhereType>(7) +
+        transpilation::returning_clause_size<TableType, ReturningType>;
+
     /// Convert to SQL string
     std::string to_sql() const {
-        std::string sql = "DELETE FROM ";
+        std::string sql;
+        sql.reserve(sql_size);
+        emit(sql);
+        return sql;
+    }
 
-        sql += transpilation::quote_identifier(transpilation::get_table_name<TableType>());
+    /// Append the SQL to out, so callers can reuse one buffer across queries
+    void emit(std::string& out) const {
+        out += "DELETE FROM ";
+        transpilation::append_static(out, transpilation::quoted_table_name<TableType>);
 
         // Add WHERE if specified
         if constexpr (!std::is_same_v<WhereType, Nothing>) {
-            sql += " ";
-            sql += transpilation::where_clause(where_);
+            out += ' ';
+            transpilation::emit_where(out, where_);
         }
 
-        return sql;
+        // Add RETURNING if specified
+        if constexpr (!std::is_same_v<ReturningType, Nothing>) {
+            out += ' ';
+            transpilation::emit_returning<TableType>(out, returning_.columns);
+        }
+    }
+
+    /// Convert to SQL with numbered placeholders instead of inlined literals
+    auto to_parameterized_sql() const {
+        size_t next = 1;
+        auto where = transpilation::parameterize(where_, next);
+        auto returning = transpilation::parameterize(returning_, next);
+
+        const DeleteFrom<TableType, decltype(where), decltype(returning)> shape{
+            .where_ = where,
+            .returning_ = returning
+        };
+
+        auto values = params();
+        return transpilation::ParameterizedSql<decltype(values)>{shape.to_sql(), std::move(values)};
+    }
+
+    /// Values bound by to_parameterized_sql(), without building the SQL
+    auto params() const {
+        return std::tuple_cat(transpilation::bound_values(where_),
+                              transpilation::bound_values(returning_));
     }
 
     /// Pipe operator for WHERE clause
     template <class ConditionType>
-    friend auto operator|(const DeleteFrom& /*unused*/, const Where<ConditionType>& w) {
+    friend auto operator|(const DeleteFrom& d, const Where<ConditionType>& w) {
         static_assert(std::is_same_v<WhereType, Nothing>,
                      "Cannot call where() twice");
 
-        return DeleteFrom<TableType, ConditionType>{
-            .where_ = w.condition
+        return DeleteFrom<TableType, ConditionType, ReturningType>{
+            .where_ = w.condition,
+            .returning_ = d.returning_
+        };
+    }
+
+    /// Pipe operator for RETURNING clause
+    template <class... ColTypes>
+    friend auto operator|(const DeleteFrom& d, const Returning<ColTypes...>& r) {
+        static_assert(std::is_same_v<ReturningType, Nothing>,
+                     "Cannot call returning() twice");
+
+        return DeleteFrom<TableType, WhereType, Returning<ColTypes...>>{
+            .where_ = d.where_,
+            .returning_ = r
         };
     }
 
     WhereType where_;
+    ReturningType returning_{};
 };
 
 /// Create a DELETE FROM Table query
@@ -604,9 +860,11 @@ auto delete_from() {
 /// CREATE TABLE query builder
 template <class TableType>
 struct CreateTable {
-    /// Convert to SQL string
-    std::string to_sql() const {
-        return transpilation::create_table_sql<TableType>(if_not_exists_);
+    /// Convert to SQL string, built at compile time
+    std::string_view to_sql() const {
+        return if_not_exists_
+            ? transpilation::static_string<[] { return transpilation::create_table_sql<TableType>(true); }>.view()
+            : transpilation::static_string<[] { return transpilation::create_table_sql<TableType>(false); }>.view();
     }
 
     bool if_not_exists_ = false;
@@ -618,4 +876,29 @@ auto create_table(bool if_not_exists = false) {
     return CreateTable<TableType>{.if_not_exists_ = if_not_exists};
 }
 
+// ============================================================================
+// Query Routing
+// ============================================================================
+
+/// Whether a query builder writes to the database
+/// sqlite::Database sends writes to its writer connection and everything
+/// else (SELECT) to its reader pool
+template <class QueryBuilder>
+struct is_write_query : std::false_type {};
+
+template <class TableType, class ReturningType, bool MultiRow>
+struct is_write_query<Insert<TableType, ReturningType, MultiRow>> : std::true_type {};
+
+template <class TableType, class SetsTuple, class WhereType, class ReturningType>
+struct is_write_query<Update<TableType, SetsTuple, WhereType, ReturningType>> : std::true_type {};
+
+template <class TableType, class WhereType, class ReturningType>
+struct is_write_query<DeleteFrom<TableType, WhereType, ReturningType>> : std::true_type {};
+
+template <class TableType>
+struct is_write_query<CreateTable<TableType>> : std::true_type {};
+
+template <class QueryBuilder>
+inline constexpr bool is_write_query_v = is_write_query<std::remove_cvref_t<QueryBuilder>>::value;
+
 } // namespace sqlgen
@@ -209,6 +209,23 @@ inline auto having(const ConditionType& _cond) {
     return Having<std::remove_cvref_t<ConditionType>>{.condition = _cond};
 }
 
+// ============================================================================
+// RETURNING Clause
+// ============================================================================
+
+/// Wrapper for RETURNING clause columns (SQLite 3.35+)
+/// An empty column list returns every field of the table
+template <class... ColTypes>
+struct Returning {
+    std::tuple<ColTypes...> columns;
+};
+
+/// Create a RETURNING clause from columns, or for all fields when empty
+template <class... ColTypes>
+auto returning(const ColTypes&... cols) {
+    return Returning<std::remove_cvref_t<ColTypes>...>{.columns = std::make_tuple(cols...)};
+}
+
 // ============================================================================
 // Aggregate Functions
 // ============================================================================
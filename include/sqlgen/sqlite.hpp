@@ -1,7 +1,17 @@
 #pragma once
 
+#include "sqlite/Async.hpp"
+#include "sqlite/ColumnBatch.hpp"
 #include "sqlite/Connection.hpp"
+#include "sqlite/ConnectionOptions.hpp"
+#include "sqlite/ConnectionPool.hpp"
+#include "sqlite/Database.hpp"
+#include "sqlite/Executor.hpp"
+#include "sqlite/GroupCommitWriter.hpp"
 #include "sqlite/Iterator.hpp"
+#include "sqlite/RowView.hpp"
+#include "sqlite/Statement.hpp"
+#include "sqlite/TypedIterator.hpp"
 #include "core.hpp"
 
 namespace sqlgen::sqlite {
@@ -12,4 +22,10 @@ inline Result<Connection> connect(const std::string& filename = ":memory:") {
     return Connection::connect(filename);
 }
 
+/// Connect with options applied at open
+/// Usage: auto conn = sqlgen::sqlite::connect("app.db", ConnectionOptions::oltp());
+inline Result<Connection> connect(const std::string& filename, const ConnectionOptions& options) {
+    return Connection::connect(filename, options);
+}
+
 } // namespace sqlgen::sqlite
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <utility>
+#include "Executor.hpp"
+
+namespace sqlgen::sqlite {
+
+/// Awaitable that runs blocking work on an Executor in slices
+/// Each executor task calls step() once. step() returns the final result,
+/// or an empty optional to be queued again behind other work, so a long
+/// operation can't hold a worker for its whole run. The awaiting coroutine
+/// resumes on the worker that finishes the work, or on resume_on().
+template <class R>
+class AsyncOp {
+public:
+    using Step = std::move_only_function<std::optional<R>()>;
+
+    AsyncOp(Executor& executor, Step step) : executor_(&executor), step_(std::move(step)) {}
+
+    AsyncOp(AsyncOp&&) = default;
+    AsyncOp& operator=(AsyncOp&&) = default;
+
+    /// Resume the awaiting coroutine through executor (e.g. an event loop)
+    /// instead of on the worker thread
+    AsyncOp&& resume_on(Executor& executor) && {
+        resume_on_ = &executor;
+        return std::move(*this);
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> caller) {
+        caller_ = caller;
+        schedule();
+    }
+
+    R await_resume() { return std::move(*result_); }
+
+private:
+    void schedule() {
+        executor_->post([this] { run(); });
+    }
+
+    void run() {
+        auto result = step_();
+        if (!result) {
+            schedule();
+            return;
+        }
+
+        result_ = std::move(result);
+        if (resume_on_) {
+            resume_on_->post([caller = caller_] { caller.resume(); });
+        } else {
+            caller_.resume();
+        }
+    }
+
+    Executor* executor_;
+    Executor* resume_on_ = nullptr;
+    Step step_;
+    std::optional<R> result_;
+    std::coroutine_handle<> caller_;
+};
+
+/// Minimal lazy coroutine returning T
+/// Starts when awaited (continuing the awaiting coroutine when it
+/// finishes) or when start() is called on a top-level task.
+template <class T>
+class Task {
+public:
+    struct promise_type {
+        std::optional<T> value;
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept {
+            struct FinalAwaiter {
+                bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    auto next = h.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+                void await_resume() const noexcept {}
+            };
+            return FinalAwaiter{};
+        }
+
+        void return_value(T v) { value = std::move(v); }
+
+        // Library errors travel in Result; an escaping exception is a bug
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    /// Run a top-level task until its first suspension
+    void start() { handle_.resume(); }
+
+    /// Whether the coroutine has returned
+    bool done() const { return handle_.done(); }
+
+    /// The returned value; only valid once done()
+    T& result() { return *handle_.promise().value; }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+        handle_.promise().continuation = caller;
+        return handle_;
+    }
+
+    T await_resume() { return std::move(*handle_.promise().value); }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+} // namespace sqlgen::sqlite
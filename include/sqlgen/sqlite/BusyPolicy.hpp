@@ -0,0 +1,102 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+namespace sqlgen::sqlite {
+
+/// How a connection waits for locks held by other connections
+/// When SQLite finds the database busy, the connection sleeps
+/// initial_backoff, then multiplier times longer on each retry up to
+/// max_backoff. A random part (jitter) of every sleep is dropped so that
+/// contending connections don't retry in lockstep. Once max_wait has
+/// passed the wait is given up and the statement fails with SQLITE_BUSY.
+struct BusyPolicy {
+    std::chrono::milliseconds max_wait{5000};
+    std::chrono::microseconds initial_backoff{100};
+    std::chrono::microseconds max_backoff{50000};
+    double multiplier = 2.0;
+
+    /// Fraction of each sleep that is random: 0 sleeps the full backoff,
+    /// 1 anywhere between none and all of it
+    double jitter = 0.5;
+
+    /// Backoff before retry attempt (0-based), before jitter
+    std::chrono::nanoseconds backoff(int attempt) const;
+};
+
+/// Lock contention of one connection, as counted by its BusyHandler
+/// Compare wait_ns with the step time of Instrumentation to tell waiting
+/// for other connections apart from slow queries.
+struct ContentionStats {
+    uint64_t busy_events = 0;  // Times a lock was found held (one per wait, however many retries)
+    uint64_t retries = 0;      // Sleeps before trying again
+    uint64_t timeouts = 0;     // Waits given up after max_wait
+    uint64_t wait_ns = 0;      // Time spent sleeping on locks
+    uint64_t max_wait_ns = 0;  // Longest single wait so far
+};
+
+/// Applies a BusyPolicy to a connection as its sqlite3_busy_handler and
+/// counts the contention
+/// Waits run on the connection's thread; stats() may be read from others.
+class BusyHandler {
+public:
+    explicit BusyHandler(BusyPolicy policy);
+
+    /// Become db's busy handler, replacing any busy_timeout (until it is
+    /// unregistered, which must happen before this is destroyed)
+    void install(sqlite3* db) noexcept;
+
+    const BusyPolicy& policy() const noexcept { return policy_; }
+
+    void set_policy(const BusyPolicy& policy) noexcept { policy_ = policy; }
+
+    ContentionStats stats() const noexcept;
+
+    /// Call op, which returns an SQLite result code, until it stops failing
+    /// with SQLITE_BUSY or SQLITE_LOCKED or max_wait has passed since the
+    /// first call, backing off in between
+    /// For the failures SQLite doesn't give the busy handler (SQLITE_LOCKED,
+    /// or SQLITE_BUSY to avoid a deadlock); op must be safe to repeat.
+    template <class Op>
+    int retry(Op&& op) {
+        const auto start = std::chrono::steady_clock::now();
+        int rc = op();
+        for (int attempt = 0; is_busy(rc); ++attempt) {
+            if (attempt == 0) {
+                busy_events_.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (!wait(attempt, start)) {
+                break;
+            }
+            rc = op();
+        }
+        return rc;
+    }
+
+    static bool is_busy(int rc) noexcept {
+        return (rc & 0xff) == SQLITE_BUSY || (rc & 0xff) == SQLITE_LOCKED;
+    }
+
+private:
+    /// Sleep before retry attempt of a wait that began at start
+    /// Returns false (without sleeping) once max_wait is spent.
+    bool wait(int attempt, std::chrono::steady_clock::time_point start);
+
+    static int on_busy(void* self, int count) noexcept;
+
+    BusyPolicy policy_;
+    std::minstd_rand random_;
+    std::chrono::steady_clock::time_point wait_start_;  // Of the wait on_busy is in
+
+    std::atomic<uint64_t> busy_events_{0};
+    std::atomic<uint64_t> retries_{0};
+    std::atomic<uint64_t> timeouts_{0};
+    std::atomic<uint64_t> wait_ns_{0};
+    std::atomic<uint64_t> max_wait_ns_{0};
+};
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <glaze/reflection/to_tuple.hpp>
+#include <glaze/reflection/get_name.hpp>
+#include <glaze/util/string_literal.hpp>
+#include "../core.hpp"
+#include "../constraints/traits.hpp"
+#include "Decode.hpp"
+#include "Instrumentation.hpp"
+
+namespace sqlgen::sqlite {
+
+/// Variable-length column packed into one byte arena
+/// Value i spans bytes[offsets[i], offsets[i + 1]); used for text and blobs
+struct TextColumn {
+    std::vector<size_t> offsets{0};
+    std::string bytes;
+
+    size_t size() const noexcept { return offsets.size() - 1; }
+    bool empty() const noexcept { return size() == 0; }
+
+    std::string_view operator[](size_t i) const noexcept {
+        return std::string_view(bytes).substr(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    void push_back(std::string_view value) {
+        bytes.append(value);
+        offsets.push_back(bytes.size());
+    }
+
+    void clear() noexcept {
+        offsets.resize(1);
+        bytes.clear();
+    }
+
+    /// Keep only the first rows values
+    void truncate(size_t rows) {
+        offsets.resize(rows + 1);
+        bytes.resize(offsets.back());
+    }
+
+    void reserve(size_t rows) { offsets.reserve(rows + 1); }
+};
+
+/// Type of field I of T
+template <class T, size_t I>
+using field_type_t = std::remove_cvref_t<decltype(glz::get<I>(glz::to_tie(std::declval<T&>())))>;
+
+template <class T>
+struct remove_optional {
+    using type = T;
+};
+
+template <class T>
+struct remove_optional<std::optional<T>> {
+    using type = T;
+};
+
+/// Value stored for a field: optional and constraint wrappers stripped
+template <class Field>
+using column_value_t = constraints::underlying_type_t<typename remove_optional<Field>::type>;
+
+/// Contiguous storage for a column of values of type V
+/// Arithmetic types get a dense vector (bool as uint8_t), strings and blobs
+/// a TextColumn, and anything else (Date, JSON<T>, ...) a vector of decoded values
+template <class V>
+using column_storage_t = std::conditional_t<
+    std::is_same_v<V, bool>, std::vector<uint8_t>,
+    std::conditional_t<
+        std::is_arithmetic_v<V> || std::is_enum_v<V>, std::vector<V>,
+        std::conditional_t<
+            std::is_same_v<V, std::string> || std::is_same_v<V, std::vector<std::byte>>, TextColumn,
+            std::vector<V>>>>;
+
+/// A batch of query results laid out as one contiguous column per field of T
+template <class T>
+class ColumnBatch {
+public:
+    static constexpr size_t field_count = glz::detail::count_members<T>;
+
+private:
+    template <size_t... Is>
+    static auto make_columns(std::index_sequence<Is...>)
+        -> std::tuple<column_storage_t<column_value_t<field_type_t<T, Is>>>...>;
+
+    using Columns = decltype(make_columns(std::make_index_sequence<field_count>{}));
+
+public:
+    /// Index of the field called Name
+    template <glz::string_literal Name>
+    static constexpr size_t index_of = [] {
+        size_t index = field_count;
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((glz::member_nameof<Is, T> == Name.sv() ? (index = Is, true) : false) || ...);
+        }(std::make_index_sequence<field_count>{});
+        return index;
+    }();
+
+    /// Number of rows in the batch
+    size_t size() const noexcept { return rows_; }
+    bool empty() const noexcept { return rows_ == 0; }
+
+    /// Column of field I
+    template <size_t I>
+    auto& column() noexcept { return std::get<I>(columns_); }
+
+    template <size_t I>
+    const auto& column() const noexcept { return std::get<I>(columns_); }
+
+    /// Column of the field called Name
+    template <glz::string_literal Name>
+    const auto& column() const noexcept {
+        static_assert(index_of<Name> < field_count, "No such field");
+        return std::get<index_of<Name>>(columns_);
+    }
+
+    /// NULL mask of field I (1 = NULL); only populated for optional fields
+    template <size_t I>
+    const std::vector<uint8_t>& nulls() const noexcept { return nulls_[I]; }
+
+    /// Empty the batch, keeping all allocated capacity
+    void clear() {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (std::get<Is>(columns_).clear(), ...);
+        }(std::make_index_sequence<field_count>{});
+        for (auto& mask : nulls_) {
+            mask.clear();
+        }
+        rows_ = 0;
+    }
+
+    /// Reserve room for a number of rows in every column
+    void reserve(size_t rows) {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (std::get<Is>(columns_).reserve(rows), ...);
+        }(std::make_index_sequence<field_count>{});
+    }
+
+    /// Append the current row of stmt
+    /// Optional fields without a matching column are NULL; any other field
+    /// without one fails the row
+    /// If a field fails to decode, the row is dropped again and the batch
+    /// keeps the rows appended before it
+    Result<Nothing> append(sqlite3_stmt* stmt, const ColumnMap<T>& map) {
+        Result<Nothing> result = Nothing{};
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (void)((result = append_field<Is>(stmt, map[Is])).has_value() && ...);
+        }(std::make_index_sequence<field_count>{});
+        if (result) {
+            ++rows_;
+        } else {
+            drop_partial_row();
+        }
+        return result;
+    }
+
+private:
+    /// Cut every column and NULL mask back to rows_ entries, removing the
+    /// fields a failed append already added
+    void drop_partial_row() {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (truncate(std::get<Is>(columns_)), ...);
+        }(std::make_index_sequence<field_count>{});
+        for (auto& mask : nulls_) {
+            if (mask.size() > rows_) {
+                mask.resize(rows_);
+            }
+        }
+    }
+
+    void truncate(TextColumn& column) { column.truncate(rows_); }
+
+    template <class V>
+    void truncate(std::vector<V>& column) {
+        column.erase(column.begin() + static_cast<std::ptrdiff_t>(rows_), column.end());
+    }
+
+    template <size_t I>
+    Result<Nothing> append_field(sqlite3_stmt* stmt, int col) {
+        using Field = field_type_t<T, I>;
+        using Value = column_value_t<Field>;
+        auto& values = std::get<I>(columns_);
+
+        const bool is_null = col < 0 || sqlite3_column_type(stmt, col) == SQLITE_NULL;
+        if constexpr (transpilation::is_optional_v<Field>) {
+            nulls_[I].push_back(is_null ? 1 : 0);
+        } else if (col < 0) {
+            return missing_column_error<T, I>();
+        } else if (is_null) {
+            return decode_error(stmt, col, "NULL value for a non-optional field");
+        }
+
+        if (is_null) {
+            if constexpr (std::is_same_v<std::remove_cvref_t<decltype(values)>, TextColumn>) {
+                values.push_back({});
+            } else {
+                values.emplace_back();
+            }
+            return Nothing{};
+        }
+
+        if constexpr (std::is_same_v<Value, bool>) {
+            values.push_back(sqlite3_column_int64(stmt, col) != 0 ? 1 : 0);
+        } else if constexpr (std::is_integral_v<Value> || std::is_enum_v<Value>) {
+            auto decoded = decode_integer(stmt, col, values.emplace_back());
+            if (!decoded) {
+                values.pop_back();
+                return decoded;
+            }
+        } else if constexpr (std::is_floating_point_v<Value>) {
+            values.push_back(static_cast<Value>(sqlite3_column_double(stmt, col)));
+        } else if constexpr (std::is_same_v<Value, std::string>) {
+            values.push_back(column_text(stmt, col));
+        } else if constexpr (std::is_same_v<Value, std::vector<std::byte>>) {
+            const auto* data = static_cast<const char*>(sqlite3_column_blob(stmt, col));
+            values.push_back(std::string_view(data, static_cast<size_t>(sqlite3_column_bytes(stmt, col))));
+        } else {
+            auto decoded = decode_column(stmt, col, values.emplace_back());
+            if (!decoded) {
+                values.pop_back();
+                return decoded;
+            }
+        }
+        return Nothing{};
+    }
+
+    Columns columns_;
+    std::array<std::vector<uint8_t>, field_count> nulls_;
+    size_t rows_ = 0;
+};
+
+/// Reads query results into ColumnBatch<T> batches
+template <class T>
+class ColumnIterator {
+public:
+    /// Construct from a statement ready to be stepped
+    /// batch_size 0 reads everything into a single batch; the run is
+    /// recorded through probe
+    ColumnIterator(std::shared_ptr<sqlite3_stmt> stmt, size_t batch_size, QueryProbe probe = {})
+        : stmt_(std::move(stmt)),
+          columns_(make_column_map<T>(stmt_.get())),
+          batch_size_(batch_size),
+          probe_(std::move(probe)) {}
+
+    /// Dropping an iterator before the end resets its statement, so the
+    /// read snapshot (or write transaction) of the run is not held open
+    ~ColumnIterator() { close(); }
+
+    ColumnIterator(ColumnIterator&&) noexcept = default;
+
+    ColumnIterator& operator=(ColumnIterator&& other) noexcept {
+        if (this != &other) {
+            close();
+            stmt_ = std::move(other.stmt_);
+            columns_ = other.columns_;
+            batch_size_ = other.batch_size_;
+            end_ = other.end_;
+            probe_ = std::move(other.probe_);
+        }
+        return *this;
+    }
+
+    /// Check if next() has reached the end of results
+    bool end() const { return end_; }
+
+    /// Replace the contents of batch with the next rows, reusing its capacity
+    /// Returns false once there are no more rows. On a decode error the
+    /// batch keeps the rows read before the failing one; the next call
+    /// carries on after it.
+    Result<bool> next(ColumnBatch<T>& batch) {
+        batch.clear();
+        if (batch_size_ > 0) {
+            batch.reserve(batch_size_);
+        }
+
+        while (!end_ && (batch_size_ == 0 || batch.size() < batch_size_)) {
+            auto has_row = probe_.time(Phase::Step, [&] { return step_row(stmt_.get()); });
+            if (!has_row) {
+                end_ = true;
+                probe_.finish();
+                return error(has_row.error());
+            }
+            if (!*has_row) {
+                end_ = true;
+                probe_.finish();
+                break;
+            }
+
+            if (probe_) {
+                probe_.add_row();
+                probe_.add_bytes(row_bytes(stmt_.get()));
+            }
+
+            auto appended = probe_.time(Phase::Decode, [&] { return batch.append(stmt_.get(), columns_); });
+            if (!appended) {
+                return error(appended.error());
+            }
+        }
+        return !batch.empty();
+    }
+
+private:
+    /// Record the run and reset the statement if it was left mid-run
+    void close() noexcept {
+        probe_.finish();
+        if (stmt_ && !end_) {
+            sqlite3_reset(stmt_.get());
+        }
+    }
+
+    std::shared_ptr<sqlite3_stmt> stmt_;
+    ColumnMap<T> columns_;
+    size_t batch_size_;
+    bool end_ = false;
+    QueryProbe probe_;
+};
+
+} // namespace sqlgen::sqlite
@@ -1,10 +1,26 @@
 #pragma once
 
 #include <sqlite3.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
 #include <string>
+#include <type_traits>
+#include <vector>
 #include "../core.hpp"
+#include "../query_builders.hpp"
+#include "Async.hpp"
+#include "BusyPolicy.hpp"
+#include "ConnectionOptions.hpp"
+#include "Instrumentation.hpp"
+#include "Interrupt.hpp"
 #include "Iterator.hpp"
+#include "Statement.hpp"
+#include "StatementCache.hpp"
 
 namespace sqlgen::sqlite {
 
@@ -15,6 +31,14 @@ public:
     /// Use ":memory:" for in-memory database
     static Result<Connection> connect(const std::string& filename = ":memory:");
 
+    /// Create connection with explicit sqlite3_open_v2 flags
+    /// (e.g. SQLITE_OPEN_READONLY, SQLITE_OPEN_NOMUTEX)
+    static Result<Connection> connect(const std::string& filename, int flags);
+
+    /// Create connection and apply options (e.g. ConnectionOptions::oltp())
+    /// before returning it; if any setting fails, the connection is closed
+    static Result<Connection> connect(const std::string& filename, const ConnectionOptions& options);
+
     /// Destructor closes the connection
     ~Connection() = default;
 
@@ -33,6 +57,350 @@ public:
     /// Execute query and return iterator over results
     Result<Iterator> query(const std::string& sql);
 
+    /// Prepare a reusable statement from SQL text
+    /// Statements are cached per connection, keyed by the SQL text
+    Result<Statement> prepare(const std::string& sql);
+
+    /// Prepare a reusable statement from a query builder
+    /// Builders with parameterized emission (SELECT, UPDATE, DELETE) are
+    /// prepared from their placeholder SQL and their values are bound;
+    /// rebind new values of the same query type with bind_all(builder.params())
+    ///
+    /// Their statements are cached by builder type, so repeating a query
+    /// shape neither builds its SQL nor prepares it again. Builders whose
+    /// SQL is built at compile time (INSERT, CREATE TABLE) are cached by
+    /// the address of that text.
+    template <class QueryBuilder>
+    Result<Statement> prepare(const QueryBuilder& builder) {
+        if constexpr (std::is_same_v<decltype(builder.to_sql()), std::string_view>) {
+            const std::string_view sql = builder.to_sql();
+            StatementKey key{sql.data(), {}};
+            auto cached = acquire(key);
+            if (!cached) {
+                return error(cached.error());
+            }
+            if (*cached) {
+                return std::move(**cached);
+            }
+            return prepare_and_cache(std::move(key), emit([&] { return sql; }));
+        } else if constexpr (requires { builder.to_parameterized_sql(); }) {
+            StatementKey key{&statement_key<QueryBuilder>, {}};
+            auto cached = acquire(key);
+            if (!cached) {
+                return error(cached.error());
+            }
+
+            auto stmt = *cached
+                ? Result<Statement>(std::move(**cached))
+                : prepare_and_cache(std::move(key), emit([&] { return builder.to_parameterized_sql().sql; }));
+            if (!stmt) {
+                return stmt;
+            }
+
+            auto bound = stmt->bind_all(builder.params());
+            if (!bound) {
+                return error(bound.error());
+            }
+            return std::move(*stmt);
+        } else {
+            return prepare(emit([&] { return builder.to_sql(); }));
+        }
+    }
+
+    /// Run a query builder through the statement cache and iterate over
+    /// its results (or SQL text held in a std::string_view)
+    template <class QueryBuilder>
+        requires requires(const QueryBuilder& builder) { builder.to_sql(); } ||
+                 std::is_same_v<QueryBuilder, std::string_view>
+    Result<Iterator> query(const QueryBuilder& builder) {
+        auto stmt = prepare_query(builder);
+        if (!stmt) {
+            return error(stmt.error());
+        }
+        return stmt->query();
+    }
+
+    /// Run a query and iterate over its results decoded into T
+    /// Accepts a query builder (through the statement cache) or SQL text
+    template <class T, class QueryBuilder>
+    Result<TypedIterator<T>> query(const QueryBuilder& builder) {
+        auto stmt = prepare_query(builder);
+        if (!stmt) {
+            return error(stmt.error());
+        }
+        return stmt->template query<T>();
+    }
+
+    /// Run a query and read its results in batches of batch_size rows, laid
+    /// out as one contiguous column per field of T (0 = a single batch)
+    /// Accepts a query builder (through the statement cache) or SQL text
+    template <class T, class QueryBuilder>
+    Result<ColumnIterator<T>> fetch_columns(const QueryBuilder& builder, size_t batch_size) {
+        auto stmt = prepare_query(builder);
+        if (!stmt) {
+            return error(stmt.error());
+        }
+        return stmt->template fetch_columns<T>(batch_size);
+    }
+
+    /// Rows an async_query reads per executor task before yielding
+    static constexpr size_t default_yield_rows = 1024;
+
+    /// Run a query on executor and resume the awaiting coroutine with its
+    /// rows decoded into T: auto rows = co_await conn.async_query<T>(builder);
+    /// Rows are read yield_every at a time (0 = all at once), re-queueing in
+    /// between so a long scan shares its worker with other work. The
+    /// connection must not be used elsewhere until the operation completes.
+    template <class T, class QueryBuilder>
+    AsyncOp<Result<std::vector<T>>> async_query(QueryBuilder builder, Executor& executor = default_executor(),
+                                                size_t yield_every = default_yield_rows) {
+        struct Scan {
+            std::optional<TypedIterator<T>> iter;
+            std::vector<T> rows;
+        };
+
+        return AsyncOp<Result<std::vector<T>>>(executor,
+            [this, builder = std::move(builder), yield_every, scan = Scan{}]() mutable
+                -> std::optional<Result<std::vector<T>>> {
+                if (!scan.iter) {
+                    auto iter = query<T>(builder);
+                    if (!iter) {
+                        return error(iter.error());
+                    }
+                    scan.iter.emplace(std::move(*iter));
+                }
+
+                for (size_t n = 0; yield_every == 0 || n < yield_every; ++n) {
+                    T row{};
+                    auto more = scan.iter->next(row);
+                    if (!more) {
+                        return error(more.error());
+                    }
+                    if (!*more) {
+                        return std::move(scan.rows);
+                    }
+                    scan.rows.push_back(std::move(row));
+                }
+                return std::nullopt;  // Yield; continue in a later task
+            });
+    }
+
+    /// Execute a query builder or SQL text on executor and resume the
+    /// awaiting coroutine with the result
+    /// The connection must not be used elsewhere until the operation completes.
+    template <class QueryBuilder>
+    AsyncOp<Result<Nothing>> async_execute(QueryBuilder builder, Executor& executor = default_executor()) {
+        return AsyncOp<Result<Nothing>>(executor,
+            [this, builder = std::move(builder)]() -> std::optional<Result<Nothing>> {
+                if constexpr (std::is_convertible_v<const QueryBuilder&, std::string_view>) {
+                    return execute(std::string(std::string_view(builder)));
+                } else {
+                    return execute(builder);
+                }
+            });
+    }
+
+    /// Whether a transaction is open
+    bool in_transaction() const noexcept { return sqlite3_get_autocommit(conn_.get()) == 0; }
+
+    /// Raw connection handle
+    sqlite3* handle() const noexcept { return conn_.get(); }
+
+    /// Settings the connection is running with, read back from SQLite,
+    /// and the flags it was opened with
+    Result<ConnectionOptions> options() const;
+
+    /// Statement cache counters (hits, misses, evictions, size, capacity)
+    StatementCacheStats statement_cache_stats() const { return cache_.stats(); }
+
+    /// Change the statement cache capacity; 0 disables caching
+    void set_statement_cache_capacity(size_t capacity) { cache_.set_capacity(capacity); }
+
+    /// Finalize all cached statements
+    void clear_statement_cache() { cache_.clear(); }
+
+    /// Start recording per-query-shape phase timings, row and byte counts
+    /// Returns the recorder, which can be snapshotted from other threads.
+    /// Until this is called, the only cost is a null check per call.
+    std::shared_ptr<Instrumentation> enable_instrumentation() {
+        if (!instrumentation_) {
+            instrumentation_ = std::make_shared<Instrumentation>();
+        }
+        return instrumentation_;
+    }
+
+    /// Stop recording; iterators already running finish their run
+    void disable_instrumentation() { instrumentation_.reset(); }
+
+    /// The active recorder, or nullptr when instrumentation is off
+    const std::shared_ptr<Instrumentation>& instrumentation() const { return instrumentation_; }
+
+    /// Log every query run taking at least threshold (emit + prepare +
+    /// step + decode) with its parameter types, phases and EXPLAIN QUERY
+    /// PLAN, keeping the latest capacity runs
+    /// Turns instrumentation on, which does the timing.
+    std::shared_ptr<SlowQueryLog> enable_slow_query_log(std::chrono::nanoseconds threshold,
+                                                        size_t capacity = SlowQueryLog::default_capacity) {
+        const auto& log = enable_instrumentation()->slow_query_log();
+        log->configure(threshold, capacity);
+        return log;
+    }
+
+    /// Stop logging slow queries; instrumentation stays on
+    void disable_slow_query_log() {
+        if (instrumentation_) {
+            instrumentation_->slow_query_log()->disable();
+        }
+    }
+
+    /// Interrupt statements of this connection still running at deadline
+    /// They fail with an error is_deadline_exceeded() recognizes (an
+    /// iterator's next() reports it instead of the end of rows). Holds for
+    /// everything run on the connection until clear_deadline().
+    void set_deadline(std::chrono::steady_clock::time_point deadline) {
+        if (!deadline_) {
+            deadline_ = std::make_shared<QueryDeadline>();
+            deadline_->install(conn_.get());
+        }
+        deadline_->set(deadline);
+    }
+
+    /// Deadline timeout from now
+    void set_timeout(std::chrono::nanoseconds timeout) {
+        set_deadline(std::chrono::steady_clock::now() + timeout);
+    }
+
+    void clear_deadline() noexcept {
+        if (deadline_) {
+            deadline_->clear();
+        }
+    }
+
+    /// The current deadline, if any
+    std::optional<std::chrono::steady_clock::time_point> deadline() const {
+        return deadline_ ? deadline_->get() : std::nullopt;
+    }
+
+    /// Deadline timeout from now until the returned guard goes out of
+    /// scope, when the previous deadline (or none) is put back
+    ///     auto guard = conn.scoped_timeout(50ms);
+    ///     auto rows = conn.query<T>(builder)->collect();
+    [[nodiscard]] ScopedDeadline scoped_timeout(std::chrono::nanoseconds timeout) {
+        auto previous = deadline();
+        set_timeout(timeout);
+        return ScopedDeadline(deadline_, previous);
+    }
+
+    /// Handle another thread can use to cancel what this connection runs
+    CancelHandle cancel_handle() const { return CancelHandle(conn_); }
+
+    /// Wait for locks held by other connections as policy says, counting
+    /// the contention; replaces any busy_timeout
+    /// Statements wait in SQLite's busy handler; prepare and commit are
+    /// also retried when they still fail with SQLITE_BUSY or SQLITE_LOCKED.
+    void set_busy_policy(const BusyPolicy& policy);
+
+    /// Fail on locked databases right away again (and forget the counters)
+    void clear_busy_policy();
+
+    std::optional<BusyPolicy> busy_policy() const {
+        return busy_ ? std::optional<BusyPolicy>(busy_->policy()) : std::nullopt;
+    }
+
+    /// Retries and time spent waiting for locks under the busy policy
+    ContentionStats contention_stats() const { return busy_ ? busy_->stats() : ContentionStats{}; }
+
+    /// Rows per transaction used by insert_all
+    static constexpr size_t default_insert_chunk_size = 10000;
+
+    /// Insert rows with one prepared statement, binding each row's fields
+    /// and committing every chunk_size rows (0 = one transaction for all)
+    /// If a transaction is already open, the rows become part of it and no
+    /// chunk commits are made. On error the current chunk is rolled back;
+    /// chunks committed before it are kept.
+    template <class T>
+    Result<Nothing> insert_all(std::span<const T> rows, size_t chunk_size = default_insert_chunk_size) {
+        if (rows.empty()) {
+            return Nothing{};
+        }
+
+        auto stmt = prepare(sqlgen::insert<T>());
+        if (!stmt) {
+            return error(stmt.error());
+        }
+
+        return insert_chunks(rows, chunk_size, [&](std::span<const T> chunk) {
+            return insert_batches(*stmt, chunk, 1);
+        });
+    }
+
+    /// Insert rows from any contiguous range (std::vector, std::array, ...)
+    template <std::ranges::contiguous_range Rows>
+    Result<Nothing> insert_all(const Rows& rows, size_t chunk_size = default_insert_chunk_size) {
+        using T = std::ranges::range_value_t<Rows>;
+        return insert_all(std::span<const T>(std::ranges::data(rows), std::ranges::size(rows)), chunk_size);
+    }
+
+    /// Insert rows with multi-row VALUES statements of max_insert_rows<T>()
+    /// rows each (capped at chunk_size); leftover rows go through the
+    /// single-row statement. Transactions and chunking as in insert_all.
+    /// Fewer, larger statements pay off for narrow tables; compare both
+    /// strategies with benchmarks/bench_insert for a given table width.
+    template <class T>
+    Result<Nothing> insert_batched(std::span<const T> rows, size_t chunk_size = default_insert_chunk_size) {
+        if (rows.empty()) {
+            return Nothing{};
+        }
+
+        // At least 1: max_insert_rows is, and a chunk_size of 0 doesn't cap it
+        size_t batch_rows = max_insert_rows<T>();
+        if (chunk_size > 0 && chunk_size < batch_rows) {
+            batch_rows = chunk_size;
+        }
+
+        auto single = prepare(sqlgen::insert<T>());
+        if (!single) {
+            return error(single.error());
+        }
+
+        // One cached statement per batch size
+        std::optional<Statement> batch;
+        if (batch_rows > 1 && rows.size() >= batch_rows) {
+            auto prepared = prepare(sqlgen::insert<T>().rows(batch_rows));
+            if (!prepared) {
+                return error(prepared.error());
+            }
+            batch = std::move(*prepared);
+        }
+
+        return insert_chunks(rows, chunk_size, [&](std::span<const T> chunk) {
+            size_t full = batch ? chunk.size() / batch_rows * batch_rows : 0;
+            if (full > 0) {
+                auto inserted = insert_batches(*batch, chunk.first(full), batch_rows);
+                if (!inserted) {
+                    return inserted;
+                }
+            }
+            return insert_batches(*single, chunk.subspan(full), 1);
+        });
+    }
+
+    /// Insert rows from any contiguous range with multi-row VALUES statements
+    template <std::ranges::contiguous_range Rows>
+    Result<Nothing> insert_batched(const Rows& rows, size_t chunk_size = default_insert_chunk_size) {
+        using T = std::ranges::range_value_t<Rows>;
+        return insert_batched(std::span<const T>(std::ranges::data(rows), std::ranges::size(rows)), chunk_size);
+    }
+
+    /// Most rows of T a single INSERT can carry on this connection
+    /// (SQLITE_LIMIT_VARIABLE_NUMBER divided by the field count of T)
+    template <class T>
+    size_t max_insert_rows() const {
+        auto max_variables = sqlite3_limit(conn_.get(), SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+        size_t rows = static_cast<size_t>(max_variables) / Insert<T>::field_count;
+        return rows > 0 ? rows : 1;
+    }
+
     /// Begin a transaction
     Result<Nothing> begin_transaction();
 
@@ -45,20 +413,135 @@ public:
     /// Execute a query builder and return SQL
     template <class QueryBuilder>
     std::string to_sql(const QueryBuilder& builder) {
-        return builder.to_sql();
+        return std::string(builder.to_sql());
     }
 
-    /// Execute a query builder
+    /// Execute a query builder (or SQL text held in a std::string_view)
+    /// Parameterized builders run through prepare(builder), so their values
+    /// are bound rather than inlined and every execution of a builder type
+    /// reuses one cached statement and one instrumentation shape
     template <class QueryBuilder>
     Result<Nothing> execute(const QueryBuilder& builder) {
-        return execute(builder.to_sql());
+        if constexpr (std::is_convertible_v<const QueryBuilder&, std::string_view>) {
+            return execute(std::string(std::string_view(builder)));
+        } else if constexpr (requires { builder.to_parameterized_sql(); }) {
+            auto stmt = prepare(builder);
+            if (!stmt) {
+                return error(stmt.error());
+            }
+            return stmt->execute();
+        } else {
+            return execute(emit([&] { return builder.to_sql(); }));
+        }
     }
 
 private:
     /// Private constructor - use connect() factory
-    explicit Connection(std::shared_ptr<sqlite3> conn) : conn_(std::move(conn)) {}
+    Connection(std::shared_ptr<sqlite3> conn, int flags) : conn_(std::move(conn)), flags_(flags) {}
+
+    /// Build SQL text with to_sql(), timed as the Emit phase of its shape
+    /// when instrumentation is on
+    template <class ToSql>
+    std::string emit(ToSql&& to_sql) {
+        if (!instrumentation_) {
+            return std::string(to_sql());
+        }
+        const uint64_t start = now_ns();
+        std::string sql(to_sql());
+        setup_.emit_ns = now_ns() - start;
+        instrumentation_->stats(sql)->phase(Phase::Emit).record(setup_.emit_ns);
+        return sql;
+    }
+
+    /// Stats of the shape stmt belongs to, or nullptr when instrumentation is off
+    std::shared_ptr<QueryStats> stats_for(sqlite3_stmt* stmt) const;
+
+    /// Prepare sql, timed as the Prepare phase when instrumentation is on
+    Result<std::shared_ptr<sqlite3_stmt>> prepare_statement(const char* sql, unsigned int flags);
+
+    /// Run insert_chunk over rows in transactions of chunk_size rows
+    template <class T, class InsertChunk>
+    Result<Nothing> insert_chunks(std::span<const T> rows, size_t chunk_size, InsertChunk&& insert_chunk) {
+        const bool own_transaction = !in_transaction();
+        if (!own_transaction || chunk_size == 0) {
+            chunk_size = rows.size();
+        }
+
+        for (size_t offset = 0; offset < rows.size(); offset += chunk_size) {
+            auto chunk = rows.subspan(offset, std::min(chunk_size, rows.size() - offset));
+
+            if (own_transaction) {
+                auto begun = begin_transaction();
+                if (!begun) {
+                    return begun;
+                }
+            }
+
+            auto inserted = insert_chunk(chunk);
+            if (!inserted) {
+                if (own_transaction) {
+                    rollback();
+                }
+                return inserted;
+            }
+
+            if (own_transaction) {
+                auto committed = commit();
+                if (!committed) {
+                    return committed;
+                }
+            }
+        }
+        return Nothing{};
+    }
+
+    /// Execute stmt once per rows_per_statement rows, binding row i of each
+    /// group after the parameters of the rows before it
+    template <class T>
+    static Result<Nothing> insert_batches(Statement& stmt, std::span<const T> rows, size_t rows_per_statement) {
+        constexpr int field_count = static_cast<int>(Insert<T>::field_count);
+
+        for (size_t offset = 0; offset + rows_per_statement <= rows.size(); offset += rows_per_statement) {
+            Result<Nothing> result = Nothing{};
+            for (size_t i = 0; i < rows_per_statement && result; ++i) {
+                result = stmt.bind_row(rows[offset + i], static_cast<int>(i) * field_count + 1);
+            }
+            if (result) {
+                result = stmt.execute();
+            }
+            if (!result) {
+                return result;
+            }
+        }
+        return Nothing{};
+    }
+
+    /// Prepare either SQL text or a query builder
+    template <class QueryBuilder>
+    Result<Statement> prepare_query(const QueryBuilder& builder) {
+        if constexpr (std::is_convertible_v<const QueryBuilder&, std::string_view>) {
+            return prepare(std::string(std::string_view(builder)));
+        } else {
+            return prepare(builder);
+        }
+    }
+
+    /// Look up a cached statement, reset and cleared for rebinding
+    /// Returns an empty optional on a miss. A statement still in use
+    /// elsewhere (a live Statement or Iterator) is re-prepared from its
+    /// SQL text instead of being shared.
+    Result<std::optional<Statement>> acquire(const StatementKey& key);
+
+    /// Prepare a long-lived statement and add it to the cache
+    Result<Statement> prepare_and_cache(StatementKey key, const std::string& sql);
 
+    std::shared_ptr<QueryDeadline> deadline_;  // conn_'s progress handler, unregistered by its deleter
+    std::shared_ptr<BusyHandler> busy_;        // conn_'s busy handler, likewise
     std::shared_ptr<sqlite3> conn_;
+    int flags_;
+    std::shared_ptr<Instrumentation> instrumentation_;
+    RunPhases setup_;  // Emit and prepare time owed by the next statement handed out
+    StatementCache cache_;  // Destroyed before conn_
 };
 
 } // namespace sqlgen::sqlite
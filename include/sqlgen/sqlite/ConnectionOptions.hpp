@@ -0,0 +1,120 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include "../core.hpp"
+#include "BusyPolicy.hpp"
+
+namespace sqlgen::sqlite {
+
+/// PRAGMA journal_mode
+enum class JournalMode { Delete, Truncate, Persist, Memory, Wal, Off };
+
+/// PRAGMA synchronous
+enum class Synchronous { Off, Normal, Full, Extra };
+
+/// PRAGMA temp_store
+enum class TempStore { Default, File, Memory };
+
+/// Lower-case PRAGMA spelling ("wal", "normal", "memory", ...)
+std::string_view to_string(JournalMode mode);
+std::string_view to_string(Synchronous mode);
+std::string_view to_string(TempStore store);
+
+/// Settings applied to a connection when it is opened
+/// Unset fields keep SQLite's default (or, for persistent settings such as
+/// journal_mode=WAL and page_size, whatever the database file already has).
+/// Connection::connect applies them all before returning the connection;
+/// if any of them fails the connection is closed and the error returned.
+/// That is not atomic: see apply_options.
+struct ConnectionOptions {
+    /// sqlite3_open_v2 flags
+    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+
+    std::optional<JournalMode> journal_mode;
+    std::optional<Synchronous> synchronous;
+
+    /// Page cache size: pages if positive, KiB if negative (as in
+    /// PRAGMA cache_size)
+    std::optional<int64_t> cache_size;
+
+    /// Bytes of the file to memory-map (0 = no mmap)
+    std::optional<int64_t> mmap_size;
+
+    std::optional<TempStore> temp_store;
+
+    /// How long to retry on SQLITE_BUSY before failing
+    std::optional<std::chrono::milliseconds> busy_timeout;
+
+    /// Back off exponentially with jitter on SQLITE_BUSY / SQLITE_LOCKED
+    /// and count the contention (Connection::contention_stats()); replaces
+    /// busy_timeout when both are set. Installed before the other settings,
+    /// so they wait for locks too.
+    std::optional<BusyPolicy> busy_policy;
+
+    /// Auxiliary threads a statement may use for sorting (PRAGMA threads)
+    std::optional<int> threads;
+
+    /// Bytes per page; only takes effect on a new database (or after
+    /// VACUUM outside WAL mode), so it is applied first
+    std::optional<int> page_size;
+
+    /// Loading a lot of data into a file that can be rebuilt from scratch
+    /// No rollback journal and no fsync: a crash mid-load can corrupt the
+    /// database. Large page cache and temp tables in memory.
+    static ConnectionOptions bulk_load() {
+        ConnectionOptions options;
+        options.journal_mode = JournalMode::Off;
+        options.synchronous = Synchronous::Off;
+        options.cache_size = -256 * 1024;  // 256 MiB
+        options.temp_store = TempStore::Memory;
+        return options;
+    }
+
+    /// Many short read/write transactions from concurrent connections
+    /// WAL with synchronous=NORMAL (durable except for the last
+    /// transactions on power loss), 64 MiB cache, 256 MiB mmap and a busy
+    /// timeout so writers wait for each other instead of failing.
+    static ConnectionOptions oltp() {
+        ConnectionOptions options;
+        options.journal_mode = JournalMode::Wal;
+        options.synchronous = Synchronous::Normal;
+        options.cache_size = -64 * 1024;  // 64 MiB
+        options.mmap_size = int64_t{256} << 20;
+        options.temp_store = TempStore::Memory;
+        options.busy_timeout = std::chrono::milliseconds(5000);
+        return options;
+    }
+
+    /// Large scans and aggregations over a database nobody writes through
+    /// this connection; opened read-only with a 256 MiB cache, 1 GiB mmap
+    /// and helper threads for sorts
+    static ConnectionOptions read_only_analytics() {
+        ConnectionOptions options;
+        options.flags = SQLITE_OPEN_READONLY;
+        options.cache_size = -256 * 1024;  // 256 MiB
+        options.mmap_size = int64_t{1} << 30;
+        options.temp_store = TempStore::Memory;
+        options.busy_timeout = std::chrono::milliseconds(5000);
+        options.threads = 4;
+        return options;
+    }
+};
+
+/// Apply options (all but flags and busy_policy) to an open connection
+/// Values that can be checked up front (page_size, busy_timeout, threads,
+/// a journal_mode an in-memory database can't use) are, before anything
+/// is applied. The PRAGMAs then run one by one and stop at the first that
+/// fails or that SQLite does not accept. Those already run are not undone,
+/// and page_size and journal_mode=WAL persist in the database file.
+Result<Nothing> apply_options(sqlite3* db, const ConnectionOptions& options);
+
+/// Read the settings a connection is running with
+/// Every field but busy_policy is filled in; flags is left at its default,
+/// since SQLite does not report the flags a connection was opened with.
+Result<ConnectionOptions> read_options(sqlite3* db);
+
+} // namespace sqlgen::sqlite
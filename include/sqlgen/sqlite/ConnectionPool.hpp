@@ -0,0 +1,104 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "../core.hpp"
+#include "Connection.hpp"
+
+namespace sqlgen::sqlite {
+
+/// Pool usage counters
+struct PoolStats {
+    size_t size = 0;              // Connections in the pool
+    size_t in_use = 0;            // Currently leased
+    size_t peak_in_use = 0;       // Highest number leased at once
+    uint64_t acquisitions = 0;    // Leases handed out
+    uint64_t waits = 0;           // Acquisitions that found no free connection
+    uint64_t total_wait_ns = 0;   // Time spent waiting for a connection
+    uint64_t max_wait_ns = 0;     // Longest single wait
+    uint64_t busy_ns = 0;         // Sum of completed lease durations
+    uint64_t uptime_ns = 0;       // Time since the pool was opened
+
+    /// Fraction of total connection time spent leased (0..1)
+    double utilization() const {
+        if (size == 0 || uptime_ns == 0) return 0.0;
+        return static_cast<double>(busy_ns) / (static_cast<double>(size) * static_cast<double>(uptime_ns));
+    }
+
+    /// Mean wait of the acquisitions that had to wait
+    double mean_wait_ns() const {
+        return waits == 0 ? 0.0 : static_cast<double>(total_wait_ns) / static_cast<double>(waits);
+    }
+};
+
+/// Fixed-size pool of connections to one database, shared across threads
+/// Connections are opened with SQLITE_OPEN_NOMUTEX: SQLite skips its
+/// per-connection mutex because a lease guarantees exclusive use. Free
+/// connections are tracked in an atomic bitmap, so acquire/release don't
+/// take a lock. Each connection keeps its own statement cache.
+class ConnectionPool {
+public:
+    class Lease;
+
+    /// Open size connections to filename
+    /// Use a file (not ":memory:", which would give every connection its
+    /// own database)
+    static Result<ConnectionPool> open(const std::string& filename, size_t size,
+                                       int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+
+    /// Open size connections to filename, each configured with options
+    static Result<ConnectionPool> open(const std::string& filename, size_t size, const ConnectionOptions& options);
+
+    /// Lease a connection, blocking until one is free
+    Lease acquire();
+
+    /// Lease a connection if one is free right now
+    std::optional<Lease> try_acquire();
+
+    /// Number of connections
+    size_t size() const;
+
+    /// Usage counters
+    PoolStats stats() const;
+
+private:
+    struct State;
+
+    explicit ConnectionPool(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<State> state_;
+};
+
+/// Exclusive use of one pooled connection; returned to the pool on destruction
+class ConnectionPool::Lease {
+public:
+    Lease(Lease&& other) noexcept;
+    Lease& operator=(Lease&& other) noexcept;
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    ~Lease();
+
+    Connection& operator*() const noexcept { return *conn_; }
+    Connection* operator->() const noexcept { return conn_; }
+    Connection& get() const noexcept { return *conn_; }
+
+private:
+    friend class ConnectionPool;
+
+    Lease(std::shared_ptr<State> state, size_t index, Connection* conn);
+    void release() noexcept;
+
+    std::shared_ptr<State> state_;  // Keeps the pool alive while leased
+    size_t index_ = 0;
+    Connection* conn_ = nullptr;
+    std::chrono::steady_clock::time_point leased_at_;
+};
+
+} // namespace sqlgen::sqlite
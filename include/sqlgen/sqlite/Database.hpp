@@ -0,0 +1,180 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../core.hpp"
+#include "../query_builders.hpp"
+#include "Connection.hpp"
+#include "ConnectionPool.hpp"
+
+namespace sqlgen::sqlite {
+
+/// Multi-threaded front-end to one database file in WAL mode
+/// One writer connection takes all writes, one at a time; a pool of
+/// read-only connections serves reads. In WAL mode readers don't block the
+/// writer or each other, so reads scale with threads while writes queue on
+/// the writer instead of failing with SQLITE_BUSY.
+///
+/// The writer's mutex is the single-writer queue: a thread that wants to
+/// write blocks on it until the writer is free. There is no separate queue
+/// or writer thread, and std::mutex does not promise FIFO order. Batching
+/// writes from many threads into shared transactions is GroupCommitWriter's
+/// job.
+///
+/// Query builders are routed at compile time by is_write_query_v: INSERT,
+/// UPDATE, DELETE and CREATE TABLE go to the writer, SELECT to a reader.
+class Database {
+public:
+    class WriteLease;
+
+    /// Open filename in WAL mode with a writer and readers reader connections
+    /// (0 = one per hardware thread)
+    /// Needs a database file; ":memory:" can't use WAL
+    static Result<Database> open(const std::string& filename, size_t readers = 0);
+
+    /// Open filename with options applied to the writer and every reader
+    /// The writer is always opened read-write in WAL mode and the readers
+    /// read-only, whatever options.flags and journal_mode say. busy_timeout
+    /// and busy_policy cover the readers too, since a WAL reader can still
+    /// meet SQLITE_BUSY (e.g. while another connection recovers the WAL).
+    /// page_size is only applied by the writer.
+    static Result<Database> open(const std::string& filename, size_t readers, ConnectionOptions options);
+
+    /// Exclusive use of the writer connection, blocking while another
+    /// thread holds it
+    WriteLease writer();
+
+    /// Lease a reader connection, blocking until one is free
+    ConnectionPool::Lease reader() { return readers_.acquire(); }
+
+    /// Execute SQL text on the writer
+    Result<Nothing> execute(const std::string& sql);
+
+    /// Execute a query builder on the connection its type routes to
+    template <class QueryBuilder>
+    Result<Nothing> execute(const QueryBuilder& builder);
+
+    /// Run a query and collect its results decoded into T
+    /// Builders are routed by type; SQL text runs on a reader
+    template <class T, class QueryBuilder>
+    Result<std::vector<T>> query(const QueryBuilder& builder);
+
+    /// Insert rows on the writer (see Connection::insert_all)
+    template <class Rows>
+    Result<Nothing> insert_all(const Rows& rows, size_t chunk_size = Connection::default_insert_chunk_size);
+
+    /// Number of reader connections
+    size_t reader_count() const { return readers_.size(); }
+
+    /// Reader pool usage counters
+    PoolStats reader_stats() const { return readers_.stats(); }
+
+private:
+    struct Writer {
+        explicit Writer(Connection conn) : conn(std::move(conn)) {}
+
+        std::mutex mutex;
+        Connection conn;
+    };
+
+    Database(std::unique_ptr<Writer> writer, ConnectionPool readers)
+        : writer_(std::move(writer)), readers_(std::move(readers)) {}
+
+    /// Run f(Connection&) on the writer or a reader, by query type
+    template <class QueryBuilder, class F>
+    auto route(F&& f);
+
+    std::unique_ptr<Writer> writer_;
+    ConnectionPool readers_;
+};
+
+/// Exclusive use of a Database's writer connection
+/// Releasing it rolls back a transaction left open, like a pool lease
+class Database::WriteLease {
+public:
+    WriteLease(WriteLease&&) noexcept = default;
+    WriteLease& operator=(WriteLease&& other) noexcept {
+        if (this != &other) {
+            release();
+            lock_ = std::move(other.lock_);
+            conn_ = other.conn_;
+            other.conn_ = nullptr;
+        }
+        return *this;
+    }
+    WriteLease(const WriteLease&) = delete;
+    WriteLease& operator=(const WriteLease&) = delete;
+    ~WriteLease() { release(); }
+
+    Connection& operator*() const noexcept { return *conn_; }
+    Connection* operator->() const noexcept { return conn_; }
+    Connection& get() const noexcept { return *conn_; }
+
+private:
+    friend class Database;
+
+    explicit WriteLease(Writer& writer) : lock_(writer.mutex), conn_(&writer.conn) {}
+
+    void release() noexcept {
+        // The C API, as in ConnectionPool::Lease: Connection::rollback() can throw
+        if (lock_.owns_lock() && conn_->in_transaction()) {
+            sqlite3_exec(conn_->handle(), "ROLLBACK", nullptr, nullptr, nullptr);
+        }
+        if (lock_.owns_lock()) {
+            lock_.unlock();
+        }
+    }
+
+    std::unique_lock<std::mutex> lock_;
+    Connection* conn_ = nullptr;
+};
+
+inline Database::WriteLease Database::writer() {
+    return WriteLease(*writer_);
+}
+
+template <class QueryBuilder, class F>
+auto Database::route(F&& f) {
+    if constexpr (is_write_query_v<QueryBuilder>) {
+        auto lease = writer();
+        return f(*lease);
+    } else {
+        auto lease = reader();
+        return f(*lease);
+    }
+}
+
+template <class QueryBuilder>
+Result<Nothing> Database::execute(const QueryBuilder& builder) {
+    if constexpr (std::is_convertible_v<const QueryBuilder&, std::string_view>) {
+        return execute(std::string(std::string_view(builder)));
+    } else {
+        return route<QueryBuilder>([&](Connection& conn) { return conn.execute(builder); });
+    }
+}
+
+template <class T, class QueryBuilder>
+Result<std::vector<T>> Database::query(const QueryBuilder& builder) {
+    // Collected while the lease is held: results must not be stepped after
+    // the connection goes back to another thread
+    return route<QueryBuilder>([&](Connection& conn) -> Result<std::vector<T>> {
+        auto iter = conn.query<T>(builder);
+        if (!iter) {
+            return error(iter.error());
+        }
+        return iter->collect();
+    });
+}
+
+template <class Rows>
+Result<Nothing> Database::insert_all(const Rows& rows, size_t chunk_size) {
+    auto lease = writer();
+    return lease->insert_all(rows, chunk_size);
+}
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <glaze/reflection/to_tuple.hpp>
+#include <glaze/reflection/get_name.hpp>
+#include "../core.hpp"
+#include "../constraints/traits.hpp"
+#include "Interrupt.hpp"
+
+namespace sqlgen::sqlite {
+
+/// Row types decoded field-by-field through glaze reflection
+/// Anything else (int64_t, std::string, std::optional<double>, ...) is
+/// decoded from the first result column
+template <class T>
+inline constexpr bool is_reflected_row_v = std::is_class_v<T> && std::is_aggregate_v<T>;
+
+/// Result column index of each field of a reflected row type (-1 if the
+/// result has no column with that field's name; only optional fields may
+/// be left without one)
+template <class T>
+struct column_map_type {
+    using type = std::array<int, 0>;
+};
+
+template <class T>
+    requires is_reflected_row_v<T>
+struct column_map_type<T> {
+    using type = std::array<int, glz::detail::count_members<T>>;
+};
+
+template <class T>
+using ColumnMap = typename column_map_type<T>::type;
+
+/// Text of a column, pointing into SQLite's buffer (valid until the next step)
+inline std::string_view column_text(sqlite3_stmt* stmt, int col) {
+    const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+    if (!text) {
+        return {};
+    }
+    return {text, static_cast<size_t>(sqlite3_column_bytes(stmt, col))};
+}
+
+/// Error for a column that could not be decoded
+inline auto decode_error(sqlite3_stmt* stmt, int col, std::string_view reason) {
+    return error("Failed to decode column '" + std::string(sqlite3_column_name(stmt, col)) +
+                 "': " + std::string(reason));
+}
+
+/// Decode an integer column into an integer or enum, failing if the stored
+/// value does not fit
+template <class Type>
+Result<Nothing> decode_integer(sqlite3_stmt* stmt, int col, Type& value) {
+    using Integer = typename std::conditional_t<std::is_enum_v<Type>, std::underlying_type<Type>,
+                                                std::type_identity<Type>>::type;
+    const int64_t stored = sqlite3_column_int64(stmt, col);
+    // Statement::bind stores 64-bit unsigned values as their int64_t bit
+    // pattern, so those convert back unchecked
+    if constexpr (std::is_signed_v<Integer> || sizeof(Integer) < sizeof(int64_t)) {
+        if (!std::in_range<Integer>(stored)) {
+            return decode_error(stmt, col, std::to_string(stored) + " is out of range for the field type");
+        }
+    }
+    value = static_cast<Type>(stored);
+    return Nothing{};
+}
+
+/// Decode one column of the current row into value
+/// The inverse of Statement::bind: integers, bool, floating point, strings,
+/// blobs, std::optional (NULL -> nullopt), the constraint wrappers and the
+/// domain types (validated on the way in)
+template <class T>
+Result<Nothing> decode_column(sqlite3_stmt* stmt, int col, T& value) {
+    using Type = std::remove_cvref_t<T>;
+
+    if constexpr (transpilation::is_optional_v<Type>) {
+        if (sqlite3_column_type(stmt, col) == SQLITE_NULL) {
+            value.reset();
+            return Nothing{};
+        }
+        if (!value.has_value()) {
+            value.emplace();
+        }
+        return decode_column(stmt, col, *value);
+    } else {
+        if (sqlite3_column_type(stmt, col) == SQLITE_NULL) {
+            return decode_error(stmt, col, "NULL value for a non-optional field");
+        }
+
+        if constexpr (std::is_same_v<Type, bool>) {
+            value = sqlite3_column_int64(stmt, col) != 0;
+        } else if constexpr (std::is_integral_v<Type> || std::is_enum_v<Type>) {
+            return decode_integer(stmt, col, value);
+        } else if constexpr (std::is_floating_point_v<Type>) {
+            value = static_cast<Type>(sqlite3_column_double(stmt, col));
+        } else if constexpr (std::is_same_v<Type, std::string>) {
+            auto text = column_text(stmt, col);
+            value.assign(text.data(), text.size());
+        } else if constexpr (std::is_same_v<Type, std::vector<std::byte>>) {
+            const auto* data = static_cast<const std::byte*>(sqlite3_column_blob(stmt, col));
+            value.assign(data, data + sqlite3_column_bytes(stmt, col));
+        } else if constexpr (constraints::is_varchar_v<Type> || constraints::is_char_v<Type>) {
+            // Assigned through the wrapper so the length check runs
+            try {
+                value = column_text(stmt, col);
+            } catch (const std::exception& e) {
+                return decode_error(stmt, col, e.what());
+            }
+        } else if constexpr (constraints::is_constraint_wrapper_v<Type>) {
+            return decode_column(stmt, col, value.get());
+        } else if constexpr (requires { value.from_json(std::string{}); }) {
+            // JSON<T> is stored as its serialized text
+            try {
+                value.from_json(std::string(column_text(stmt, col)));
+            } catch (const std::exception& e) {
+                return decode_error(stmt, col, e.what());
+            }
+        } else if constexpr (std::is_constructible_v<Type, const std::string&>) {
+            // Date / DateTime, UUID and the validated string types parse and
+            // validate in their string constructor
+            try {
+                value = Type(std::string(column_text(stmt, col)));
+            } catch (const std::exception& e) {
+                return decode_error(stmt, col, e.what());
+            }
+        } else if constexpr (requires { { value.get() } -> std::same_as<int64_t&>; }) {
+            // Timestamp
+            value.get() = sqlite3_column_int64(stmt, col);
+        } else {
+            static_assert(sizeof(Type) == 0, "Unsupported field type for decode_column");
+        }
+        return Nothing{};
+    }
+}
+
+/// Step a statement for the typed readers
+/// Returns true on a row, false once done (the statement is then reset to
+/// release its read snapshot), or the step error
+inline Result<bool> step_row(sqlite3_stmt* stmt) {
+    int rc = sqlite3_step(stmt);
+    if (rc == SQLITE_ROW) {
+        return true;
+    }
+    if (rc == SQLITE_DONE) {
+        sqlite3_reset(stmt);
+        return false;
+    }
+    auto err = step_error(sqlite3_db_handle(stmt), rc, "Failed to step statement");
+    sqlite3_reset(stmt);
+    return error(err);
+}
+
+/// Match the result columns of stmt to the fields of T by name
+template <class T>
+ColumnMap<T> make_column_map(sqlite3_stmt* stmt) {
+    ColumnMap<T> map;
+    map.fill(-1);
+
+    const int count = sqlite3_column_count(stmt);
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        (([&] {
+            constexpr std::string_view field = glz::member_nameof<Is, T>;
+            for (int col = 0; col < count; ++col) {
+                if (field == sqlite3_column_name(stmt, col)) {
+                    map[Is] = col;
+                    break;
+                }
+            }
+        }()), ...);
+    }(std::make_index_sequence<glz::detail::count_members<T>>{});
+
+    return map;
+}
+
+/// Error for a non-optional field I of T that has no matching result column
+template <class T, size_t I>
+auto missing_column_error() {
+    return error("Failed to decode row: no result column for field '" +
+                 std::string(glz::member_nameof<I, T>) + "'");
+}
+
+/// Decode the current row into the fields of row
+/// An optional field without a matching column is left untouched; any other
+/// field without one is an error, so a misspelled alias or a missing column
+/// in a hand-written query does not go unnoticed
+template <class T>
+Result<Nothing> decode_row(sqlite3_stmt* stmt, const ColumnMap<T>& map, T& row) {
+    Result<Nothing> result = Nothing{};
+    auto fields = glz::to_tie(row);
+    auto decode_field = [&]<size_t I>() {
+        if (map[I] < 0) {
+            if constexpr (transpilation::is_optional_v<decltype(glz::get<I>(fields))>) {
+                return true;
+            } else {
+                result = missing_column_error<T, I>();
+                return false;
+            }
+        }
+        result = decode_column(stmt, map[I], glz::get<I>(fields));
+        return result.has_value();
+    };
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        // Stop at the first failing field
+        (void)(decode_field.template operator()<Is>() && ...);
+    }(std::make_index_sequence<glz::detail::count_members<T>>{});
+    return result;
+}
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sqlgen::sqlite {
+
+/// Runs queued work; async operations post their steps here
+class Executor {
+public:
+    virtual ~Executor() = default;
+
+    /// Queue work to run later, possibly on another thread
+    virtual void post(std::move_only_function<void()> work) = 0;
+};
+
+/// Fixed set of worker threads taking work from a shared queue
+class ThreadPoolExecutor final : public Executor {
+public:
+    /// Start threads workers (0 = one per hardware thread)
+    explicit ThreadPoolExecutor(size_t threads = 0);
+
+    /// Finish queued work, then join the workers
+    ~ThreadPoolExecutor() override;
+
+    ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+    void post(std::move_only_function<void()> work) override;
+
+    /// Number of worker threads
+    size_t size() const { return workers_.size(); }
+
+private:
+    void run();
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::move_only_function<void()>> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+/// Single-threaded executor driven by the caller
+/// Nothing runs until run_one() or run() is called, which makes the order
+/// of async steps deterministic (e.g. in tests or inside an event loop)
+class ManualExecutor final : public Executor {
+public:
+    void post(std::move_only_function<void()> work) override;
+
+    /// Run the oldest queued work item; false if the queue was empty
+    bool run_one();
+
+    /// Run until the queue is empty, including work posted meanwhile
+    /// Returns the number of items run
+    size_t run();
+
+    /// Number of queued work items
+    size_t pending() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::deque<std::move_only_function<void()>> queue_;
+};
+
+/// Process-wide thread pool used by async operations when no executor is
+/// given (one worker per hardware thread, started on first use)
+Executor& default_executor();
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "../core.hpp"
+#include "Connection.hpp"
+
+namespace sqlgen::sqlite {
+
+/// Batching limits for GroupCommitWriter
+struct GroupCommitOptions {
+    /// How long to keep collecting writes after the first one arrives
+    std::chrono::microseconds window{1000};
+
+    /// Most writes per transaction; a full batch commits without waiting
+    /// for the window to close
+    size_t max_batch = 1024;
+};
+
+/// GroupCommitWriter counters
+struct GroupCommitStats {
+    uint64_t batches = 0;         // Transactions committed
+    uint64_t writes = 0;          // Writes applied and committed
+    uint64_t failed_writes = 0;   // Writes that returned an error
+    uint64_t failed_commits = 0;  // Transactions that failed to commit
+
+    /// Mean writes per committed transaction
+    double mean_batch() const {
+        return batches == 0 ? 0.0 : static_cast<double>(writes) / static_cast<double>(batches);
+    }
+};
+
+/// Applies writes submitted from many threads on one connection, several
+/// per transaction, so they share one commit (and one fsync)
+/// A writer thread takes everything submitted within a window of the first
+/// pending write, up to max_batch, and runs it in a single transaction.
+/// Each write runs in its own savepoint: a failing write (or one that
+/// throws) is rolled back alone and reported through its future; the others
+/// still commit. A write that ends the transaction itself fails the batch.
+class GroupCommitWriter {
+public:
+    /// A unit of work run on the writer connection
+    using Write = std::move_only_function<Result<Nothing>(Connection&)>;
+
+    /// Start the writer thread; conn is used only by that thread
+    explicit GroupCommitWriter(Connection conn, GroupCommitOptions options = {});
+
+    /// Apply everything already submitted, then stop the writer thread
+    ~GroupCommitWriter();
+
+    GroupCommitWriter(const GroupCommitWriter&) = delete;
+    GroupCommitWriter& operator=(const GroupCommitWriter&) = delete;
+
+    /// Queue a query builder or SQL text to execute
+    /// The future becomes ready once its transaction commits (or fails)
+    template <class QueryBuilder>
+        requires (!std::is_invocable_v<QueryBuilder&, Connection&>)
+    std::future<Result<Nothing>> submit(QueryBuilder builder) {
+        return submit(Write([builder = std::move(builder)](Connection& conn) {
+            return conn.execute(builder);
+        }));
+    }
+
+    /// Queue arbitrary work on the writer connection (e.g. binding and
+    /// executing a prepared Statement)
+    std::future<Result<Nothing>> submit(Write write);
+
+    /// Counters
+    GroupCommitStats stats() const;
+
+private:
+    struct Pending {
+        Write write;
+        std::promise<Result<Nothing>> done;
+    };
+
+    /// Writer thread: collect a batch, apply it, repeat until stopped
+    void run();
+
+    /// Run one batch in a transaction and fulfil its promises
+    void apply(std::vector<Pending>& batch);
+
+    /// Prepare the savepoint statements on first use
+    Result<Nothing> prepare_savepoints();
+
+    /// Run one write in its own savepoint and return its result
+    /// intact is cleared if the transaction can't go on: the write ended it,
+    /// or its savepoint could not be rolled back
+    Result<Nothing> apply_write(Write& write, bool& intact);
+
+    Connection conn_;
+    GroupCommitOptions options_;
+
+    // Prepared once and reused by every write; only touched by the writer thread
+    std::optional<Statement> savepoint_;
+    std::optional<Statement> release_;
+    std::optional<Statement> rollback_to_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable ready_;
+    std::vector<Pending> queue_;
+    bool stopping_ = false;
+    GroupCommitStats stats_;
+
+    std::thread thread_;  // Started last, joined first
+};
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "SlowQueryLog.hpp"
+
+namespace sqlgen::sqlite {
+
+/// Phases of a query timed by Instrumentation
+enum class Phase : uint8_t {
+    Emit,     // Building the SQL text from a query builder
+    Prepare,  // sqlite3_prepare_v3
+    Step,     // sqlite3_step, summed over one run of the statement
+    Decode,   // Reading columns into rows, summed over one run
+    Execute,  // A statement run to completion without returning rows
+};
+
+inline constexpr size_t phase_count = 5;
+
+/// Monotonic clock reading in nanoseconds
+inline uint64_t now_ns() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// One non-empty histogram bucket: values in [lower_ns, upper_ns]
+struct HistogramBucket {
+    uint64_t lower_ns = 0;
+    uint64_t upper_ns = 0;
+    uint64_t count = 0;
+};
+
+/// Point-in-time copy of a LatencyHistogram
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+    uint64_t min_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t p50_ns = 0;
+    uint64_t p90_ns = 0;
+    uint64_t p99_ns = 0;
+    std::vector<HistogramBucket> buckets;
+
+    double mean_ns() const {
+        return count == 0 ? 0.0 : static_cast<double>(sum_ns) / static_cast<double>(count);
+    }
+
+    /// Upper bound of the bucket holding the q-quantile (0..1), capped at max_ns
+    uint64_t percentile(double q) const;
+};
+
+/// Log-linear latency histogram (HDR-style)
+/// Every power of two of nanoseconds is split into sub_buckets equal
+/// buckets, so a recorded value is placed within 1/sub_buckets of itself.
+/// Values from 2^max_exponent ns (~37 minutes) up share the last bucket.
+/// record() is lock-free; snapshots may be taken from other threads.
+class LatencyHistogram {
+public:
+    static constexpr size_t sub_bucket_bits = 3;
+    static constexpr size_t sub_buckets = size_t{1} << sub_bucket_bits;
+    static constexpr size_t max_exponent = 41;
+    static constexpr size_t bucket_count = (max_exponent - sub_bucket_bits + 1) * sub_buckets;
+
+    void record(uint64_t ns) noexcept;
+
+    uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+    HistogramSnapshot snapshot() const;
+
+    void reset() noexcept;
+
+    /// Bucket a value falls into
+    static size_t bucket_index(uint64_t ns) noexcept;
+
+    /// Smallest and largest value of a bucket
+    static uint64_t bucket_lower(size_t index) noexcept;
+    static uint64_t bucket_upper(size_t index) noexcept;
+
+private:
+    std::array<std::atomic<uint64_t>, bucket_count> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+/// sqlite3_stmt_status counters of a query shape, summed over its runs
+struct PlannerCounters {
+    uint64_t fullscan_steps = 0;  // SQLITE_STMTSTATUS_FULLSCAN_STEP: table scan steps
+    uint64_t sorts = 0;           // SQLITE_STMTSTATUS_SORT: sorts into a temp B-tree
+    uint64_t autoindexes = 0;     // SQLITE_STMTSTATUS_AUTOINDEX: rows put in automatic indexes
+    uint64_t vm_steps = 0;        // SQLITE_STMTSTATUS_VM_STEP: virtual machine operations
+};
+
+/// Counters and phase histograms of one query shape (one SQL text)
+struct QueryStats {
+    explicit QueryStats(std::string sql, std::shared_ptr<SlowQueryLog> slow_log = nullptr)
+        : sql(std::move(sql)), slow_log(std::move(slow_log)) {}
+
+    LatencyHistogram& phase(Phase p) noexcept { return phases[static_cast<size_t>(p)]; }
+    const LatencyHistogram& phase(Phase p) const noexcept { return phases[static_cast<size_t>(p)]; }
+
+    /// Add the planner counters of a finished run of stmt and reset them
+    /// on the statement, so its next run starts from zero
+    void add_planner_counters(sqlite3_stmt* stmt) noexcept;
+
+    PlannerCounters planner() const noexcept;
+
+    const std::string sql;
+    const std::shared_ptr<SlowQueryLog> slow_log;  // Of the owning Instrumentation
+    std::array<LatencyHistogram, phase_count> phases;
+    std::atomic<uint64_t> executions{0};  // Runs of the statement
+    std::atomic<uint64_t> rows{0};        // Rows returned
+    std::atomic<uint64_t> bytes{0};       // Bytes of column data decoded
+    std::atomic<uint64_t> fullscan_steps{0};
+    std::atomic<uint64_t> sorts{0};
+    std::atomic<uint64_t> autoindexes{0};
+    std::atomic<uint64_t> vm_steps{0};
+};
+
+/// Point-in-time copy of a QueryStats
+struct QueryShapeSnapshot {
+    std::string sql;
+    uint64_t executions = 0;
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+    HistogramSnapshot emit;
+    HistogramSnapshot prepare;
+    HistogramSnapshot step;
+    HistogramSnapshot decode;
+    HistogramSnapshot execute;
+    PlannerCounters planner;
+};
+
+/// When InstrumentationSnapshot::suspicious() flags a query shape
+/// Automatic indexes are always flagged: SQLite only builds one when no
+/// index fits the query.
+struct SuspicionThresholds {
+    /// Full table scan steps per run
+    uint64_t fullscan_steps_per_run = 1000;
+
+    /// Sorts are flagged only for shapes doing at least this many VM
+    /// operations per run, so ORDER BY over a handful of rows isn't
+    uint64_t sort_vm_steps_per_run = 10000;
+};
+
+/// A query shape whose plan looks like it is missing an index
+struct SuspiciousQuery {
+    std::string sql;
+    uint64_t executions = 0;
+    PlannerCounters planner;
+    std::vector<std::string> reasons;  // e.g. "full table scan: 5000 steps per run"
+};
+
+/// Point-in-time copy of all query shapes recorded by an Instrumentation
+struct InstrumentationSnapshot {
+    std::vector<QueryShapeSnapshot> queries;
+
+    /// Stats of the shape with this SQL text, if it was recorded
+    const QueryShapeSnapshot* find(std::string_view sql) const;
+
+    /// Shapes that scanned full tables, sorted into temp B-trees or built
+    /// automatic indexes, most VM operations per run first
+    std::vector<SuspiciousQuery> suspicious(const SuspicionThresholds& thresholds = {}) const;
+
+    /// Serialize with glaze
+    std::string to_json() const;
+};
+
+/// Per-query-shape timings of one connection
+/// Created by Connection::enable_instrumentation(). Shapes are keyed by
+/// SQL text, so every execution of a parameterized builder type (queried,
+/// prepared or executed) lands in the same shape regardless of its bound
+/// values; hand-written SQL with inlined values gets a shape per text.
+/// Safe to snapshot from other threads while the connection records.
+class Instrumentation {
+public:
+    /// Stats of the shape with this SQL text, created on first use
+    std::shared_ptr<QueryStats> stats(std::string_view sql);
+
+    InstrumentationSnapshot snapshot() const;
+
+    /// Forget all recorded shapes (the slow query log is kept)
+    void reset();
+
+    /// Slow query log fed by every shape; off until configured
+    const std::shared_ptr<SlowQueryLog>& slow_query_log() const noexcept { return slow_log_; }
+
+    /// Record SQLITE_TRACE_PROFILE events of db (statements run by
+    /// sqlite3_exec) as Execute until detach_trace(db); slow ones go to
+    /// the slow query log
+    void attach_trace(sqlite3* db);
+    void detach_trace(sqlite3* db);
+
+private:
+    struct Hash {
+        using is_transparent = void;
+        size_t operator()(std::string_view sql) const noexcept { return std::hash<std::string_view>{}(sql); }
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<QueryStats>, Hash, std::equal_to<>> queries_;
+    std::shared_ptr<SlowQueryLog> slow_log_ = std::make_shared<SlowQueryLog>();
+};
+
+/// Bytes of column data in the current row of stmt
+/// Text and blobs count their size, numbers 8 bytes, NULL nothing
+inline size_t row_bytes(sqlite3_stmt* stmt) {
+    size_t bytes = 0;
+    const int count = sqlite3_column_count(stmt);
+    for (int i = 0; i < count; ++i) {
+        switch (sqlite3_column_type(stmt, i)) {
+            case SQLITE_INTEGER:
+            case SQLITE_FLOAT:
+                bytes += 8;
+                break;
+            case SQLITE_TEXT:
+            case SQLITE_BLOB:
+                bytes += static_cast<size_t>(sqlite3_column_bytes(stmt, i));
+                break;
+            default:
+                break;
+        }
+    }
+    return bytes;
+}
+
+/// Collects the step and decode time of one run of a statement
+/// An iterator owns one; it records into its QueryStats once when the run
+/// ends (or the iterator is dropped), along with the statement's planner
+/// counters, and logs the run if it was slow. Without stats every call is a
+/// single null check, so iterators of an uninstrumented connection pay
+/// nothing else.
+class QueryProbe {
+public:
+    QueryProbe() = default;
+
+    /// stmt must outlive the probe (iterators declare it first)
+    /// setup holds the emit and prepare time spent on this run, and
+    /// parameter_types the SQLite types bound to stmt, for the slow query log
+    QueryProbe(std::shared_ptr<QueryStats> stats, sqlite3_stmt* stmt, RunPhases setup = {},
+               std::vector<int> parameter_types = {})
+        : stats_(std::move(stats)), stmt_(stmt), phases_(setup), parameter_types_(std::move(parameter_types)) {}
+
+    QueryProbe(QueryProbe&& other) noexcept
+        : stats_(std::move(other.stats_)), stmt_(other.stmt_), phases_(other.phases_), rows_(other.rows_),
+          bytes_(other.bytes_), parameter_types_(std::move(other.parameter_types_)) {}
+
+    QueryProbe& operator=(QueryProbe&& other) noexcept {
+        if (this != &other) {
+            finish();
+            stats_ = std::move(other.stats_);
+            stmt_ = other.stmt_;
+            phases_ = other.phases_;
+            rows_ = other.rows_;
+            bytes_ = other.bytes_;
+            parameter_types_ = std::move(other.parameter_types_);
+        }
+        return *this;
+    }
+
+    QueryProbe(const QueryProbe&) = delete;
+    QueryProbe& operator=(const QueryProbe&) = delete;
+
+    ~QueryProbe() { finish(); }
+
+    /// Whether anything is recorded
+    explicit operator bool() const noexcept { return stats_ != nullptr; }
+
+    /// Run f, adding its duration to phase (Step or Decode)
+    template <class F>
+    decltype(auto) time(Phase phase, F&& f) {
+        if (!stats_) {
+            return std::forward<F>(f)();
+        }
+        struct Timer {
+            uint64_t& total;
+            uint64_t start = now_ns();
+            ~Timer() { total += now_ns() - start; }
+        } timer{phase == Phase::Step ? phases_.step_ns : phases_.decode_ns};
+        return std::forward<F>(f)();
+    }
+
+    void add_row() noexcept { ++rows_; }
+
+    void add_bytes(size_t bytes) noexcept { bytes_ += bytes; }
+
+    /// Record the run and detach; later calls do nothing
+    /// A slow query log entry that fails to allocate is skipped
+    void finish() noexcept;
+
+private:
+    std::shared_ptr<QueryStats> stats_;
+    sqlite3_stmt* stmt_ = nullptr;
+    RunPhases phases_;
+    uint64_t rows_ = 0;
+    uint64_t bytes_ = 0;
+    std::vector<int> parameter_types_;
+};
+
+} // namespace sqlgen::sqlite
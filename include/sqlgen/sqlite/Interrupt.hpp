@@ -0,0 +1,102 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include "../core.hpp"
+
+namespace sqlgen::sqlite {
+
+/// Start of the error of a statement stopped by its connection's deadline
+inline constexpr std::string_view deadline_exceeded_error = "Query deadline exceeded";
+
+/// Start of the error of a statement stopped by CancelHandle::cancel()
+inline constexpr std::string_view cancelled_error = "Query cancelled";
+
+inline bool is_deadline_exceeded(const Error& e) { return e.starts_with(deadline_exceeded_error); }
+
+inline bool is_cancelled(const Error& e) { return e.starts_with(cancelled_error); }
+
+/// Error of a statement of db that failed with rc while doing what
+/// SQLITE_INTERRUPT becomes a deadline or cancellation error; anything
+/// else reads "<what>: <sqlite3_errmsg>".
+Error step_error(sqlite3* db, int rc, std::string_view what);
+
+/// Deadline for the statements run on one connection
+/// A progress handler compares it against the clock every check_interval
+/// virtual machine operations; without a deadline that is one relaxed load.
+class QueryDeadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int check_interval = 1000;
+
+    /// Become db's progress handler (until it is unregistered, which must
+    /// happen before this is destroyed)
+    void install(sqlite3* db) noexcept;
+
+    void set(Clock::time_point deadline) noexcept;
+
+    void clear() noexcept { deadline_ns_.store(none, std::memory_order_relaxed); }
+
+    std::optional<Clock::time_point> get() const noexcept;
+
+private:
+    static constexpr int64_t none = INT64_MAX;
+
+    static int on_progress(void* self) noexcept;
+
+    std::atomic<int64_t> deadline_ns_{none};
+};
+
+/// Puts a connection's previous deadline back when it goes out of scope
+/// Returned by Connection::scoped_timeout().
+class ScopedDeadline {
+public:
+    ScopedDeadline(std::shared_ptr<QueryDeadline> deadline, std::optional<QueryDeadline::Clock::time_point> previous)
+        : deadline_(std::move(deadline)), previous_(previous) {}
+
+    ScopedDeadline(ScopedDeadline&& other) noexcept
+        : deadline_(std::move(other.deadline_)), previous_(other.previous_) {}
+    ScopedDeadline& operator=(ScopedDeadline&&) = delete;
+
+    ScopedDeadline(const ScopedDeadline&) = delete;
+    ScopedDeadline& operator=(const ScopedDeadline&) = delete;
+
+    ~ScopedDeadline() {
+        if (!deadline_) {
+            return;
+        }
+        if (previous_) {
+            deadline_->set(*previous_);
+        } else {
+            deadline_->clear();
+        }
+    }
+
+private:
+    std::shared_ptr<QueryDeadline> deadline_;
+    std::optional<QueryDeadline::Clock::time_point> previous_;
+};
+
+/// Interrupts whatever a connection is running, from any thread
+/// Statements running when cancel() is called fail with an error
+/// is_cancelled() recognizes; statements started after they have all
+/// stopped are not affected. Does nothing once the connection is closed.
+class CancelHandle {
+public:
+    CancelHandle() = default;
+
+    explicit CancelHandle(std::weak_ptr<sqlite3> db) : db_(std::move(db)) {}
+
+    void cancel() const;
+
+private:
+    std::weak_ptr<sqlite3> db_;
+};
+
+} // namespace sqlgen::sqlite
@@ -4,8 +4,12 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include "../core.hpp"
+#include "Instrumentation.hpp"
+#include "Interrupt.hpp"
+#include "RowView.hpp"
 
 namespace sqlgen::sqlite {
 
@@ -17,7 +21,18 @@ public:
 
     /// Construct from prepared statement
     /// Takes ownership of stmt via shared_ptr with custom deleter
-    Iterator(sqlite3_stmt* stmt, sqlite3* conn);
+    /// The run is recorded through probe (see QueryProbe)
+    Iterator(sqlite3_stmt* stmt, sqlite3* conn, QueryProbe probe = {});
+
+    /// Construct from a statement shared with its owner (e.g. a Statement)
+    Iterator(std::shared_ptr<sqlite3_stmt> stmt, sqlite3* conn, QueryProbe probe = {});
+
+    /// Dropping an iterator before the end resets its statement, so the
+    /// read snapshot (or write transaction) of the run is not held open
+    ~Iterator() { close(); }
+
+    Iterator(Iterator&&) noexcept = default;
+    Iterator& operator=(Iterator&& other) noexcept;
 
     /// Check if we've reached the end of results
     bool end() const { return end_; }
@@ -26,16 +41,67 @@ public:
     /// Returns std::nullopt if at end
     std::optional<Row> next();
 
+    /// Read the next row into out, reusing its vector and string capacity
+    /// Returns false if at end (out is left untouched)
+    bool next(Row& out);
+
+    /// Read up to n rows into rows, reusing the Rows already in it
+    /// rows is resized to the number of rows read, which is returned;
+    /// fewer than n means the end was reached
+    size_t next_batch(std::vector<Row>& rows, size_t n);
+
+    /// Error that ended the iteration early, if any
+    /// (end() is also true in that case)
+    const std::optional<Error>& last_error() const { return error_; }
+
+    /// Read all remaining rows, or the error that ended the iteration
+    /// (e.g. a deadline or cancellation, see is_deadline_exceeded())
+    Result<std::vector<Row>> collect();
+
     /// Get number of columns
     int column_count() const { return num_cols_; }
 
+    /// View of the current row (the row next() would return), without copying
+    /// Valid until the iterator moves on; check end() first
+    RowView view() const { return RowView(stmt_.get()); }
+
+    /// Skip the current row
+    void advance() { step(); }
+
+    /// Call f(RowView) for every remaining row without allocating
+    /// If f returns bool, returning false stops after that row
+    template <class F>
+    void for_each_row(F&& f) {
+        while (!end_) {
+            RowView row(stmt_.get());
+            if constexpr (std::is_same_v<std::invoke_result_t<F&, RowView>, bool>) {
+                bool keep_going = f(row);
+                step();
+                if (!keep_going) {
+                    return;
+                }
+            } else {
+                f(row);
+                step();
+            }
+        }
+    }
+
 private:
     void step();
 
+    /// Record the run and reset the statement if it was left mid-run
+    void close() noexcept;
+
+    /// Copy the current row into out; returns the bytes of text read
+    size_t read_row(Row& out);
+
     bool end_;
     int num_cols_;
+    std::optional<Error> error_;
     std::shared_ptr<sqlite3_stmt> stmt_;
     std::shared_ptr<sqlite3> conn_;  // Keep connection alive
+    QueryProbe probe_;
 };
 
 } // namespace sqlgen::sqlite
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include "../core.hpp"
+#include "Decode.hpp"
+
+namespace sqlgen::sqlite {
+
+/// Non-owning view of the current row of a statement
+/// Text and blob accessors point straight into SQLite's column buffers;
+/// everything obtained from a view is valid only until the statement is
+/// stepped again.
+class RowView {
+public:
+    explicit RowView(sqlite3_stmt* stmt) noexcept : stmt_(stmt) {}
+
+    /// Number of columns
+    int size() const noexcept { return sqlite3_column_count(stmt_); }
+
+    /// Column name
+    std::string_view name(int i) const { return sqlite3_column_name(stmt_, i); }
+
+    /// Check whether a column is NULL
+    bool is_null(int i) const noexcept { return sqlite3_column_type(stmt_, i) == SQLITE_NULL; }
+
+    /// Column text (empty for NULL)
+    std::string_view text(int i) const { return column_text(stmt_, i); }
+
+    /// Column blob (empty for NULL)
+    std::span<const std::byte> blob(int i) const {
+        const auto* data = static_cast<const std::byte*>(sqlite3_column_blob(stmt_, i));
+        if (!data) {
+            return {};
+        }
+        return {data, static_cast<size_t>(sqlite3_column_bytes(stmt_, i))};
+    }
+
+    /// Typed column access without allocation
+    /// Supports integers, bool, enums, floating point, std::string_view,
+    /// std::span<const std::byte> and std::optional of those (NULL -> nullopt).
+    /// A NULL read as a non-optional type yields SQLite's conversion (0 / empty).
+    template <class T>
+    T get(int i) const {
+        if constexpr (transpilation::is_optional_v<T>) {
+            if (is_null(i)) {
+                return std::nullopt;
+            }
+            return get<typename T::value_type>(i);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return sqlite3_column_int64(stmt_, i) != 0;
+        } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            return static_cast<T>(sqlite3_column_int64(stmt_, i));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return static_cast<T>(sqlite3_column_double(stmt_, i));
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            return text(i);
+        } else if constexpr (std::is_same_v<T, std::span<const std::byte>>) {
+            return blob(i);
+        } else {
+            static_assert(sizeof(T) == 0, "Unsupported type for RowView::get; use decode()");
+        }
+    }
+
+    /// Decode a column into any type supported by decode_column
+    /// (owning strings, constraint wrappers, domain types, ...)
+    template <class T>
+    Result<Nothing> decode(int i, T& out) const {
+        return decode_column(stmt_, i, out);
+    }
+
+    /// Raw statement handle
+    sqlite3_stmt* handle() const noexcept { return stmt_; }
+
+private:
+    sqlite3_stmt* stmt_;
+};
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sqlgen::sqlite {
+
+/// Elapsed time of one run of a statement, by phase (0 = not part of the run)
+struct RunPhases {
+    uint64_t emit_ns = 0;     // Building the SQL (cache misses only)
+    uint64_t prepare_ns = 0;  // Preparing it (cache misses only)
+    uint64_t step_ns = 0;
+    uint64_t decode_ns = 0;
+    uint64_t execute_ns = 0;  // Statement::execute
+
+    uint64_t total_ns() const noexcept { return emit_ns + prepare_ns + step_ns + decode_ns + execute_ns; }
+};
+
+/// One query that ran over the slow query threshold
+struct SlowQuery {
+    std::string sql;
+    std::vector<std::string> parameter_types;  // INTEGER, REAL, TEXT, BLOB or NULL per parameter
+    RunPhases phases;
+    uint64_t rows = 0;
+    std::vector<std::string> plan;  // EXPLAIN QUERY PLAN, one line per step, indented by depth
+    std::chrono::system_clock::time_point finished_at;
+};
+
+/// Bounded ring buffer of the most recent slow queries of a connection
+/// Owned by an Instrumentation and off until configure(); while off,
+/// is_slow() is a single relaxed load. Entries may be read from other
+/// threads while the connection records.
+class SlowQueryLog {
+public:
+    static constexpr size_t default_capacity = 64;
+
+    /// Keep runs taking at least threshold, up to capacity of them (the
+    /// oldest are dropped first); entries already kept are preserved if
+    /// they fit
+    void configure(std::chrono::nanoseconds threshold, size_t capacity = default_capacity);
+
+    /// Stop recording; kept entries stay until clear()
+    void disable() noexcept { threshold_ns_.store(UINT64_MAX, std::memory_order_relaxed); }
+
+    bool enabled() const noexcept { return threshold_ns_.load(std::memory_order_relaxed) != UINT64_MAX; }
+
+    std::chrono::nanoseconds threshold() const noexcept {
+        return std::chrono::nanoseconds(threshold_ns_.load(std::memory_order_relaxed));
+    }
+
+    /// Whether a run of this length belongs in the log
+    bool is_slow(uint64_t ns) const noexcept { return ns >= threshold_ns_.load(std::memory_order_relaxed); }
+
+    /// Add a run of stmt, reading its EXPLAIN QUERY PLAN from the statement's
+    /// connection (the SQL is prepared again, so stmt is left untouched)
+    void record(sqlite3_stmt* stmt, const std::string& sql, const RunPhases& phases, uint64_t rows,
+                const std::vector<int>& parameter_types);
+
+    /// Add an entry as is
+    void record(SlowQuery entry);
+
+    /// Kept entries, oldest first
+    std::vector<SlowQuery> entries() const;
+
+    /// Slow runs seen since the last clear(), including dropped ones
+    uint64_t total() const;
+
+    void clear();
+
+    /// Kept entries as text, oldest first, for logs and debugging
+    std::string dump() const;
+
+    /// EXPLAIN QUERY PLAN of sql on db, one line per step indented by depth
+    /// (empty if sql can't be explained)
+    static std::vector<std::string> explain(sqlite3* db, const std::string& sql);
+
+private:
+    std::atomic<uint64_t> threshold_ns_{UINT64_MAX};
+
+    mutable std::mutex mutex_;
+    std::vector<SlowQuery> entries_;  // Ring buffer; next_ is the oldest once full
+    size_t capacity_ = default_capacity;
+    size_t next_ = 0;
+    uint64_t total_ = 0;
+};
+
+/// Name of an SQLite fundamental type (SQLITE_INTEGER -> "INTEGER")
+const char* type_name(int type) noexcept;
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <glaze/reflection/to_tuple.hpp>
+#include "../core.hpp"
+#include "../constraints/traits.hpp"
+#include "ColumnBatch.hpp"
+#include "Instrumentation.hpp"
+#include "Iterator.hpp"
+#include "TypedIterator.hpp"
+
+namespace sqlgen::sqlite {
+
+/// Reusable prepared statement
+/// Values are bound directly with sqlite3_bind_*; the statement can be
+/// reset and rebound any number of times without being prepared again.
+class Statement {
+public:
+    /// Construct from a prepared statement
+    /// Shares ownership of stmt (finalized when the last owner goes away).
+    /// With stats, each run of the statement is recorded there; setup is
+    /// the emit and prepare time the first run is charged with.
+    explicit Statement(std::shared_ptr<sqlite3_stmt> stmt, std::shared_ptr<QueryStats> stats = nullptr,
+                       RunPhases setup = {})
+        : stmt_(std::move(stmt)), stats_(std::move(stats)), setup_(setup) {}
+
+    /// Bind NULL to a parameter (1-based index)
+    Result<Nothing> bind_null(int index);
+
+    /// Bind primitive values to a parameter (1-based index)
+    Result<Nothing> bind(int index, int64_t value);
+    Result<Nothing> bind(int index, double value);
+    Result<Nothing> bind(int index, std::string_view value);
+    Result<Nothing> bind(int index, std::span<const std::byte> value);
+
+    /// Bind any supported value: integers, bool, floating point, strings,
+    /// blobs, std::optional (nullopt -> NULL) and the constraint/domain
+    /// wrapper types (bound as their underlying value)
+    template <class T>
+    Result<Nothing> bind(int index, const T& value);
+
+    /// Bind a tuple of values to parameters 1..N
+    /// (e.g. the params of a builder's to_parameterized_sql())
+    template <class... Ts>
+    Result<Nothing> bind_all(const std::tuple<Ts...>& values);
+
+    /// Bind the reflected fields of a struct to parameters first..first+N-1
+    /// (matches the column order of Insert<T>)
+    template <class T>
+    Result<Nothing> bind_row(const T& row, int first = 1);
+
+    /// Reset the statement so it can be stepped again (bindings are kept)
+    Result<Nothing> reset();
+
+    /// Set all parameters back to NULL
+    Result<Nothing> clear_bindings();
+
+    /// Run the statement to completion, then reset it
+    Result<Nothing> execute();
+
+    /// Run the statement and iterate over its results
+    /// The iterator shares the statement; reset() before rebinding
+    Result<Iterator> query();
+
+    /// Run the statement and iterate over its results decoded into T
+    template <class T>
+    Result<TypedIterator<T>> query() {
+        sqlite3_reset(stmt_.get());
+        return TypedIterator<T>(stmt_, probe());
+    }
+
+    /// Run the statement and read its results in column batches
+    template <class T>
+    Result<ColumnIterator<T>> fetch_columns(size_t batch_size) {
+        sqlite3_reset(stmt_.get());
+        return ColumnIterator<T>(stmt_, batch_size, probe());
+    }
+
+    /// Number of parameters in the statement
+    int parameter_count() const { return sqlite3_bind_parameter_count(stmt_.get()); }
+
+    /// SQL text the statement was prepared from
+    std::string_view sql() const { return sqlite3_sql(stmt_.get()); }
+
+    /// Raw statement handle
+    sqlite3_stmt* handle() const noexcept { return stmt_.get(); }
+
+private:
+    /// Turn a sqlite3_bind_* result into a Result; on success, remember
+    /// the type bound at index when instrumented
+    Result<Nothing> check_bind(int rc, int index, int type);
+
+    /// Probe for the next run, charged with the pending setup time
+    QueryProbe probe();
+
+    /// SQLite type bound to each parameter (unbound ones are NULL)
+    std::vector<int> parameter_types() const;
+
+    std::shared_ptr<sqlite3_stmt> stmt_;
+    std::shared_ptr<QueryStats> stats_;
+    RunPhases setup_;
+    std::vector<int> bound_types_;  // Only kept when stats_ is set
+};
+
+template <class T>
+Result<Nothing> Statement::bind(int index, const T& value) {
+    using Type = std::remove_cvref_t<T>;
+
+    if constexpr (std::is_same_v<Type, std::nullopt_t> || std::is_same_v<Type, std::nullptr_t>) {
+        return bind_null(index);
+    } else if constexpr (transpilation::is_optional_v<Type>) {
+        if (!value.has_value()) {
+            return bind_null(index);
+        }
+        return bind(index, *value);
+    } else if constexpr (std::is_same_v<Type, bool>) {
+        return bind(index, static_cast<int64_t>(value ? 1 : 0));
+    } else if constexpr (std::is_integral_v<Type> || std::is_enum_v<Type>) {
+        return bind(index, static_cast<int64_t>(value));
+    } else if constexpr (std::is_floating_point_v<Type>) {
+        return bind(index, static_cast<double>(value));
+    } else if constexpr (std::is_convertible_v<const Type&, std::string_view> &&
+                         !constraints::is_constraint_wrapper_v<Type>) {
+        return bind(index, std::string_view(value));
+    } else if constexpr (std::is_same_v<Type, std::vector<std::byte>>) {
+        return bind(index, std::span<const std::byte>(value));
+    } else if constexpr (constraints::is_constraint_wrapper_v<Type>) {
+        return bind(index, value.get());
+    } else if constexpr (requires { value.to_json(); }) {
+        // JSON<T> is stored as its serialized text
+        return bind(index, value.to_json());
+    } else if constexpr (requires { value.to_string(); }) {
+        // Date / DateTime are stored as ISO 8601 text
+        return bind(index, value.to_string());
+    } else if constexpr (requires { value.get(); }) {
+        // Timestamp, UUID and the validated string types
+        return bind(index, value.get());
+    } else {
+        static_assert(sizeof(Type) == 0, "Unsupported parameter type for Statement::bind");
+    }
+}
+
+template <class... Ts>
+Result<Nothing> Statement::bind_all(const std::tuple<Ts...>& values) {
+    Result<Nothing> result = Nothing{};
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        // Stop at the first failing bind
+        (void)((result = bind(static_cast<int>(Is + 1), std::get<Is>(values))).has_value() && ...);
+    }(std::index_sequence_for<Ts...>{});
+    return result;
+}
+
+template <class T>
+Result<Nothing> Statement::bind_row(const T& row, int first) {
+    using Type = std::remove_cvref_t<T>;
+    constexpr size_t field_count = glz::detail::count_members<Type>;
+
+    Result<Nothing> result = Nothing{};
+    auto fields = glz::to_tie(row);
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        (void)((result = bind(first + static_cast<int>(Is), glz::get<Is>(fields))).has_value() && ...);
+    }(std::make_index_sequence<field_count>{});
+    return result;
+}
+
+} // namespace sqlgen::sqlite
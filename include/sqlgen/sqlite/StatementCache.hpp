@@ -0,0 +1,82 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace sqlgen::sqlite {
+
+/// Per-type cache key: the address of this variable is unique per builder
+/// type, so the SQL text never has to be built to look a statement up
+template <class QueryBuilder>
+inline constexpr char statement_key = 0;
+
+/// Key of a cached statement
+/// Builder types with a static SQL shape use their type key, or the address
+/// of their compile-time SQL text; hand-written SQL falls back to the text
+/// itself (type == nullptr)
+struct StatementKey {
+    const void* type = nullptr;
+    std::string sql;
+
+    bool operator==(const StatementKey&) const = default;
+};
+
+struct StatementKeyHash {
+    size_t operator()(const StatementKey& key) const noexcept {
+        if (key.type) {
+            return std::hash<const void*>{}(key.type);
+        }
+        return std::hash<std::string>{}(key.sql);
+    }
+};
+
+/// Statement cache counters
+struct StatementCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+/// LRU cache of prepared statements, owned by a Connection
+class StatementCache {
+public:
+    static constexpr size_t default_capacity = 64;
+
+    explicit StatementCache(size_t capacity = default_capacity) : capacity_(capacity) {}
+
+    /// Look up a statement and mark it most recently used
+    /// Returns nullptr on a miss
+    std::shared_ptr<sqlite3_stmt> find(const StatementKey& key);
+
+    /// Add a statement, evicting the least recently used one if full
+    void insert(StatementKey key, std::shared_ptr<sqlite3_stmt> stmt);
+
+    /// Drop all cached statements (counters are kept)
+    void clear();
+
+    /// Change the capacity, evicting statements if necessary
+    /// A capacity of 0 disables caching
+    void set_capacity(size_t capacity);
+
+    StatementCacheStats stats() const;
+
+private:
+    using Entry = std::pair<StatementKey, std::shared_ptr<sqlite3_stmt>>;
+
+    void evict_to(size_t size);
+
+    size_t capacity_;
+    std::list<Entry> entries_;  // Most recently used first
+    std::unordered_map<StatementKey, std::list<Entry>::iterator, StatementKeyHash> index_;
+    StatementCacheStats stats_;
+};
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "../core.hpp"
+#include "Decode.hpp"
+#include "Instrumentation.hpp"
+
+namespace sqlgen::sqlite {
+
+/// Iterator over SQL query results decoded into T
+/// Structs are filled by matching result column names to field names;
+/// any other T is decoded from the first column.
+/// Columns are read with sqlite3_column_int64/double/text/blob, so there is
+/// no round trip through text for numeric values.
+template <class T>
+class TypedIterator {
+public:
+    /// Construct from a statement ready to be stepped
+    /// Shares ownership of stmt; the run is recorded through probe
+    explicit TypedIterator(std::shared_ptr<sqlite3_stmt> stmt, QueryProbe probe = {})
+        : stmt_(std::move(stmt)), probe_(std::move(probe)) {
+        if constexpr (is_reflected_row_v<T>) {
+            columns_ = make_column_map<T>(stmt_.get());
+        }
+    }
+
+    /// Dropping an iterator before the end resets its statement, so the
+    /// read snapshot (or write transaction) of the run is not held open
+    ~TypedIterator() { close(); }
+
+    TypedIterator(TypedIterator&&) noexcept = default;
+
+    TypedIterator& operator=(TypedIterator&& other) noexcept {
+        if (this != &other) {
+            close();
+            stmt_ = std::move(other.stmt_);
+            columns_ = other.columns_;
+            end_ = other.end_;
+            probe_ = std::move(other.probe_);
+        }
+        return *this;
+    }
+
+    /// Check if next() has reached the end of results
+    bool end() const { return end_; }
+
+    /// Decode the next row into out, reusing its storage
+    /// Returns false at the end of results
+    Result<bool> next(T& out);
+
+    /// Get the next row
+    /// Returns std::nullopt at the end of results
+    Result<std::optional<T>> next();
+
+    /// Decode all remaining rows
+    Result<std::vector<T>> collect();
+
+private:
+    /// Record the run and reset the statement if it was left mid-run
+    void close() noexcept {
+        probe_.finish();
+        if (stmt_ && !end_) {
+            sqlite3_reset(stmt_.get());
+        }
+    }
+
+    std::shared_ptr<sqlite3_stmt> stmt_;
+    ColumnMap<T> columns_{};
+    bool end_ = false;
+    QueryProbe probe_;
+};
+
+template <class T>
+Result<bool> TypedIterator<T>::next(T& out) {
+    if (end_) {
+        return false;
+    }
+
+    auto has_row = probe_.time(Phase::Step, [&] { return step_row(stmt_.get()); });
+    if (!has_row || !*has_row) {
+        end_ = true;
+        probe_.finish();
+        return has_row;
+    }
+
+    if (probe_) {
+        probe_.add_row();
+        probe_.add_bytes(row_bytes(stmt_.get()));
+    }
+
+    auto decoded = probe_.time(Phase::Decode, [&]() -> Result<Nothing> {
+        if constexpr (is_reflected_row_v<T>) {
+            return decode_row(stmt_.get(), columns_, out);
+        } else {
+            if (sqlite3_column_count(stmt_.get()) < 1) {
+                return error("Failed to decode row: query returns no columns");
+            }
+            return decode_column(stmt_.get(), 0, out);
+        }
+    });
+    if (!decoded) {
+        return error(decoded.error());
+    }
+    return true;
+}
+
+template <class T>
+Result<std::optional<T>> TypedIterator<T>::next() {
+    T row{};
+    auto has_row = next(row);
+    if (!has_row) {
+        return error(has_row.error());
+    }
+    if (!*has_row) {
+        return std::optional<T>{};
+    }
+    return std::optional<T>(std::move(row));
+}
+
+template <class T>
+Result<std::vector<T>> TypedIterator<T>::collect() {
+    std::vector<T> rows;
+    while (true) {
+        T row{};
+        auto has_row = next(row);
+        if (!has_row) {
+            return error(has_row.error());
+        }
+        if (!*has_row) {
+            break;
+        }
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+} // namespace sqlgen::sqlite
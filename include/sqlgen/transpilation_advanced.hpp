@@ -375,6 +375,11 @@ constexpr std::string_view get_table_name() {
     }
 }
 
+/// Quoted table name of T, built at compile time
+template <class T>
+inline constexpr std::string_view quoted_table_name =
+    static_string<[] { return quote_identifier(get_table_name<T>()); }>.view();
+
 /// Field information for a struct field
 struct FieldInfo {
     std::string name;
@@ -385,7 +390,7 @@ struct FieldInfo {
 
 /// Get field information for a type using glaze reflection
 template <class T>
-std::vector<FieldInfo> get_fields() {
+constexpr std::vector<FieldInfo> get_fields() {
     using Type = std::remove_cvref_t<T>;
     std::vector<FieldInfo> fields;
 
@@ -439,12 +444,12 @@ std::vector<FieldInfo> get_fields() {
             else if constexpr (constraints::is_varchar_v<FieldType>) {
                 // Varchar with length constraint
                 constexpr size_t length = constraints::varchar_length_v<FieldType>;
-                info.sql_type = "VARCHAR(" + std::to_string(length) + ")";
+                info.sql_type = "VARCHAR(" + to_decimal(length) + ")";
             }
             else if constexpr (constraints::is_char_v<FieldType>) {
                 // Char with fixed length
                 constexpr size_t length = constraints::char_length_v<FieldType>;
-                info.sql_type = "CHAR(" + std::to_string(length) + ")";
+                info.sql_type = "CHAR(" + to_decimal(length) + ")";
             }
             else {
                 // No constraint wrapper, use FieldType directly
@@ -460,7 +465,7 @@ std::vector<FieldInfo> get_fields() {
 
 /// Generate a comma-separated list of field names
 template <class T>
-std::string get_field_list() {
+constexpr std::string get_field_list() {
     auto fields = get_fields<T>();
     std::string result;
 
@@ -474,14 +479,14 @@ std::string get_field_list() {
 
 /// Generate CREATE TABLE statement for a type
 template <class T>
-std::string create_table_sql(bool if_not_exists = false) {
+constexpr std::string create_table_sql(bool if_not_exists = false) {
     std::string sql = "CREATE TABLE ";
 
     if (if_not_exists) {
         sql += "IF NOT EXISTS ";
     }
 
-    sql += quote_identifier(std::string(get_table_name<T>()));
+    sql += quote_identifier(get_table_name<T>());
     sql += " (\n";
 
     auto fields = get_fields<T>();
@@ -546,91 +551,117 @@ std::string create_table_sql(bool if_not_exists = false) {
 // FIELD LIST
 // ============================================================================
 
-/// Generate a SELECT field list from a type
+/// Append a SELECT field list of a type to out, each field qualified by
+/// table_alias when it is not empty
 template <class T>
-std::string select_field_list(std::string_view table_alias = "") {
-    using Type = std::remove_cvref_t<T>;
-    std::string result;
+constexpr void append_select_field_list(std::string& out, std::string_view table_alias = "");
+
+/// Quoted field list of T ("a", "b", ...), built at compile time
+template <class T>
+inline constexpr std::string_view quoted_field_list = static_string<[] {
+    std::string sql;
+    append_select_field_list<T>(sql);
+    return sql;
+}>.view();
+
+/// Field list of T qualified by its table name ("T"."a", "T"."b", ...),
+/// built at compile time
+template <class T>
+inline constexpr std::string_view qualified_field_list = static_string<[] {
+    std::string sql;
+    append_select_field_list<T>(sql, get_table_name<T>());
+    return sql;
+}>.view();
 
+/// Upper bound of the length of select_field_list<T>() with an alias of
+/// alias_size characters
+template <class T>
+constexpr size_t select_field_list_size(size_t alias_size = 0) {
+    return quoted_field_list<T>.size() + glz::detail::count_members<std::remove_cvref_t<T>> * (alias_size + 3);
+}
+
+template <class T>
+constexpr void append_select_field_list(std::string& out, std::string_view table_alias) {
+    using Type = std::remove_cvref_t<T>;
     constexpr size_t field_count = glz::detail::count_members<Type>;
 
     [&]<size_t... Is>(std::index_sequence<Is...>) {
-        size_t idx = 0;
         ([&] {
-            if (idx > 0) result += ", ";
+            if (Is > 0) out += ", ";
 
             if (!table_alias.empty()) {
-                result += quote_identifier(std::string(table_alias));
-                result += ".";
+                append_identifier(out, table_alias);
+                out += ".";
             }
 
-            result += quote_identifier(std::string(glz::member_nameof<Is, Type>));
-            ++idx;
+            append_identifier(out, glz::member_nameof<Is, Type>);
         }(), ...);
     }(std::make_index_sequence<field_count>{});
+}
 
+/// Generate a SELECT field list from a type
+template <class T>
+constexpr std::string select_field_list(std::string_view table_alias = "") {
+    if (table_alias.empty()) {
+        return std::string(quoted_field_list<T>);
+    }
+    std::string result;
+    result.reserve(select_field_list_size<T>(table_alias.size()));
+    append_select_field_list<T>(result, table_alias);
     return result;
 }
 
 /// Generate a SELECT field list with explicit aliasing
 template <class T>
-std::string select_field_list_with_alias(std::string_view table_alias) {
+constexpr std::string select_field_list_with_alias(std::string_view table_alias) {
     using Type = std::remove_cvref_t<T>;
     std::string result;
 
     constexpr size_t field_count = glz::detail::count_members<Type>;
 
     [&]<size_t... Is>(std::index_sequence<Is...>) {
-        size_t idx = 0;
         ([&] {
-            if (idx > 0) result += ", ";
+            if (Is > 0) result += ", ";
 
-            result += quote_identifier(std::string(table_alias));
+            append_identifier(result, table_alias);
             result += ".";
-            result += quote_identifier(std::string(glz::member_nameof<Is, Type>));
+            append_identifier(result, glz::member_nameof<Is, Type>);
             result += " AS ";
-            result += quote_identifier(std::string(glz::member_nameof<Is, Type>));
-
-            ++idx;
+            append_identifier(result, glz::member_nameof<Is, Type>);
         }(), ...);
     }(std::make_index_sequence<field_count>{});
 
     return result;
 }
 
-/// Generate an INSERT field list (just field names)
+/// Append an INSERT field list (just field names) to out
 template <class T>
-std::string insert_field_list() {
-    using Type = std::remove_cvref_t<T>;
-    std::string result;
-
-    constexpr size_t field_count = glz::detail::count_members<Type>;
-
-    [&]<size_t... Is>(std::index_sequence<Is...>) {
-        size_t idx = 0;
-        ([&] {
-            if (idx > 0) result += ", ";
-            result += quote_identifier(std::string(glz::member_nameof<Is, Type>));
-            ++idx;
-        }(), ...);
-    }(std::make_index_sequence<field_count>{});
-
-    return result;
+constexpr void append_insert_field_list(std::string& out) {
+    append_static(out, quoted_field_list<T>);
 }
 
-/// Generate placeholder list for INSERT VALUES
+/// Generate an INSERT field list (just field names)
 template <class T>
-std::string insert_placeholders() {
-    using Type = std::remove_cvref_t<T>;
-    std::string result;
+constexpr std::string insert_field_list() {
+    return std::string(quoted_field_list<T>);
+}
 
-    constexpr size_t field_count = glz::detail::count_members<Type>;
+/// Append the placeholder list for INSERT VALUES to out
+template <class T>
+constexpr void append_insert_placeholders(std::string& out) {
+    constexpr size_t field_count = glz::detail::count_members<std::remove_cvref_t<T>>;
 
     for (size_t i = 0; i < field_count; ++i) {
-        if (i > 0) result += ", ";
-        result += "?";
+        if (i > 0) out += ", ";
+        out += "?";
     }
+}
 
+/// Generate placeholder list for INSERT VALUES
+template <class T>
+constexpr std::string insert_placeholders() {
+    std::string result;
+    append_insert_placeholders<T>(result);
     return result;
 }
 
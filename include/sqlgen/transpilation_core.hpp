@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -63,25 +66,144 @@ enum class Operator {
 // QUOTING
 // ============================================================================
 
+/// Append text with static storage (literals, template arguments,
+/// static_string) to out
+/// Constant evaluation copies it character by character, since the aliasing
+/// checks of std::string::append are not constant expressions for pointers
+/// into another static object when sanitizers instrument them
+constexpr void append_static(std::string& out, std::string_view text) {
+    if consteval {
+        for (char c : text) {
+            out += c;
+        }
+    } else {
+        out += text;
+    }
+}
+
+/// Append a quoted SQL identifier (table or column name) to out
+/// Embedded double quotes are escaped by doubling them
+constexpr void append_identifier(std::string& out, std::string_view identifier) {
+    out += '"';
+    for (char c : identifier) {
+        out += c;
+        if (c == '"') {
+            out += '"';
+        }
+    }
+    out += '"';
+}
+
 /// Quote a SQL identifier (table or column name)
-inline std::string quote_identifier(std::string_view identifier) {
-    return "\"" + std::string(identifier) + "\"";
+constexpr std::string quote_identifier(std::string_view identifier) {
+    std::string result;
+    result.reserve(identifier.size() + 2);
+    append_identifier(result, identifier);
+    return result;
 }
 
-/// Escape and quote a string value for SQL
-inline std::string quote_string(std::string_view value) {
-    std::string result = "'";
-    for (char c : value) {
-        if (c == '\'') {
-            result += "''"; // SQL escape for single quote
-        } else {
-            result += c;
+/// Append value to out with every single quote doubled
+/// Clean spans between quotes are found with memchr and copied in bulk
+inline void append_escaped(std::string& out, std::string_view value) {
+    const char* begin = value.data();
+    const char* const end = begin + value.size();
+    while (begin != end) {
+        const auto* quote = static_cast<const char*>(std::memchr(begin, '\'', static_cast<size_t>(end - begin)));
+        if (!quote) {
+            break;
+        }
+        out.append(begin, quote + 1);
+        out += '\''; // SQL escape for single quote
+        begin = quote + 1;
+    }
+    out.append(begin, end);
+}
+
+/// Append an escaped and quoted string value to out
+/// SQLite stops reading SQL text at a NUL byte, so embedded NULs are
+/// spliced in with char(0): ('a' || char(0) || 'b') is the same TEXT value
+/// a bound std::string would store
+inline void append_string_literal(std::string& out, std::string_view value) {
+    size_t nul = value.find('\0');
+    if (nul == std::string_view::npos) [[likely]] {
+        out.reserve(out.size() + value.size() + 2);
+        out += '\'';
+        append_escaped(out, value);
+        out += '\'';
+        return;
+    }
+
+    out += '(';
+    for (size_t start = 0;; start = nul + 1, nul = value.find('\0', start)) {
+        out += '\'';
+        append_escaped(out, value.substr(start, nul == std::string_view::npos ? nul : nul - start));
+        out += '\'';
+        if (nul == std::string_view::npos) {
+            break;
         }
+        out += " || char(0) || ";
     }
-    result += "'";
+    out += ')';
+}
+
+/// Escape and quote a string value for SQL
+inline std::string quote_string(std::string_view value) {
+    std::string result;
+    append_string_literal(result, value);
     return result;
 }
 
+// ============================================================================
+// STATIC SQL
+// ============================================================================
+
+/// Decimal digits of an unsigned integer (std::to_string is not constexpr)
+constexpr std::string to_decimal(size_t value) {
+    std::string digits;
+    do {
+        digits.insert(digits.begin(), static_cast<char>('0' + value % 10));
+        value /= 10;
+    } while (value > 0);
+    return digits;
+}
+
+/// NUL-terminated string of N characters held in static storage
+template <size_t N>
+struct StaticString {
+    std::array<char, N + 1> chars{};
+
+    constexpr std::string_view view() const { return {chars.data(), N}; }
+};
+
+/// The string returned by Build(), computed at compile time
+/// Build is a constexpr callable (function pointer or captureless lambda)
+/// building a std::string; SQL whose text only depends on types is built
+/// once by the compiler instead of on every to_sql() call.
+template <auto Build>
+inline constexpr auto static_string = [] {
+    StaticString<Build().size()> result;
+    const std::string text = Build();
+    std::copy(text.begin(), text.end(), result.chars.begin());
+    return result;
+}();
+
+/// A quoted SQL identifier, built at compile time
+template <glz::string_literal Name>
+inline constexpr std::string_view quoted_identifier =
+    static_string<[] { return quote_identifier(Name.sv()); }>.view();
+
+/// A quoted column reference ("alias"."name" or "name"), built at compile time
+template <glz::string_literal Name, glz::string_literal Alias>
+inline constexpr std::string_view quoted_column = static_string<[] {
+    std::string sql;
+    if (!Alias.sv().empty()) {
+        append_identifier(sql, Alias.sv());
+        sql += '.';
+    }
+    append_identifier(sql, Name.sv());
+    return sql;
+}>.view();
+
 // ============================================================================
 // TYPE MAPPING
 // ============================================================================
@@ -171,6 +293,9 @@ struct Col {
     static constexpr std::string_view name = Name.sv();
     static constexpr std::string_view alias = Alias.sv();
 
+    /// Quoted column reference, qualified by the alias if there is one
+    static constexpr std::string_view quoted = quoted_column<Name, Alias>;
+
     constexpr Col() = default;
 
     constexpr bool has_alias() const noexcept {
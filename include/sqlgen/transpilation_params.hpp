@@ -0,0 +1,561 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "core.hpp"
+#include "query_clauses.hpp"
+#include "transpilation_sql_gen.hpp"
+
+namespace sqlgen::transpilation {
+
+// ============================================================================
+// PARAMETERIZED SQL
+// ============================================================================
+//
+// Parameterized emission works in two passes over the same expression tree:
+//   - parameterize() rebuilds the tree with every literal replaced by a
+//     Param<T> node that renders as a numbered placeholder (?1, ?2, ...)
+//   - bound_values() collects the literals into a typed tuple
+// Both passes visit children in the same (tree) order, so element I of the
+// tuple always binds to placeholder ?(I + 1), regardless of the order in
+// which to_sql() happens to emit the operands.
+
+/// A bound parameter, rendered as a numbered placeholder
+template <class T>
+struct Param {
+    using value_type = T;
+
+    size_t index;  // 1-based, matches the SQLite ?NNN parameter number
+};
+
+/// Parameterized LIMIT / OFFSET (both always bound)
+struct LimitParams {
+    size_t limit_index;
+    size_t offset_index;
+};
+
+/// SQL text with placeholders and the values to bind to them
+template <class Params>
+struct ParameterizedSql {
+    std::string sql;
+    Params params;
+};
+
+/// Literal types that are bound as parameters
+template <class T>
+inline constexpr bool is_literal_v =
+    std::is_arithmetic_v<std::remove_cvref_t<T>> ||
+    std::is_same_v<std::remove_cvref_t<T>, std::string> ||
+    std::is_same_v<std::remove_cvref_t<T>, const char*> ||
+    std::is_same_v<std::remove_cvref_t<T>, char*>;
+
+/// Type a literal is stored as in the bound-value tuple
+template <class T>
+using param_type_t = std::conditional_t<
+    std::is_same_v<std::remove_cvref_t<T>, const char*> ||
+        std::is_same_v<std::remove_cvref_t<T>, char*>,
+    std::string, std::remove_cvref_t<T>>;
+
+/// Emit a placeholder
+template <class T>
+void emit(std::string& out, const Param<T>& param) {
+    out += '?';
+    emit(out, param.index);
+}
+
+template <class T>
+inline constexpr size_t sql_size_v<Param<T>> = 21;
+
+/// Emit parameterized LIMIT SQL
+inline void emit_limit(std::string& out, const LimitParams& limit) {
+    out += "LIMIT ?";
+    emit(out, limit.limit_index);
+    out += " OFFSET ?";
+    emit(out, limit.offset_index);
+}
+
+/// Generate parameterized LIMIT SQL
+inline std::string limit_sql(const LimitParams& limit) {
+    std::string result;
+    emit_limit(result, limit);
+    return result;
+}
+
+template <class... ColTypes>
+inline constexpr size_t sql_size_v<::sqlgen::GroupBy<ColTypes...>> = sql_size_v<std::tuple<ColTypes...>>;
+
+template <class... ColTypes>
+inline constexpr size_t sql_size_v<::sqlgen::OrderBy<ColTypes...>> = sql_size_v<std::tuple<ColTypes...>>;
+
+template <>
+inline constexpr size_t sql_size_v<::sqlgen::Limit> = 48;
+
+template <>
+inline constexpr size_t sql_size_v<LimitParams> = 50;
+
+/// Size hint of a builder's RETURNING clause, including its separator
+template <class TableType, class ReturningType>
+inline constexpr size_t returning_clause_size = 0;
+
+template <class TableType, class... ColTypes>
+inline constexpr size_t returning_clause_size<TableType, ::sqlgen::Returning<ColTypes...>> =
+    1 + returning_sql_size<TableType, ColTypes...>;
+
+/// Size hint of an optional builder clause: its separator and keyword plus
+/// the node, or nothing when the clause is absent
+template <class T>
+constexpr size_t clause_sql_size(size_t keyword_size) {
+    return std::is_same_v<T, Nothing> ? 0 : keyword_size + sql_size_v<T>;
+}
+
+// Forward declarations (the overloads below recurse into each other)
+inline Nothing parameterize(const Nothing& nothing, size_t& next);
+template <class T> requires is_literal_v<T>
+Param<param_type_t<T>> parameterize(const T& value, size_t& next);
+template <glz::string_literal Name, glz::string_literal Alias>
+Col<Name, Alias> parameterize(const Col<Name, Alias>& col, size_t& next);
+template <glz::string_literal Name, glz::string_literal Alias>
+::sqlgen::Col<Name, Alias> parameterize(const ::sqlgen::Col<Name, Alias>& col, size_t& next);
+template <class T>
+auto parameterize(const Value<T>& value, size_t& next);
+template <Operator Op, class Operand1, class Operand2>
+auto parameterize(const Operation<Op, Operand1, Operand2>& operation, size_t& next);
+template <class Left, Operator Op, class Right>
+auto parameterize(const Condition<Left, Op, Right>& condition, size_t& next);
+template <class T>
+auto parameterize(const ConditionWrapper<T>& wrapper, size_t& next);
+template <class C>
+auto parameterize(const Desc<C>& desc, size_t& next);
+template <class C, class V>
+auto parameterize(const Set<C, V>& set, size_t& next);
+template <AggregateType Type, class ExprType>
+auto parameterize(const Aggregate<Type, ExprType>& agg, size_t& next);
+template <FunctionType Type, class... ArgTypes>
+auto parameterize(const Function<Type, ArgTypes...>& func, size_t& next);
+template <class TargetType, class ExprType>
+auto parameterize(const CastFunction<TargetType, ExprType>& func, size_t& next);
+template <class ColType>
+auto parameterize(const ::sqlgen::advanced::IsNullCondition<ColType>& cond, size_t& next);
+template <class ColType>
+auto parameterize(const ::sqlgen::advanced::IsNotNullCondition<ColType>& cond, size_t& next);
+template <class ColType, class... ValueTypes>
+auto parameterize(const ::sqlgen::advanced::InCondition<ColType, ValueTypes...>& cond, size_t& next);
+template <class ColType, class... ValueTypes>
+auto parameterize(const ::sqlgen::advanced::NotInCondition<ColType, ValueTypes...>& cond, size_t& next);
+template <class ColType, class LowerType, class UpperType>
+auto parameterize(const ::sqlgen::advanced::BetweenCondition<ColType, LowerType, UpperType>& cond, size_t& next);
+template <class ColType, class LowerType, class UpperType>
+auto parameterize(const ::sqlgen::advanced::NotBetweenCondition<ColType, LowerType, UpperType>& cond, size_t& next);
+template <JoinType Type, class TableType, glz::string_literal Alias, class ConditionType>
+auto parameterize(const Join<Type, TableType, Alias, ConditionType>& join, size_t& next);
+template <class... Joins>
+auto parameterize(const JoinList<Joins...>& join_list, size_t& next);
+template <class... Ts>
+auto parameterize(const std::tuple<Ts...>& nodes, size_t& next);
+template <class... ColTypes>
+auto parameterize(const ::sqlgen::GroupBy<ColTypes...>& group_by, size_t& next);
+template <class... ColTypes>
+auto parameterize(const ::sqlgen::OrderBy<ColTypes...>& order_by, size_t& next);
+template <class... ColTypes>
+auto parameterize(const ::sqlgen::Returning<ColTypes...>& returning, size_t& next);
+inline LimitParams parameterize(const ::sqlgen::Limit& limit, size_t& next);
+
+inline std::tuple<> bound_values(const Nothing& nothing);
+template <class T> requires is_literal_v<T>
+std::tuple<param_type_t<T>> bound_values(const T& value);
+template <glz::string_literal Name, glz::string_literal Alias>
+std::tuple<> bound_values(const Col<Name, Alias>& col);
+template <glz::string_literal Name, glz::string_literal Alias>
+std::tuple<> bound_values(const ::sqlgen::Col<Name, Alias>& col);
+template <class T>
+auto bound_values(const Value<T>& value);
+template <Operator Op, class Operand1, class Operand2>
+auto bound_values(const Operation<Op, Operand1, Operand2>& operation);
+template <class Left, Operator Op, class Right>
+auto bound_values(const Condition<Left, Op, Right>& condition);
+template <class T>
+auto bound_values(const ConditionWrapper<T>& wrapper);
+template <class C>
+auto bound_values(const Desc<C>& desc);
+template <class C, class V>
+auto bound_values(const Set<C, V>& set);
+template <AggregateType Type, class ExprType>
+auto bound_values(const Aggregate<Type, ExprType>& agg);
+template <FunctionType Type, class... ArgTypes>
+auto bound_values(const Function<Type, ArgTypes...>& func);
+template <class TargetType, class ExprType>
+auto bound_values(const CastFunction<TargetType, ExprType>& func);
+template <class ColType>
+auto bound_values(const ::sqlgen::advanced::IsNullCondition<ColType>& cond);
+template <class ColType>
+auto bound_values(const ::sqlgen::advanced::IsNotNullCondition<ColType>& cond);
+template <class ColType, class... ValueTypes>
+auto bound_values(const ::sqlgen::advanced::InCondition<ColType, ValueTypes...>& cond);
+template <class ColType, class... ValueTypes>
+auto bound_values(const ::sqlgen::advanced::NotInCondition<ColType, ValueTypes...>& cond);
+template <class ColType, class LowerType, class UpperType>
+auto bound_values(const ::sqlgen::advanced::BetweenCondition<ColType, LowerType, UpperType>& cond);
+template <class ColType, class LowerType, class UpperType>
+auto bound_values(const ::sqlgen::advanced::NotBetweenCondition<ColType, LowerType, UpperType>& cond);
+template <JoinType Type, class TableType, glz::string_literal Alias, class ConditionType>
+auto bound_values(const Join<Type, TableType, Alias, ConditionType>& join);
+template <class... Joins>
+auto bound_values(const JoinList<Joins...>& join_list);
+template <class... Ts>
+auto bound_values(const std::tuple<Ts...>& nodes);
+template <class... ColTypes>
+auto bound_values(const ::sqlgen::GroupBy<ColTypes...>& group_by);
+template <class... ColTypes>
+auto bound_values(const ::sqlgen::OrderBy<ColTypes...>& order_by);
+template <class... ColTypes>
+auto bound_values(const ::sqlgen::Returning<ColTypes...>& returning);
+inline std::tuple<int64_t, int64_t> bound_values(const ::sqlgen::Limit& limit);
+
+// ----------------------------------------------------------------------------
+// Leaves
+// ----------------------------------------------------------------------------
+
+inline Nothing parameterize(const Nothing& nothing, size_t& /*next*/) {
+    return nothing;
+}
+
+inline std::tuple<> bound_values(const Nothing& /*nothing*/) {
+    return {};
+}
+
+template <class T> requires is_literal_v<T>
+Param<param_type_t<T>> parameterize(const T& /*value*/, size_t& next) {
+    return Param<param_type_t<T>>{next++};
+}
+
+template <class T> requires is_literal_v<T>
+std::tuple<param_type_t<T>> bound_values(const T& value) {
+    return std::tuple<param_type_t<T>>{param_type_t<T>(value)};
+}
+
+template <glz::string_literal Name, glz::string_literal Alias>
+Col<Name, Alias> parameterize(const Col<Name, Alias>& col, size_t& /*next*/) {
+    return col;
+}
+
+template <glz::string_literal Name, glz::string_literal Alias>
+std::tuple<> bound_values(const Col<Name, Alias>& /*col*/) {
+    return {};
+}
+
+template <glz::string_literal Name, glz::string_literal Alias>
+::sqlgen::Col<Name, Alias> parameterize(const ::sqlgen::Col<Name, Alias>& col, size_t& /*next*/) {
+    return col;
+}
+
+template <glz::string_literal Name, glz::string_literal Alias>
+std::tuple<> bound_values(const ::sqlgen::Col<Name, Alias>& /*col*/) {
+    return {};
+}
+
+/// Literal values become placeholders, wrapped expressions are rewritten in place
+template <class T>
+auto parameterize(const Value<T>& value, size_t& next) {
+    return parameterize(value.get(), next);
+}
+
+template <class T>
+auto bound_values(const Value<T>& value) {
+    return bound_values(value.get());
+}
+
+// ----------------------------------------------------------------------------
+// Expressions and conditions
+// ----------------------------------------------------------------------------
+
+template <Operator Op, class Operand1, class Operand2>
+auto parameterize(const Operation<Op, Operand1, Operand2>& operation, size_t& next) {
+    auto op1 = parameterize(operation.operand1, next);
+    auto op2 = parameterize(operation.operand2, next);
+    return make_operation<Op>(std::move(op1), std::move(op2));
+}
+
+template <Operator Op, class Operand1, class Operand2>
+auto bound_values(const Operation<Op, Operand1, Operand2>& operation) {
+    return std::tuple_cat(bound_values(operation.operand1), bound_values(operation.operand2));
+}
+
+template <class Left, Operator Op, class Right>
+auto parameterize(const Condition<Left, Op, Right>& condition, size_t& next) {
+    auto left = parameterize(condition.left, next);
+    auto right = parameterize(condition.right, next);
+    return make_condition<Op>(std::move(left), std::move(right));
+}
+
+template <class Left, Operator Op, class Right>
+auto bound_values(const Condition<Left, Op, Right>& condition) {
+    return std::tuple_cat(bound_values(condition.left), bound_values(condition.right));
+}
+
+template <class T>
+auto parameterize(const ConditionWrapper<T>& wrapper, size_t& next) {
+    return make_condition_wrapper(parameterize(wrapper.condition, next));
+}
+
+template <class T>
+auto bound_values(const ConditionWrapper<T>& wrapper) {
+    return bound_values(wrapper.condition);
+}
+
+template <class C>
+auto parameterize(const Desc<C>& desc, size_t& next) {
+    return make_desc(parameterize(desc.column, next));
+}
+
+template <class C>
+auto bound_values(const Desc<C>& desc) {
+    return bound_values(desc.column);
+}
+
+template <class C, class V>
+auto parameterize(const Set<C, V>& set, size_t& next) {
+    auto column = parameterize(set.column, next);
+    auto value = parameterize(set.value, next);
+    return make_set(std::move(column), std::move(value));
+}
+
+template <class C, class V>
+auto bound_values(const Set<C, V>& set) {
+    return std::tuple_cat(bound_values(set.column), bound_values(set.value));
+}
+
+template <AggregateType Type, class ExprType>
+auto parameterize(const Aggregate<Type, ExprType>& agg, size_t& next) {
+    if constexpr (std::is_same_v<ExprType, CountStar>) {
+        return agg;
+    } else {
+        auto expr = parameterize(agg.expression, next);
+        return Aggregate<Type, decltype(expr)>{std::move(expr)};
+    }
+}
+
+template <AggregateType Type, class ExprType>
+auto bound_values(const Aggregate<Type, ExprType>& agg) {
+    if constexpr (std::is_same_v<ExprType, CountStar>) {
+        return std::tuple<>{};
+    } else {
+        return bound_values(agg.expression);
+    }
+}
+
+template <FunctionType Type, class... ArgTypes>
+auto parameterize(const Function<Type, ArgTypes...>& func, size_t& next) {
+    return std::apply([&](const auto&... args) {
+        // Braced initialization sequences the calls left to right
+        using ArgsTuple = std::tuple<decltype(parameterize(args, next))...>;
+        ArgsTuple new_args{parameterize(args, next)...};
+        return std::apply([](auto&&... new_arg) {
+            return Function<Type, std::remove_cvref_t<decltype(new_arg)>...>{new_arg...};
+        }, std::move(new_args));
+    }, func.arguments);
+}
+
+template <FunctionType Type, class... ArgTypes>
+auto bound_values(const Function<Type, ArgTypes...>& func) {
+    return bound_values(func.arguments);
+}
+
+template <class TargetType, class ExprType>
+auto parameterize(const CastFunction<TargetType, ExprType>& func, size_t& next) {
+    auto expr = parameterize(func.expression, next);
+    return CastFunction<TargetType, decltype(expr)>{std::move(expr)};
+}
+
+template <class TargetType, class ExprType>
+auto bound_values(const CastFunction<TargetType, ExprType>& func) {
+    return bound_values(func.expression);
+}
+
+// ----------------------------------------------------------------------------
+// Advanced conditions
+// ----------------------------------------------------------------------------
+
+template <class ColType>
+auto parameterize(const ::sqlgen::advanced::IsNullCondition<ColType>& cond, size_t& next) {
+    auto column = parameterize(cond.column, next);
+    return ::sqlgen::advanced::IsNullCondition<decltype(column)>{column};
+}
+
+template <class ColType>
+auto bound_values(const ::sqlgen::advanced::IsNullCondition<ColType>& cond) {
+    return bound_values(cond.column);
+}
+
+template <class ColType>
+auto parameterize(const ::sqlgen::advanced::IsNotNullCondition<ColType>& cond, size_t& next) {
+    auto column = parameterize(cond.column, next);
+    return ::sqlgen::advanced::IsNotNullCondition<decltype(column)>{column};
+}
+
+template <class ColType>
+auto bound_values(const ::sqlgen::advanced::IsNotNullCondition<ColType>& cond) {
+    return bound_values(cond.column);
+}
+
+template <class ColType, class... ValueTypes>
+auto parameterize(const ::sqlgen::advanced::InCondition<ColType, ValueTypes...>& cond, size_t& next) {
+    auto column = parameterize(cond.column, next);
+    auto values = parameterize(cond.values, next);
+    return std::apply([&](const auto&... vals) {
+        return ::sqlgen::advanced::InCondition<decltype(column), std::remove_cvref_t<decltype(vals)>...>{
+            column, vals...};
+    }, values);
+}
+
+template <class ColType, class... ValueTypes>
+auto bound_values(const ::sqlgen::advanced::InCondition<ColType, ValueTypes...>& cond) {
+    return std::tuple_cat(bound_values(cond.column), bound_values(cond.values));
+}
+
+template <class ColType, class... ValueTypes>
+auto parameterize(const ::sqlgen::advanced::NotInCondition<ColType, ValueTypes...>& cond, size_t& next) {
+    auto column = parameterize(cond.column, next);
+    auto values = parameterize(cond.values, next);
+    return std::apply([&](const auto&... vals) {
+        return ::sqlgen::advanced::NotInCondition<decltype(column), std::remove_cvref_t<decltype(vals)>...>{
+            column, vals...};
+    }, values);
+}
+
+template <class ColType, class... ValueTypes>
+auto bound_values(const ::sqlgen::advanced::NotInCondition<ColType, ValueTypes...>& cond) {
+    return std::tuple_cat(bound_values(cond.column), bound_values(cond.values));
+}
+
+template <class ColType, class LowerType, class UpperType>
+auto parameterize(const ::sqlgen::advanced::BetweenCondition<ColType, LowerType, UpperType>& cond, size_t& next) {
+    auto column = parameterize(cond.column, next);
+    auto lower = parameterize(cond.lower, next);
+    auto upper = parameterize(cond.upper, next);
+    return ::sqlgen::advanced::BetweenCondition<decltype(column), decltype(lower), decltype(upper)>{
+        column, lower, upper};
+}
+
+template <class ColType, class LowerType, class UpperType>
+auto bound_values(const ::sqlgen::advanced::BetweenCondition<ColType, LowerType, UpperType>& cond) {
+    return std::tuple_cat(bound_values(cond.column), bound_values(cond.lower), bound_values(cond.upper));
+}
+
+template <class ColType, class LowerType, class UpperType>
+auto parameterize(const ::sqlgen::advanced::NotBetweenCondition<ColType, LowerType, UpperType>& cond, size_t& next) {
+    auto column = parameterize(cond.column, next);
+    auto lower = parameterize(cond.lower, next);
+    auto upper = parameterize(cond.upper, next);
+    return ::sqlgen::advanced::NotBetweenCondition<decltype(column), decltype(lower), decltype(upper)>{
+        column, lower, upper};
+}
+
+template <class ColType, class LowerType, class UpperType>
+auto bound_values(const ::sqlgen::advanced::NotBetweenCondition<ColType, LowerType, UpperType>& cond) {
+    return std::tuple_cat(bound_values(cond.column), bound_values(cond.lower), bound_values(cond.upper));
+}
+
+// ----------------------------------------------------------------------------
+// Clauses
+// ----------------------------------------------------------------------------
+
+template <JoinType Type, class TableType, glz::string_literal Alias, class ConditionType>
+auto parameterize(const Join<Type, TableType, Alias, ConditionType>& join, size_t& next) {
+    if constexpr (std::is_same_v<ConditionType, Nothing>) {
+        return join;
+    } else {
+        auto condition = parameterize(join.condition, next);
+        return Join<Type, TableType, Alias, decltype(condition)>{condition};
+    }
+}
+
+template <JoinType Type, class TableType, glz::string_literal Alias, class ConditionType>
+auto bound_values(const Join<Type, TableType, Alias, ConditionType>& join) {
+    return bound_values(join.condition);
+}
+
+template <class... Joins>
+auto parameterize(const JoinList<Joins...>& join_list, size_t& next) {
+    auto joins = parameterize(join_list.joins, next);
+    return std::apply([](const auto&... js) {
+        return JoinList<std::remove_cvref_t<decltype(js)>...>{js...};
+    }, joins);
+}
+
+template <class... Joins>
+auto bound_values(const JoinList<Joins...>& join_list) {
+    return bound_values(join_list.joins);
+}
+
+/// Tuples of nodes (select fields, SET clauses, function arguments, ...)
+template <class... Ts>
+auto parameterize(const std::tuple<Ts...>& nodes, size_t& next) {
+    return std::apply([&](const auto&... node) {
+        // Braced initialization sequences the calls left to right
+        return std::tuple<decltype(parameterize(node, next))...>{parameterize(node, next)...};
+    }, nodes);
+}
+
+template <class... Ts>
+auto bound_values(const std::tuple<Ts...>& nodes) {
+    return std::apply([](const auto&... node) {
+        return std::tuple_cat(bound_values(node)...);
+    }, nodes);
+}
+
+template <class... ColTypes>
+auto parameterize(const ::sqlgen::GroupBy<ColTypes...>& group_by, size_t& next) {
+    auto columns = parameterize(group_by.columns, next);
+    return std::apply([](const auto&... cols) {
+        return ::sqlgen::GroupBy<std::remove_cvref_t<decltype(cols)>...>{cols...};
+    }, columns);
+}
+
+template <class... ColTypes>
+auto bound_values(const ::sqlgen::GroupBy<ColTypes...>& group_by) {
+    return bound_values(group_by.columns);
+}
+
+template <class... ColTypes>
+auto parameterize(const ::sqlgen::OrderBy<ColTypes...>& order_by, size_t& next) {
+    auto columns = parameterize(order_by.columns, next);
+    return std::apply([](const auto&... cols) {
+        return ::sqlgen::OrderBy<std::remove_cvref_t<decltype(cols)>...>{.columns = std::make_tuple(cols...)};
+    }, columns);
+}
+
+template <class... ColTypes>
+auto bound_values(const ::sqlgen::OrderBy<ColTypes...>& order_by) {
+    return bound_values(order_by.columns);
+}
+
+template <class... ColTypes>
+auto parameterize(const ::sqlgen::Returning<ColTypes...>& returning, size_t& next) {
+    auto columns = parameterize(returning.columns, next);
+    return std::apply([](const auto&... cols) {
+        return ::sqlgen::Returning<std::remove_cvref_t<decltype(cols)>...>{.columns = std::make_tuple(cols...)};
+    }, columns);
+}
+
+template <class... ColTypes>
+auto bound_values(const ::sqlgen::Returning<ColTypes...>& returning) {
+    return bound_values(returning.columns);
+}
+
+/// LIMIT and OFFSET are always both bound so the SQL text does not depend
+/// on whether an offset was given (a missing offset binds 0)
+inline LimitParams parameterize(const ::sqlgen::Limit& /*limit*/, size_t& next) {
+    LimitParams params{.limit_index = next, .offset_index = next + 1};
+    next += 2;
+    return params;
+}
+
+inline std::tuple<int64_t, int64_t> bound_values(const ::sqlgen::Limit& limit) {
+    return {static_cast<int64_t>(limit.limit_value),
+            static_cast<int64_t>(limit.offset_value.value_or(0))};
+}
+
+} // namespace sqlgen::transpilation
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
 #include "transpilation_advanced.hpp"
 #include "advanced_conditions.hpp"
 
@@ -9,6 +12,16 @@ template <glz::string_literal Name, glz::string_literal Alias>
 struct Col;
 }
 
+// Forward declarations for advanced condition types
+namespace sqlgen::advanced {
+    template <class ColType> struct IsNullCondition;
+    template <class ColType> struct IsNotNullCondition;
+    template <class ColType, class... ValueTypes> struct InCondition;
+    template <class ColType, class... ValueTypes> struct NotInCondition;
+    template <class ColType, class LowerType, class UpperType> struct BetweenCondition;
+    template <class ColType, class LowerType, class UpperType> struct NotBetweenCondition;
+}
+
 namespace sqlgen::transpilation {
 
 // ============================================================================
@@ -45,201 +58,313 @@ constexpr std::string_view operator_to_sql(Operator op) {
     }
 }
 
-/// Forward declarations for recursive calls
+// ============================================================================
+// SIZE HINTS
+// ============================================================================
+//
+// sql_size_v<Node> is known at compile time and bounds the text a node emits:
+// exact for keywords, identifiers and punctuation, and the usual width for
+// numbers. Only the characters of string values are left out, so builders
+// can reserve() once and emit the whole statement without reallocating in
+// the common case.
+
+/// Size hint for a literal of type T
 template <class T>
-std::string to_sql(const T& value);
-
-/// Convert a transpilation column to SQL
-template <glz::string_literal Name, glz::string_literal Alias>
-std::string to_sql(const Col<Name, Alias>& col) {
-    if (col.has_alias()) {
-        return quote_identifier(std::string(col.alias)) + "." +
-               quote_identifier(std::string(col.name));
+consteval size_t literal_sql_size() {
+    using Type = std::remove_cvref_t<T>;
+    if constexpr (std::is_same_v<Type, bool>) {
+        return 1;
+    } else if constexpr (std::is_integral_v<Type>) {
+        return 20;
+    } else if constexpr (std::is_floating_point_v<Type>) {
+        return 24;
+    } else if constexpr (std::is_same_v<Type, std::string> || std::is_same_v<Type, const char*>) {
+        return 2;
+    } else {
+        return 0;
     }
-    return quote_identifier(std::string(col.name));
-}
-
-// Overload for user-facing Col - must be declared before Set to_sql
-template <glz::string_literal Name, glz::string_literal Alias>
-inline std::string to_sql(const sqlgen::Col<Name, Alias>& col) {
-    // Use conversion operator to get transpilation::Col
-    typename sqlgen::Col<Name, Alias>::ColType tcol = col;
-    return to_sql(tcol);
 }
 
-/// Forward declaration for Col and Operation type checking
-template <glz::string_literal, glz::string_literal>
-struct Col;
-
-template <Operator, class, class>
-struct Operation;
+/// Compile-time size hint of the SQL emitted for a node
+template <class T>
+inline constexpr size_t sql_size_v = literal_sql_size<T>();
 
-/// Overloads for primitive types (when not wrapped in Value)
-inline std::string to_sql(int value) {
-    return std::to_string(value);
-}
+template <size_t N>
+inline constexpr size_t sql_size_v<char[N]> = N + 1;
 
-inline std::string to_sql(int64_t value) {
-    return std::to_string(value);
-}
+template <class T>
+inline constexpr size_t sql_size_v<Value<T>> = sql_size_v<T>;
 
-inline std::string to_sql(uint32_t value) {
-    return std::to_string(value);
-}
+template <glz::string_literal Name, glz::string_literal Alias>
+inline constexpr size_t sql_size_v<Col<Name, Alias>> = Col<Name, Alias>::quoted.size();
 
-inline std::string to_sql(uint64_t value) {
-    return std::to_string(value);
-}
+template <glz::string_literal Name, glz::string_literal Alias>
+inline constexpr size_t sql_size_v<::sqlgen::Col<Name, Alias>> = sql_size_v<Col<Name, Alias>>;
 
-inline std::string to_sql(double value) {
-    std::string str = std::to_string(value);
-    // Remove trailing zeros after decimal point
-    if (str.find('.') != std::string::npos) {
-        str.erase(str.find_last_not_of('0') + 1, std::string::npos);
-        // Remove trailing decimal point if no fractional part
-        if (str.back() == '.') {
-            str.pop_back();
-        }
-    }
-    return str;
-}
+template <Operator Op, class Operand1, class Operand2>
+inline constexpr size_t sql_size_v<Operation<Op, Operand1, Operand2>> =
+    2 + operator_to_sql(Op).size() + sql_size_v<Operand1> + sql_size_v<Operand2>;
 
-inline std::string to_sql(float value) {
-    return to_sql(static_cast<double>(value));
-}
+template <class Left, Operator Op, class Right>
+inline constexpr size_t sql_size_v<Condition<Left, Op, Right>> =
+    4 + operator_to_sql(Op).size() + sql_size_v<Left> + sql_size_v<Right>;
 
-inline std::string to_sql(bool value) {
-    return value ? "1" : "0";
-}
+template <class T>
+inline constexpr size_t sql_size_v<ConditionWrapper<T>> = sql_size_v<T>;
 
-inline std::string to_sql(const std::string& value) {
-    return quote_string(value);
-}
+template <class C>
+inline constexpr size_t sql_size_v<Desc<C>> = sql_size_v<C> + 5;
 
-inline std::string to_sql(const char* value) {
-    return quote_string(std::string(value));
-}
+template <class C, class V>
+inline constexpr size_t sql_size_v<Set<C, V>> = sql_size_v<C> + 3 + sql_size_v<V>;
 
-/// Convert a value to SQL
-template <class T>
-std::string to_sql(const Value<T>& value) {
-    if constexpr (std::is_same_v<T, std::string>) {
-        return quote_string(value.get());
-    } else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, int64_t> ||
-                         std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t> ||
-                         std::is_same_v<T, double> || std::is_same_v<T, float> ||
-                         std::is_same_v<T, bool>) {
-        // Use the standalone to_sql functions for proper formatting
-        return to_sql(value.get());
-    } else {
-        // For Col, Operation, and other transpilation types, recursively call to_sql
-        return to_sql(value.get());
-    }
-}
+template <>
+inline constexpr size_t sql_size_v<CountStar> = 1;
 
-/// Convert an operation to SQL
-template <Operator Op, class Operand1, class Operand2>
-std::string to_sql(const Operation<Op, Operand1, Operand2>& operation) {
-    std::string result = "(";
-    result += to_sql(operation.operand1);
-    result += operator_to_sql(Op);
-    result += to_sql(operation.operand2);
-    result += ")";
-    return result;
-}
+template <AggregateType Type, class ExprType>
+inline constexpr size_t sql_size_v<Aggregate<Type, ExprType>> =
+    aggregate_type_to_sql(Type).size() + 11 + sql_size_v<ExprType>;
 
-} // namespace sqlgen::transpilation
+/// Size hint of a comma separated list
+template <class... Ts>
+inline constexpr size_t sql_size_v<std::tuple<Ts...>> = ((sql_size_v<Ts> + 2) + ... + 0);
 
-// Forward declarations for advanced condition types
-namespace sqlgen::advanced {
-    template <class ColType> struct IsNullCondition;
-    template <class ColType> struct IsNotNullCondition;
-    template <class ColType, class... ValueTypes> struct InCondition;
-    template <class ColType, class... ValueTypes> struct NotInCondition;
-    template <class ColType, class LowerType, class UpperType> struct BetweenCondition;
-    template <class ColType, class LowerType, class UpperType> struct NotBetweenCondition;
-}
+template <FunctionType Type, class... ArgTypes>
+inline constexpr size_t sql_size_v<Function<Type, ArgTypes...>> =
+    function_type_to_sql(Type).size() + 33 + sql_size_v<std::tuple<ArgTypes...>>;
 
-namespace sqlgen::transpilation {
+template <class TargetType, class ExprType>
+inline constexpr size_t sql_size_v<CastFunction<TargetType, ExprType>> = 17 + sql_size_v<ExprType>;
 
-// Forward declarations for to_sql of advanced conditions
 template <class ColType>
-inline std::string to_sql(const ::sqlgen::advanced::IsNullCondition<ColType>& cond);
+inline constexpr size_t sql_size_v<::sqlgen::advanced::IsNullCondition<ColType>> = sql_size_v<ColType> + 8;
 
 template <class ColType>
-inline std::string to_sql(const ::sqlgen::advanced::IsNotNullCondition<ColType>& cond);
+inline constexpr size_t sql_size_v<::sqlgen::advanced::IsNotNullCondition<ColType>> = sql_size_v<ColType> + 12;
 
 template <class ColType, class... ValueTypes>
-inline std::string to_sql(const ::sqlgen::advanced::InCondition<ColType, ValueTypes...>& cond);
+inline constexpr size_t sql_size_v<::sqlgen::advanced::InCondition<ColType, ValueTypes...>> =
+    sql_size_v<ColType> + 6 + sql_size_v<std::tuple<ValueTypes...>>;
 
 template <class ColType, class... ValueTypes>
-inline std::string to_sql(const ::sqlgen::advanced::NotInCondition<ColType, ValueTypes...>& cond);
+inline constexpr size_t sql_size_v<::sqlgen::advanced::NotInCondition<ColType, ValueTypes...>> =
+    sql_size_v<ColType> + 10 + sql_size_v<std::tuple<ValueTypes...>>;
+
+template <class ColType, class LowerType, class UpperType>
+inline constexpr size_t sql_size_v<::sqlgen::advanced::BetweenCondition<ColType, LowerType, UpperType>> =
+    sql_size_v<ColType> + 14 + sql_size_v<LowerType> + sql_size_v<UpperType>;
 
 template <class ColType, class LowerType, class UpperType>
-inline std::string to_sql(const ::sqlgen::advanced::BetweenCondition<ColType, LowerType, UpperType>& cond);
+inline constexpr size_t sql_size_v<::sqlgen::advanced::NotBetweenCondition<ColType, LowerType, UpperType>> =
+    sql_size_v<ColType> + 18 + sql_size_v<LowerType> + sql_size_v<UpperType>;
+
+template <JoinType Type, class TableType, glz::string_literal Alias, class ConditionType>
+inline constexpr size_t sql_size_v<Join<Type, TableType, Alias, ConditionType>> =
+    join_type_to_sql(Type).size() + 1 + quoted_table_name<TableType>.size() +
+    (Alias.sv().empty() ? 0 : 4 + quoted_identifier<Alias>.size()) + 4 + sql_size_v<ConditionType>;
 
+template <class... Joins>
+inline constexpr size_t sql_size_v<JoinList<Joins...>> = ((sql_size_v<Joins> + 1) + ... + 0);
+
+// ============================================================================
+// EMIT
+// ============================================================================
+//
+// Every node appends its SQL to a caller-provided buffer, so rendering a
+// whole statement is a single pass with no temporaries. to_sql(node) is a
+// thin wrapper that reserves sql_size_v and emits into a fresh string.
+
+/// Forward declarations (the overloads below recurse into each other)
+template <glz::string_literal Name, glz::string_literal Alias>
+constexpr void emit(std::string& out, const Col<Name, Alias>& col);
+template <glz::string_literal Name, glz::string_literal Alias>
+constexpr void emit(std::string& out, const ::sqlgen::Col<Name, Alias>& col);
+template <class T> requires (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+void emit(std::string& out, T value);
+inline void emit(std::string& out, double value);
+inline void emit(std::string& out, float value);
+inline void emit(std::string& out, bool value);
+inline void emit(std::string& out, const std::string& value);
+inline void emit(std::string& out, const char* value);
+template <class T>
+void emit(std::string& out, const Value<T>& value);
+template <Operator Op, class Operand1, class Operand2>
+void emit(std::string& out, const Operation<Op, Operand1, Operand2>& operation);
+template <class Left, Operator Op, class Right>
+void emit(std::string& out, const Condition<Left, Op, Right>& condition);
+template <class T>
+void emit(std::string& out, const ConditionWrapper<T>& wrapper);
+template <class C>
+void emit(std::string& out, const Desc<C>& desc);
+template <class C, class V>
+void emit(std::string& out, const Set<C, V>& set);
+template <AggregateType Type, class ExprType>
+void emit(std::string& out, const Aggregate<Type, ExprType>& agg);
+template <FunctionType Type, class... ArgTypes>
+void emit(std::string& out, const Function<Type, ArgTypes...>& func);
+template <class TargetType, class ExprType>
+void emit(std::string& out, const CastFunction<TargetType, ExprType>& func);
+template <class ColType>
+void emit(std::string& out, const ::sqlgen::advanced::IsNullCondition<ColType>& cond);
+template <class ColType>
+void emit(std::string& out, const ::sqlgen::advanced::IsNotNullCondition<ColType>& cond);
+template <class ColType, class... ValueTypes>
+void emit(std::string& out, const ::sqlgen::advanced::InCondition<ColType, ValueTypes...>& cond);
+template <class ColType, class... ValueTypes>
+void emit(std::string& out, const ::sqlgen::advanced::NotInCondition<ColType, ValueTypes...>& cond);
+template <class ColType, class LowerType, class UpperType>
+void emit(std::string& out, const ::sqlgen::advanced::BetweenCondition<ColType, LowerType, UpperType>& cond);
 template <class ColType, class LowerType, class UpperType>
-inline std::string to_sql(const ::sqlgen::advanced::NotBetweenCondition<ColType, LowerType, UpperType>& cond);
+void emit(std::string& out, const ::sqlgen::advanced::NotBetweenCondition<ColType, LowerType, UpperType>& cond);
+template <class... Ts>
+void emit(std::string& out, const std::tuple<Ts...>& nodes);
+
+/// Render a node into a new string
+template <class T>
+std::string to_sql(const T& node) {
+    std::string out;
+    out.reserve(sql_size_v<T>);
+    emit(out, node);
+    return out;
+}
+
+/// Emit a column, qualified by its table alias if it has one
+template <glz::string_literal Name, glz::string_literal Alias>
+constexpr void emit(std::string& out, const Col<Name, Alias>& col) {
+    append_static(out, col.quoted);
+}
+
+template <glz::string_literal Name, glz::string_literal Alias>
+constexpr void emit(std::string& out, const ::sqlgen::Col<Name, Alias>& col) {
+    emit(out, typename ::sqlgen::Col<Name, Alias>::ColType(col));
+}
+
+/// Integers are written in place with std::to_chars
+template <class T> requires (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+void emit(std::string& out, T value) {
+    char buffer[24];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, end);
+}
+
+/// Floating point values are written with the shortest text that parses
+/// back to the same double (std::to_chars, independent of the locale)
+/// SQLite has no literal for NaN, which it stores as NULL, and reads
+/// out-of-range literals such as 9e999 as infinity. Negative zero is
+/// written as -0.0, since SQLite reads -0 as the integer 0.
+inline void emit(std::string& out, double value) {
+    if (std::isnan(value)) {
+        out += "NULL";
+    } else if (std::isinf(value)) {
+        out += value > 0 ? "9e999" : "-9e999";
+    } else if (value == 0 && std::signbit(value)) {
+        out += "-0.0";
+    } else {
+        char buffer[32];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, end);
+    }
+}
+
+/// Floats are written as the double they widen to, which is the value
+/// Statement::bind binds for them (0.1f is 0.10000000149011612)
+inline void emit(std::string& out, float value) {
+    emit(out, static_cast<double>(value));
+}
+
+inline void emit(std::string& out, bool value) {
+    out += value ? '1' : '0';
+}
+
+inline void emit(std::string& out, const std::string& value) {
+    append_string_literal(out, value);
+}
+
+inline void emit(std::string& out, const char* value) {
+    append_string_literal(out, value);
+}
 
+/// Emit a value: literals are formatted, wrapped expressions recurse
+template <class T>
+void emit(std::string& out, const Value<T>& value) {
+    emit(out, value.get());
+}
 
+/// Emit an arithmetic operation
+template <Operator Op, class Operand1, class Operand2>
+void emit(std::string& out, const Operation<Op, Operand1, Operand2>& operation) {
+    out += '(';
+    emit(out, operation.operand1);
+    out += operator_to_sql(Op);
+    emit(out, operation.operand2);
+    out += ')';
+}
+
+/// Emit a comma separated list of nodes
+template <class... Ts>
+void emit(std::string& out, const std::tuple<Ts...>& nodes) {
+    std::apply([&](const auto&... node) {
+        bool first = true;
+        (([&] {
+            if (!first) out += ", ";
+            emit(out, node);
+            first = false;
+        }()), ...);
+    }, nodes);
+}
+
+/// Emit IS NULL condition
 template <class ColType>
-inline std::string to_sql(const ::sqlgen::advanced::IsNullCondition<ColType>& cond) {
-    return to_sql(cond.column) + " IS NULL";
+void emit(std::string& out, const ::sqlgen::advanced::IsNullCondition<ColType>& cond) {
+    emit(out, cond.column);
+    out += " IS NULL";
 }
 
-/// Convert IS NOT NULL condition to SQL
+/// Emit IS NOT NULL condition
 template <class ColType>
-inline std::string to_sql(const ::sqlgen::advanced::IsNotNullCondition<ColType>& cond) {
-    return to_sql(cond.column) + " IS NOT NULL";
+void emit(std::string& out, const ::sqlgen::advanced::IsNotNullCondition<ColType>& cond) {
+    emit(out, cond.column);
+    out += " IS NOT NULL";
 }
 
-/// Convert IN condition to SQL
+/// Emit IN condition
 template <class ColType, class... ValueTypes>
-inline std::string to_sql(const ::sqlgen::advanced::InCondition<ColType, ValueTypes...>& cond) {
-    std::string sql = to_sql(cond.column) + " IN (";
-    bool first = true;
-    std::apply([&](const auto&... values) {
-        (([&](const auto& val) {
-            if (!first) sql += ", ";
-            sql += to_sql(Value{val});
-            first = false;
-        }(values)), ...);
-    }, cond.values);
-    sql += ")";
-    return sql;
+void emit(std::string& out, const ::sqlgen::advanced::InCondition<ColType, ValueTypes...>& cond) {
+    emit(out, cond.column);
+    out += " IN (";
+    emit(out, cond.values);
+    out += ')';
 }
 
-/// Convert NOT IN condition to SQL
+/// Emit NOT IN condition
 template <class ColType, class... ValueTypes>
-inline std::string to_sql(const ::sqlgen::advanced::NotInCondition<ColType, ValueTypes...>& cond) {
-    std::string sql = to_sql(cond.column) + " NOT IN (";
-    bool first = true;
-    std::apply([&](const auto&... values) {
-        (([&](const auto& val) {
-            if (!first) sql += ", ";
-            sql += to_sql(Value{val});
-            first = false;
-        }(values)), ...);
-    }, cond.values);
-    sql += ")";
-    return sql;
+void emit(std::string& out, const ::sqlgen::advanced::NotInCondition<ColType, ValueTypes...>& cond) {
+    emit(out, cond.column);
+    out += " NOT IN (";
+    emit(out, cond.values);
+    out += ')';
 }
 
-/// Convert BETWEEN condition to SQL
+/// Emit BETWEEN condition
 template <class ColType, class LowerType, class UpperType>
-inline std::string to_sql(const ::sqlgen::advanced::BetweenCondition<ColType, LowerType, UpperType>& cond) {
-    return to_sql(cond.column) + " BETWEEN " +
-           to_sql(Value{cond.lower}) + " AND " +
-           to_sql(Value{cond.upper});
+void emit(std::string& out, const ::sqlgen::advanced::BetweenCondition<ColType, LowerType, UpperType>& cond) {
+    emit(out, cond.column);
+    out += " BETWEEN ";
+    emit(out, cond.lower);
+    out += " AND ";
+    emit(out, cond.upper);
 }
 
-/// Convert NOT BETWEEN condition to SQL
+/// Emit NOT BETWEEN condition
 template <class ColType, class LowerType, class UpperType>
-inline std::string to_sql(const ::sqlgen::advanced::NotBetweenCondition<ColType, LowerType, UpperType>& cond) {
-    return to_sql(cond.column) + " NOT BETWEEN " +
-           to_sql(Value{cond.lower}) + " AND " +
-           to_sql(Value{cond.upper});
+void emit(std::string& out, const ::sqlgen::advanced::NotBetweenCondition<ColType, LowerType, UpperType>& cond) {
+    emit(out, cond.column);
+    out += " NOT BETWEEN ";
+    emit(out, cond.lower);
+    out += " AND ";
+    emit(out, cond.upper);
 }
+
 /// Helper to extract operator from a Condition type
 template <class T>
 struct GetOperator {
@@ -262,11 +387,9 @@ constexpr bool is_logical_condition<Condition<L, Operator::logical_and, R>> = tr
 template <class L, class R>
 constexpr bool is_logical_condition<Condition<L, Operator::logical_or, R>> = true;
 
-/// Convert a condition to SQL
+/// Emit a condition
 template <class Left, Operator Op, class Right>
-std::string to_sql(const Condition<Left, Op, Right>& condition) {
-    std::string result;
-
+void emit(std::string& out, const Condition<Left, Op, Right>& condition) {
     // Add parentheses around operands only if:
     // 1. This is a logical operator (AND/OR), AND
     // 2. The operand contains a DIFFERENT logical operator (to preserve precedence)
@@ -276,66 +399,68 @@ std::string to_sql(const Condition<Left, Op, Right>& condition) {
         constexpr Operator left_op = GetOperator<std::decay_t<Left>>::value;
         // Only add parentheses if operators differ (mixing AND and OR)
         if constexpr (left_op != Op) {
-            result = "(" + to_sql(condition.left) + ")";
+            out += '(';
+            emit(out, condition.left);
+            out += ')';
         } else {
-            result = to_sql(condition.left);
+            emit(out, condition.left);
         }
     } else {
-        result = to_sql(condition.left);
+        emit(out, condition.left);
     }
 
-    result += operator_to_sql(Op);
+    out += operator_to_sql(Op);
 
     if constexpr (is_logical && is_logical_condition<std::decay_t<Right>>) {
         // Always add parentheses to right operands that are logical conditions
         // This preserves grouping and improves readability
-        result += "(" + to_sql(condition.right) + ")";
+        out += '(';
+        emit(out, condition.right);
+        out += ')';
     } else {
-        result += to_sql(condition.right);
+        emit(out, condition.right);
     }
-
-    return result;
 }
 
-/// Convert a condition wrapper to SQL
+/// Emit a condition wrapper
 template <class T>
-std::string to_sql(const ConditionWrapper<T>& wrapper) {
-    return to_sql(wrapper.condition);
+void emit(std::string& out, const ConditionWrapper<T>& wrapper) {
+    emit(out, wrapper.condition);
 }
 
-/// Convert a Desc (descending order column) to SQL
-template <class Col>
-std::string to_sql(const Desc<Col>& desc) {
-    return to_sql(desc.column) + " DESC";
+/// Emit a Desc (descending order column)
+template <class C>
+void emit(std::string& out, const Desc<C>& desc) {
+    emit(out, desc.column);
+    out += " DESC";
 }
 
-/// Convert a Set (UPDATE SET clause) to SQL
-template <class Col, class Value>
-std::string to_sql(const Set<Col, Value>& set) {
-    return to_sql(set.column) + " = " + to_sql(set.value);
+/// Emit a Set (UPDATE SET clause)
+template <class C, class V>
+void emit(std::string& out, const Set<C, V>& set) {
+    emit(out, set.column);
+    out += " = ";
+    emit(out, set.value);
 }
 
-/// Convert an Aggregate function to SQL
+/// Emit an Aggregate function
 template <AggregateType Type, class ExprType>
-std::string to_sql(const Aggregate<Type, ExprType>& agg) {
-    std::string sql;
-    sql += aggregate_type_to_sql(Type);
-    sql += "(";
+void emit(std::string& out, const Aggregate<Type, ExprType>& agg) {
+    out += aggregate_type_to_sql(Type);
+    out += '(';
 
     if constexpr (std::is_same_v<ExprType, CountStar>) {
         // COUNT(*)
-        sql += "*";
+        out += '*';
     } else {
         // Add DISTINCT for COUNT(DISTINCT col)
         if (agg.is_distinct()) {
-            sql += "DISTINCT ";
+            out += "DISTINCT ";
         }
-        // Add expression
-        sql += to_sql(agg.expression);
+        emit(out, agg.expression);
     }
 
-    sql += ")";
-    return sql;
+    out += ')';
 }
 
 /// Helper to get SQL type name for CAST
@@ -354,145 +479,53 @@ constexpr std::string_view get_sql_type_name() {
     }
 }
 
-/// Convert a SQL function to SQL string
+/// strftime() format of the date part functions, empty for other functions
+constexpr std::string_view strftime_format(FunctionType type) {
+    switch (type) {
+        case FunctionType::year: return "%Y";
+        case FunctionType::month: return "%m";
+        case FunctionType::day: return "%d";
+        case FunctionType::hour: return "%H";
+        case FunctionType::minute: return "%M";
+        case FunctionType::second: return "%S";
+        case FunctionType::weekday: return "%w";
+        default: return "";
+    }
+}
+
+/// Emit a SQL function
 template <FunctionType Type, class... ArgTypes>
-std::string to_sql(const Function<Type, ArgTypes...>& func) {
-    std::string sql;
-    
-    // Handle date/time functions specially (SQLite strftime format)
-    if constexpr (Type == FunctionType::year) {
-        sql = "CAST(strftime('%Y', ";
-        std::apply([&](const auto&... args) {
-            bool first = true;
-            (([&] {
-                if (!first) sql += ", ";
-                sql += to_sql(args);
-                first = false;
-            }()), ...);
-        }, func.arguments);
-        sql += ") AS INTEGER)";
-        return sql;
-    } else if constexpr (Type == FunctionType::month) {
-        sql = "CAST(strftime('%m', ";
-        std::apply([&](const auto&... args) {
-            bool first = true;
-            (([&] {
-                if (!first) sql += ", ";
-                sql += to_sql(args);
-                first = false;
-            }()), ...);
-        }, func.arguments);
-        sql += ") AS INTEGER)";
-        return sql;
-    } else if constexpr (Type == FunctionType::day) {
-        sql = "CAST(strftime('%d', ";
-        std::apply([&](const auto&... args) {
-            bool first = true;
-            (([&] {
-                if (!first) sql += ", ";
-                sql += to_sql(args);
-                first = false;
-            }()), ...);
-        }, func.arguments);
-        sql += ") AS INTEGER)";
-        return sql;
-    } else if constexpr (Type == FunctionType::hour) {
-        sql = "CAST(strftime('%H', ";
-        std::apply([&](const auto&... args) {
-            bool first = true;
-            (([&] {
-                if (!first) sql += ", ";
-                sql += to_sql(args);
-                first = false;
-            }()), ...);
-        }, func.arguments);
-        sql += ") AS INTEGER)";
-        return sql;
-    } else if constexpr (Type == FunctionType::minute) {
-        sql = "CAST(strftime('%M', ";
-        std::apply([&](const auto&... args) {
-            bool first = true;
-            (([&] {
-                if (!first) sql += ", ";
-                sql += to_sql(args);
-                first = false;
-            }()), ...);
-        }, func.arguments);
-        sql += ") AS INTEGER)";
-        return sql;
-    } else if constexpr (Type == FunctionType::second) {
-        sql = "CAST(strftime('%S', ";
-        std::apply([&](const auto&... args) {
-            bool first = true;
-            (([&] {
-                if (!first) sql += ", ";
-                sql += to_sql(args);
-                first = false;
-            }()), ...);
-        }, func.arguments);
-        sql += ") AS INTEGER)";
-        return sql;
-    } else if constexpr (Type == FunctionType::weekday) {
-        sql = "CAST(strftime('%w', ";
-        std::apply([&](const auto&... args) {
-            bool first = true;
-            (([&] {
-                if (!first) sql += ", ";
-                sql += to_sql(args);
-                first = false;
-            }()), ...);
-        }, func.arguments);
-        sql += ") AS INTEGER)";
-        return sql;
+void emit(std::string& out, const Function<Type, ArgTypes...>& func) {
+    if constexpr (!strftime_format(Type).empty()) {
+        // Date parts use SQLite strftime: CAST(strftime('%Y', arg) AS INTEGER)
+        out += "CAST(strftime('";
+        out += strftime_format(Type);
+        out += "', ";
+        emit(out, func.arguments);
+        out += ") AS INTEGER)";
     } else if constexpr (Type == FunctionType::days_between) {
-        sql = "(julianday(";
-        // Get first argument
-        sql += to_sql(std::get<1>(func.arguments));
-        sql += ") - julianday(";
-        sql += to_sql(std::get<0>(func.arguments));
-        sql += "))";
-        return sql;
-    } else if constexpr (Type == FunctionType::unixepoch) {
-        sql = "unixepoch(";
-        std::apply([&](const auto&... args) {
-            bool first = true;
-            (([&] {
-                if (!first) sql += ", ";
-                sql += to_sql(args);
-                first = false;
-            }()), ...);
-        }, func.arguments);
-        sql += ")";
-        return sql;
+        out += "(julianday(";
+        emit(out, std::get<1>(func.arguments));
+        out += ") - julianday(";
+        emit(out, std::get<0>(func.arguments));
+        out += "))";
     } else {
         // Standard function call: FUNC_NAME(arg1, arg2, ...)
-        sql += function_type_to_sql(Type);
-        sql += "(";
-        
-        std::apply([&](const auto&... args) {
-            bool first = true;
-            (([&] {
-                if (!first) sql += ", ";
-                sql += to_sql(args);
-                first = false;
-            }()), ...);
-        }, func.arguments);
-        
-        sql += ")";
+        out += function_type_to_sql(Type);
+        out += '(';
+        emit(out, func.arguments);
+        out += ')';
     }
-    
-    return sql;
 }
 
-/// Convert a CAST function to SQL
+/// Emit a CAST function
 template <class TargetType, class ExprType>
-std::string to_sql(const CastFunction<TargetType, ExprType>& func) {
-    std::string sql = "CAST(";
-    sql += to_sql(func.expression);
-    sql += " AS ";
-    sql += get_sql_type_name<TargetType>();
-    sql += ")";
-    return sql;
+void emit(std::string& out, const CastFunction<TargetType, ExprType>& func) {
+    out += "CAST(";
+    emit(out, func.expression);
+    out += " AS ";
+    out += get_sql_type_name<TargetType>();
+    out += ')';
 }
 
 
@@ -502,16 +535,20 @@ std::string to_sql(const CastFunction<TargetType, ExprType>& func) {
 
 
 
-/// Generate a WHERE clause from a condition
+/// Emit a WHERE clause for a condition
 template <class CondType>
-std::string where_clause(const CondType& condition) {
-    return "WHERE " + to_sql(condition);
+void emit_where(std::string& out, const CondType& condition) {
+    out += "WHERE ";
+    emit(out, condition);
 }
 
-/// Generate a WHERE clause from a condition wrapper
-template <class T>
-std::string where_clause(const ConditionWrapper<T>& wrapper) {
-    return "WHERE " + to_sql(wrapper.condition);
+/// Generate a WHERE clause from a condition
+template <class CondType>
+std::string where_clause(const CondType& condition) {
+    std::string result;
+    result.reserve(6 + sql_size_v<CondType>);
+    emit_where(result, condition);
+    return result;
 }
 
 /// Combine multiple conditions with AND
@@ -522,7 +559,7 @@ std::string where_clause_and(const Conditions&... conditions) {
 
     ([&] {
         if (idx > 0) result += " AND ";
-        result += to_sql(conditions);
+        emit(result, conditions);
         ++idx;
     }(), ...);
 
@@ -537,7 +574,7 @@ std::string where_clause_or(const Conditions&... conditions) {
 
     ([&] {
         if (idx > 0) result += " OR ";
-        result += to_sql(conditions);
+        emit(result, conditions);
         ++idx;
     }(), ...);
 
@@ -551,22 +588,18 @@ std::string where_clause_or(const Conditions&... conditions) {
 
 
 
+/// Emit a GROUP BY clause
+template <class... ColTypes>
+void emit_group_by(std::string& out, const std::tuple<ColTypes...>& columns) {
+    out += "GROUP BY ";
+    emit(out, columns);
+}
+
 /// Generate SQL for GROUP BY clause
 template <class... ColTypes>
 std::string group_by_sql(const std::tuple<ColTypes...>& columns) {
-    std::string sql = "GROUP BY ";
-
-    bool first = true;
-    std::apply([&](const auto&... cols) {
-        (([&] {
-            if (!first) {
-                sql += ", ";
-            }
-            sql += to_sql(cols);
-            first = false;
-        }()), ...);
-    }, columns);
-
+    std::string sql;
+    emit_group_by(sql, columns);
     return sql;
 }
 
@@ -577,10 +610,19 @@ std::string group_by_sql(const std::tuple<ColTypes...>& columns) {
 
 
 
+/// Emit a HAVING clause
+template <class ConditionType>
+void emit_having(std::string& out, const ConditionType& condition) {
+    out += "HAVING ";
+    emit(out, condition);
+}
+
 /// Generate SQL for HAVING clause
 template <class ConditionType>
 std::string having_clause(const ConditionType& condition) {
-    return "HAVING " + to_sql(condition);
+    std::string sql;
+    emit_having(sql, condition);
+    return sql;
 }
 
 
@@ -590,32 +632,62 @@ std::string having_clause(const ConditionType& condition) {
 
 
 
+/// Emit an ORDER BY clause
+template <class... ColTypes>
+void emit_order_by(std::string& out, const std::tuple<ColTypes...>& columns) {
+    out += "ORDER BY ";
+    emit(out, columns);
+}
+
 /// Generate ORDER BY SQL from tuple of columns
 template <class... ColTypes>
 std::string order_by_sql(const std::tuple<ColTypes...>& columns) {
-    std::string result = "ORDER BY ";
-    bool first = true;
+    std::string result;
+    emit_order_by(result, columns);
+    return result;
+}
 
-    std::apply([&](const auto&... cols) {
-        (([&] {
-            if (first) {
-                result += to_sql(cols);
-                first = false;
-            } else {
-                result += ", " + to_sql(cols);
-            }
-        }()), ...);
-    }, columns);
+/// Size hint of a RETURNING clause
+template <class TableType, class... ColTypes>
+inline constexpr size_t returning_sql_size =
+    10 + (sizeof...(ColTypes) == 0 ? quoted_field_list<TableType>.size() : sql_size_v<std::tuple<ColTypes...>>);
 
+/// Emit a RETURNING clause, for every field of TableType when there are
+/// no columns
+template <class TableType, class... ColTypes>
+void emit_returning(std::string& out, const std::tuple<ColTypes...>& columns) {
+    out += "RETURNING ";
+    if constexpr (sizeof...(ColTypes) == 0) {
+        out += quoted_field_list<TableType>;
+    } else {
+        emit(out, columns);
+    }
+}
+
+/// Generate RETURNING SQL from tuple of columns, or every field of
+/// TableType when there are none
+template <class TableType, class... ColTypes>
+std::string returning_sql(const std::tuple<ColTypes...>& columns) {
+    std::string result;
+    result.reserve(returning_sql_size<TableType, ColTypes...>);
+    emit_returning<TableType>(result, columns);
     return result;
 }
 
-/// Generate LIMIT SQL
-inline std::string limit_sql(size_t limit_value, const std::optional<size_t>& offset_value) {
-    std::string result = "LIMIT " + std::to_string(limit_value);
+/// Emit a LIMIT clause
+inline void emit_limit(std::string& out, size_t limit_value, const std::optional<size_t>& offset_value) {
+    out += "LIMIT ";
+    emit(out, limit_value);
     if (offset_value.has_value()) {
-        result += " OFFSET " + std::to_string(offset_value.value());
+        out += " OFFSET ";
+        emit(out, offset_value.value());
     }
+}
+
+/// Generate LIMIT SQL
+inline std::string limit_sql(size_t limit_value, const std::optional<size_t>& offset_value) {
+    std::string result;
+    emit_limit(result, limit_value, offset_value);
     return result;
 }
 
@@ -626,50 +698,52 @@ inline std::string limit_sql(size_t limit_value, const std::optional<size_t>& of
 
 
 
-/// Generate SQL for a single JOIN clause
+/// Emit a single JOIN clause
 template <JoinType Type, class TableType, glz::string_literal Alias, class ConditionType>
-std::string join_sql(const Join<Type, TableType, Alias, ConditionType>& join) {
-    std::string sql;
-
+void emit(std::string& out, const Join<Type, TableType, Alias, ConditionType>& join) {
     // Add JOIN type
-    sql += join_type_to_sql(Type);
-    sql += " ";
+    out += join_type_to_sql(Type);
+    out += ' ';
 
     // Add table name
-    sql += quote_identifier(get_table_name<TableType>());
+    out += quoted_table_name<TableType>;
 
     // Add alias if present
-    if (join.has_alias()) {
-        sql += " AS ";
-        sql += quote_identifier(join.get_alias());
+    if constexpr (!Alias.sv().empty()) {
+        out += " AS ";
+        out += quoted_identifier<Alias>;
     }
 
     // Add ON condition (except for CROSS JOIN)
     if constexpr (Type != JoinType::cross) {
-        sql += " ON ";
-        sql += to_sql(join.condition);
+        out += " ON ";
+        emit(out, join.condition);
     }
-
-    return sql;
 }
 
-/// Generate SQL for a list of JOINs
+/// Emit a list of JOINs separated by spaces
 template <class... Joins>
-std::string joins_sql(const JoinList<Joins...>& join_list) {
-    std::string sql;
-    bool first = true;
-
+void emit(std::string& out, const JoinList<Joins...>& join_list) {
     std::apply([&](const auto&... joins) {
+        bool first = true;
         (([&] {
-            if (!first) {
-                sql += " ";
-            }
-            sql += join_sql(joins);
+            if (!first) out += ' ';
+            emit(out, joins);
             first = false;
         }()), ...);
     }, join_list.joins);
+}
 
-    return sql;
+/// Generate SQL for a single JOIN clause
+template <JoinType Type, class TableType, glz::string_literal Alias, class ConditionType>
+std::string join_sql(const Join<Type, TableType, Alias, ConditionType>& join) {
+    return to_sql(join);
+}
+
+/// Generate SQL for a list of JOINs
+template <class... Joins>
+std::string joins_sql(const JoinList<Joins...>& join_list) {
+    return to_sql(join_list);
 }
 
 
@@ -682,27 +756,7 @@ std::string joins_sql(const JoinList<Joins...>& join_list) {
 /// Generate SQL for aggregate function
 template <AggregateType Type, class ExprType>
 std::string aggregate_sql(const Aggregate<Type, ExprType>& agg) {
-    std::string sql;
-
-    // Add function name
-    sql += aggregate_type_to_sql(Type);
-    sql += "(";
-
-    // Handle different cases
-    if constexpr (std::is_same_v<ExprType, CountStar>) {
-        // COUNT(*)
-        sql += "*";
-    } else {
-        // Add DISTINCT for COUNT(DISTINCT col)
-        if (agg.is_distinct()) {
-            sql += "DISTINCT ";
-        }
-        // Add expression
-        sql += to_sql(agg.expression);
-    }
-
-    sql += ")";
-    return sql;
+    return to_sql(agg);
 }
 
 } // namespace sqlgen::transpilation
@@ -0,0 +1,77 @@
+#include "sqlgen/sqlite/BusyPolicy.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace sqlgen::sqlite {
+
+namespace {
+
+uint64_t to_ns(std::chrono::steady_clock::duration duration) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+} // namespace
+
+std::chrono::nanoseconds BusyPolicy::backoff(int attempt) const {
+    const auto cap = std::chrono::duration<double, std::nano>(max_backoff);
+    auto delay = std::chrono::duration<double, std::nano>(initial_backoff) * std::pow(multiplier, attempt);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::min(delay, cap));
+}
+
+BusyHandler::BusyHandler(BusyPolicy policy)
+    : policy_(policy), random_(static_cast<std::minstd_rand::result_type>(std::random_device{}())) {}
+
+void BusyHandler::install(sqlite3* db) noexcept {
+    sqlite3_busy_handler(db, on_busy, this);
+}
+
+ContentionStats BusyHandler::stats() const noexcept {
+    ContentionStats stats;
+    stats.busy_events = busy_events_.load(std::memory_order_relaxed);
+    stats.retries = retries_.load(std::memory_order_relaxed);
+    stats.timeouts = timeouts_.load(std::memory_order_relaxed);
+    stats.wait_ns = wait_ns_.load(std::memory_order_relaxed);
+    stats.max_wait_ns = max_wait_ns_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool BusyHandler::wait(int attempt, std::chrono::steady_clock::time_point start) {
+    const auto waited = std::chrono::steady_clock::now() - start;
+    if (waited >= policy_.max_wait) {
+        timeouts_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    auto sleep = std::min<std::chrono::nanoseconds>(policy_.backoff(attempt), policy_.max_wait - waited);
+    const double jitter = std::clamp(policy_.jitter, 0.0, 1.0);
+    if (jitter > 0.0) {
+        std::uniform_real_distribution<double> keep(1.0 - jitter, 1.0);
+        sleep = std::chrono::duration_cast<std::chrono::nanoseconds>(sleep * keep(random_));
+    }
+
+    const auto before = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(sleep);
+    const auto after = std::chrono::steady_clock::now();
+
+    retries_.fetch_add(1, std::memory_order_relaxed);
+    wait_ns_.fetch_add(to_ns(after - before), std::memory_order_relaxed);
+
+    const uint64_t total = to_ns(after - start);
+    uint64_t longest = max_wait_ns_.load(std::memory_order_relaxed);
+    while (total > longest && !max_wait_ns_.compare_exchange_weak(longest, total, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+int BusyHandler::on_busy(void* self, int count) noexcept {
+    auto* handler = static_cast<BusyHandler*>(self);
+    // count is the number of earlier calls for the same lock
+    if (count == 0) {
+        handler->wait_start_ = std::chrono::steady_clock::now();
+        handler->busy_events_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return handler->wait(count, handler->wait_start_) ? 1 : 0;
+}
+
+} // namespace sqlgen::sqlite
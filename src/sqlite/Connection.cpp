@@ -1,11 +1,22 @@
 #include "sqlgen/sqlite/Connection.hpp"
 #include <sstream>
+#include <utility>
 
 namespace sqlgen::sqlite {
 
 Result<Connection> Connection::connect(const std::string& filename) {
+    return connect(filename, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+}
+
+Result<Connection> Connection::connect(const std::string& filename, int flags) {
+    ConnectionOptions options;
+    options.flags = flags;
+    return connect(filename, options);
+}
+
+Result<Connection> Connection::connect(const std::string& filename, const ConnectionOptions& options) {
     sqlite3* raw_conn = nullptr;
-    int rc = sqlite3_open(filename.c_str(), &raw_conn);
+    int rc = sqlite3_open_v2(filename.c_str(), &raw_conn, options.flags, nullptr);
 
     if (rc != SQLITE_OK) {
         std::string err_msg = raw_conn ? sqlite3_errmsg(raw_conn) : "Unknown error";
@@ -16,22 +27,68 @@ Result<Connection> Connection::connect(const std::string& filename) {
     }
 
     // Wrap in shared_ptr with custom deleter
+    // sqlite3_close_v2 defers the close until statements that outlive the
+    // connection (held by a Statement or Iterator) are finalized. Those
+    // can still be stepped, so the progress and busy handlers, which point
+    // into the Connection, are unregistered first.
     auto conn = std::shared_ptr<sqlite3>(raw_conn, [](sqlite3* db) {
-        if (db) sqlite3_close(db);
+        if (db) {
+            sqlite3_progress_handler(db, 0, nullptr, nullptr);
+            sqlite3_busy_handler(db, nullptr, nullptr);
+            sqlite3_close_v2(db);
+        }
     });
 
-    return Connection(std::move(conn));
+    Connection connection(std::move(conn), options.flags);
+
+    // The busy policy replaces busy_timeout, which would in turn replace it
+    ConnectionOptions settings = options;
+    if (settings.busy_policy) {
+        connection.set_busy_policy(*settings.busy_policy);
+        settings.busy_timeout.reset();
+    }
+
+    // Nobody else has the connection yet, so a failure here just drops it
+    auto applied = apply_options(connection.handle(), settings);
+    if (!applied) {
+        return error("Failed to configure database: " + applied.error());
+    }
+
+    return connection;
+}
+
+Result<ConnectionOptions> Connection::options() const {
+    auto options = read_options(conn_.get());
+    if (options) {
+        options->flags = flags_;
+        options->busy_policy = busy_policy();
+    }
+    return options;
 }
 
 Result<Nothing> Connection::execute(const std::string& sql) {
+    // sqlite3_exec prepares and runs each statement itself; the profile
+    // trace is the only way to time them individually
+    if (instrumentation_) {
+        instrumentation_->attach_trace(conn_.get());
+    }
+
     char* err_msg = nullptr;
     int rc = sqlite3_exec(conn_.get(), sql.c_str(), nullptr, nullptr, &err_msg);
 
+    if (instrumentation_) {
+        instrumentation_->detach_trace(conn_.get());
+    }
+    setup_ = {};  // sqlite3_exec runs aren't charged with it
+
     if (rc != SQLITE_OK) {
         std::string error_str = err_msg ? err_msg : "Unknown error";
         if (err_msg) {
             sqlite3_free(err_msg);
         }
+        if (rc == SQLITE_INTERRUPT) {
+            return error(step_error(conn_.get(), rc, "Failed to execute SQL"));
+        }
         return error("Failed to execute SQL: " + error_str);
     }
 
@@ -39,18 +96,102 @@ Result<Nothing> Connection::execute(const std::string& sql) {
 }
 
 Result<Iterator> Connection::query(const std::string& sql) {
+    auto stmt = prepare_statement(sql.c_str(), 0);
+    if (!stmt) {
+        return error(stmt.error());
+    }
+
+    auto* handle = stmt->get();
+    auto stats = stats_for(handle);
+    QueryProbe probe = stats ? QueryProbe(std::move(stats), handle, std::exchange(setup_, {})) : QueryProbe();
+    return Iterator(std::move(*stmt), conn_.get(), std::move(probe));
+}
+
+Result<std::shared_ptr<sqlite3_stmt>> Connection::prepare_statement(const char* sql, unsigned int flags) {
+    const uint64_t start = instrumentation_ ? now_ns() : 0;
+
+    // Reading the schema can find it locked; a failed prepare leaves
+    // nothing behind, so it is safe to repeat
     sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(conn_.get(), sql.c_str(), -1, &stmt, nullptr);
+    auto prepare = [&] { return sqlite3_prepare_v3(conn_.get(), sql, -1, flags, &stmt, nullptr); };
+    int rc = busy_ ? busy_->retry(prepare) : prepare();
 
     if (rc != SQLITE_OK) {
-        std::string err_msg = sqlite3_errmsg(conn_.get());
+        auto err = step_error(conn_.get(), rc, "Failed to prepare statement");
         if (stmt) {
             sqlite3_finalize(stmt);
         }
-        return error("Failed to prepare statement: " + err_msg);
+        setup_ = {};
+        return error(err);
+    }
+
+    if (instrumentation_) {
+        setup_.prepare_ns = now_ns() - start;
+        instrumentation_->stats(sqlite3_sql(stmt))->phase(Phase::Prepare).record(setup_.prepare_ns);
+    }
+
+    return std::shared_ptr<sqlite3_stmt>(stmt, [](sqlite3_stmt* s) {
+        if (s) sqlite3_finalize(s);
+    });
+}
+
+std::shared_ptr<QueryStats> Connection::stats_for(sqlite3_stmt* stmt) const {
+    if (!instrumentation_) {
+        return nullptr;
+    }
+    return instrumentation_->stats(sqlite3_sql(stmt));
+}
+
+Result<Statement> Connection::prepare(const std::string& sql) {
+    StatementKey key{nullptr, sql};
+    auto cached = acquire(key);
+    if (!cached) {
+        return error(cached.error());
+    }
+    if (*cached) {
+        return std::move(**cached);
+    }
+    return prepare_and_cache(std::move(key), sql);
+}
+
+Result<std::optional<Statement>> Connection::acquire(const StatementKey& key) {
+    auto stmt = cache_.find(key);
+    if (!stmt) {
+        return std::optional<Statement>{};
+    }
+
+    // One reference is the cache's and one is ours; any other means the
+    // statement is still owned by a live Statement or Iterator
+    if (stmt.use_count() > 2) {
+        // Rebinding it here would clobber that user, so prepare a private
+        // copy instead
+        auto fresh = prepare_statement(sqlite3_sql(stmt.get()), 0);
+        if (!fresh) {
+            return error(fresh.error());
+        }
+        auto stats = stats_for(fresh->get());
+        return std::optional<Statement>(Statement(std::move(*fresh), std::move(stats), std::exchange(setup_, {})));
     }
 
-    return Iterator(stmt, conn_.get());
+    // The previous user may have abandoned it mid-iteration or left
+    // bindings behind; the reset error (if any) belongs to that earlier run
+    sqlite3_reset(stmt.get());
+    sqlite3_clear_bindings(stmt.get());
+    auto stats = stats_for(stmt.get());
+    return std::optional<Statement>(Statement(std::move(stmt), std::move(stats), std::exchange(setup_, {})));
+}
+
+Result<Statement> Connection::prepare_and_cache(StatementKey key, const std::string& sql) {
+    // SQLITE_PREPARE_PERSISTENT tells SQLite the statement is long-lived so
+    // it avoids the lookaside allocator for it
+    auto stmt = prepare_statement(sql.c_str(), SQLITE_PREPARE_PERSISTENT);
+    if (!stmt) {
+        return error(stmt.error());
+    }
+
+    cache_.insert(std::move(key), *stmt);
+    auto stats = stats_for(stmt->get());
+    return Statement(std::move(*stmt), std::move(stats), std::exchange(setup_, {}));
 }
 
 Result<Nothing> Connection::begin_transaction() {
@@ -58,7 +199,32 @@ Result<Nothing> Connection::begin_transaction() {
 }
 
 Result<Nothing> Connection::commit() {
-    return execute(std::string("COMMIT"));
+    if (!busy_) {
+        return execute(std::string("COMMIT"));
+    }
+
+    // A COMMIT that fails with SQLITE_BUSY leaves the transaction open and
+    // can be tried again
+    Result<Nothing> result = Nothing{};
+    busy_->retry([&] {
+        result = execute(std::string("COMMIT"));
+        return result ? SQLITE_OK : sqlite3_extended_errcode(conn_.get());
+    });
+    return result;
+}
+
+void Connection::set_busy_policy(const BusyPolicy& policy) {
+    if (busy_) {
+        busy_->set_policy(policy);
+        return;
+    }
+    busy_ = std::make_shared<BusyHandler>(policy);
+    busy_->install(conn_.get());
+}
+
+void Connection::clear_busy_policy() {
+    sqlite3_busy_handler(conn_.get(), nullptr, nullptr);
+    busy_.reset();
 }
 
 Result<Nothing> Connection::rollback() {
@@ -0,0 +1,196 @@
+#include "sqlgen/sqlite/ConnectionOptions.hpp"
+#include <array>
+#include <initializer_list>
+#include <limits>
+#include <string>
+
+namespace sqlgen::sqlite {
+
+namespace {
+
+constexpr std::array<std::string_view, 6> journal_modes = {"delete", "truncate", "persist", "memory", "wal", "off"};
+constexpr std::array<std::string_view, 4> synchronous_modes = {"off", "normal", "full", "extra"};
+constexpr std::array<std::string_view, 3> temp_stores = {"default", "file", "memory"};
+
+/// Run a PRAGMA and return the first column of its first row as text
+/// (empty if it returns no rows)
+Result<std::string> pragma(sqlite3* db, const std::string& sql) {
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        std::string err_msg = sqlite3_errmsg(db);
+        sqlite3_finalize(stmt);
+        return error("Failed to run " + sql + ": " + err_msg);
+    }
+
+    std::string value;
+    rc = sqlite3_step(stmt);
+    if (rc == SQLITE_ROW) {
+        auto text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        value = text ? text : "";
+        rc = sqlite3_step(stmt);
+    }
+    if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
+        std::string err_msg = sqlite3_errmsg(db);
+        sqlite3_finalize(stmt);
+        return error("Failed to run " + sql + ": " + err_msg);
+    }
+
+    sqlite3_finalize(stmt);
+    return value;
+}
+
+Result<int64_t> pragma_int(sqlite3* db, const std::string& name) {
+    auto value = pragma(db, "PRAGMA " + name);
+    if (!value) {
+        return error(value.error());
+    }
+    try {
+        return std::stoll(*value);
+    } catch (const std::exception&) {
+        return error("Failed to read PRAGMA " + name + ": unexpected value '" + *value + "'");
+    }
+}
+
+Result<Nothing> set_pragma(sqlite3* db, const std::string& name, const std::string& value) {
+    auto result = pragma(db, "PRAGMA " + name + "=" + value);
+    if (!result) {
+        return error(result.error());
+    }
+    return Nothing{};
+}
+
+/// Reject the settings SQLite would ignore or refuse, before any is applied
+/// (the options checked here cover what can be known without trying)
+Result<Nothing> validate_options(sqlite3* db, const ConnectionOptions& options) {
+    if (options.page_size) {
+        const int size = *options.page_size;
+        if (size < 512 || size > 65536 || (size & (size - 1)) != 0) {
+            return error("Invalid page_size " + std::to_string(size) +
+                         ": must be a power of two from 512 to 65536");
+        }
+    }
+    if (options.busy_timeout &&
+        (options.busy_timeout->count() < 0 || options.busy_timeout->count() > std::numeric_limits<int>::max())) {
+        return error("Invalid busy_timeout " + std::to_string(options.busy_timeout->count()) + "ms");
+    }
+    if (options.threads && *options.threads < 0) {
+        return error("Invalid threads " + std::to_string(*options.threads) + ": must not be negative");
+    }
+    if (options.journal_mode && *options.journal_mode != JournalMode::Memory &&
+        *options.journal_mode != JournalMode::Off) {
+        // In-memory and temporary databases have no file name
+        const char* filename = sqlite3_db_filename(db, "main");
+        if (!filename || *filename == '\0') {
+            return error("Failed to set journal_mode=" + std::string(to_string(*options.journal_mode)) +
+                         ": an in-memory database can only journal in memory or not at all");
+        }
+    }
+    return Nothing{};
+}
+
+} // namespace
+
+std::string_view to_string(JournalMode mode) {
+    return journal_modes[static_cast<size_t>(mode)];
+}
+
+std::string_view to_string(Synchronous mode) {
+    return synchronous_modes[static_cast<size_t>(mode)];
+}
+
+std::string_view to_string(TempStore store) {
+    return temp_stores[static_cast<size_t>(store)];
+}
+
+Result<Nothing> apply_options(sqlite3* db, const ConnectionOptions& options) {
+    Result<Nothing> result = validate_options(db, options);
+
+    // page_size has to come before anything that writes the first page
+    // (journal_mode=WAL does)
+    if (options.page_size && result) {
+        result = set_pragma(db, "page_size", std::to_string(*options.page_size));
+    }
+    // Set before journal_mode, which may need to wait for a lock
+    if (options.busy_timeout && result) {
+        int rc = sqlite3_busy_timeout(db, static_cast<int>(options.busy_timeout->count()));
+        if (rc != SQLITE_OK) {
+            result = error(std::string("Failed to set busy_timeout: ") + sqlite3_errmsg(db));
+        }
+    }
+    if (options.journal_mode && result) {
+        // SQLite answers with the mode it ended up in rather than failing
+        std::string wanted(to_string(*options.journal_mode));
+        auto mode = pragma(db, "PRAGMA journal_mode=" + wanted);
+        if (!mode) {
+            result = error(mode.error());
+        } else if (*mode != wanted) {
+            result = error("Failed to set journal_mode=" + wanted + ": journal mode is " + *mode);
+        }
+    }
+    if (options.synchronous && result) {
+        result = set_pragma(db, "synchronous", std::string(to_string(*options.synchronous)));
+    }
+    if (options.cache_size && result) {
+        result = set_pragma(db, "cache_size", std::to_string(*options.cache_size));
+    }
+    if (options.mmap_size && result) {
+        result = set_pragma(db, "mmap_size", std::to_string(*options.mmap_size));
+    }
+    if (options.temp_store && result) {
+        result = set_pragma(db, "temp_store", std::string(to_string(*options.temp_store)));
+    }
+    if (options.threads && result) {
+        result = set_pragma(db, "threads", std::to_string(*options.threads));
+    }
+    return result;
+}
+
+Result<ConnectionOptions> read_options(sqlite3* db) {
+    ConnectionOptions options;
+
+    auto journal_mode = pragma(db, "PRAGMA journal_mode");
+    if (!journal_mode) {
+        return error(journal_mode.error());
+    }
+    for (size_t i = 0; i < journal_modes.size(); ++i) {
+        if (journal_modes[i] == *journal_mode) {
+            options.journal_mode = static_cast<JournalMode>(i);
+        }
+    }
+    if (!options.journal_mode) {
+        return error("Failed to read PRAGMA journal_mode: unexpected value '" + *journal_mode + "'");
+    }
+
+    // The remaining settings come back as integers
+    auto synchronous = pragma_int(db, "synchronous");
+    auto cache_size = pragma_int(db, "cache_size");
+    auto mmap_size = pragma_int(db, "mmap_size");
+    auto temp_store = pragma_int(db, "temp_store");
+    auto busy_timeout = pragma_int(db, "busy_timeout");
+    auto threads = pragma_int(db, "threads");
+    auto page_size = pragma_int(db, "page_size");
+    for (const auto* value : {&synchronous, &cache_size, &mmap_size, &temp_store, &busy_timeout, &threads, &page_size}) {
+        if (!*value) {
+            return error(value->error());
+        }
+    }
+
+    if (*synchronous < 0 || *synchronous >= static_cast<int64_t>(synchronous_modes.size())) {
+        return error("Failed to read PRAGMA synchronous: unexpected value " + std::to_string(*synchronous));
+    }
+    if (*temp_store < 0 || *temp_store >= static_cast<int64_t>(temp_stores.size())) {
+        return error("Failed to read PRAGMA temp_store: unexpected value " + std::to_string(*temp_store));
+    }
+
+    options.synchronous = static_cast<Synchronous>(*synchronous);
+    options.cache_size = *cache_size;
+    options.mmap_size = *mmap_size;
+    options.temp_store = static_cast<TempStore>(*temp_store);
+    options.busy_timeout = std::chrono::milliseconds(*busy_timeout);
+    options.threads = static_cast<int>(*threads);
+    options.page_size = static_cast<int>(*page_size);
+    return options;
+}
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,214 @@
+#include "sqlgen/sqlite/ConnectionPool.hpp"
+#include <bit>
+
+namespace sqlgen::sqlite {
+
+namespace {
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point since) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - since).count());
+}
+
+void update_max(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+struct ConnectionPool::State {
+    static constexpr size_t bits_per_word = 64;
+
+    explicit State(size_t size)
+        : words((size + bits_per_word - 1) / bits_per_word),
+          free_bits(std::make_unique<std::atomic<uint64_t>[]>(words)),
+          opened_at(std::chrono::steady_clock::now()) {
+        connections.reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            free_bits[i / bits_per_word].fetch_or(uint64_t{1} << (i % bits_per_word),
+                                                  std::memory_order_relaxed);
+        }
+    }
+
+    /// Claim a free connection by clearing its bit
+    std::optional<size_t> try_take() {
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t bits = free_bits[w].load(std::memory_order_acquire);
+            while (bits != 0) {
+                int bit = std::countr_zero(bits);
+                if (free_bits[w].compare_exchange_weak(bits, bits & ~(uint64_t{1} << bit),
+                                                       std::memory_order_acquire,
+                                                       std::memory_order_acquire)) {
+                    return w * bits_per_word + static_cast<size_t>(bit);
+                }
+                // bits now holds the current value; try again
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Hand a connection back and wake one waiter
+    void put(size_t index) {
+        free_bits[index / bits_per_word].fetch_or(uint64_t{1} << (index % bits_per_word),
+                                                  std::memory_order_release);
+        releases.fetch_add(1, std::memory_order_release);
+        releases.notify_one();
+    }
+
+    std::vector<Connection> connections;
+    size_t words;
+    std::unique_ptr<std::atomic<uint64_t>[]> free_bits;  // 1 = free
+    std::atomic<uint32_t> releases{0};                   // Waiters block on this
+
+    std::chrono::steady_clock::time_point opened_at;
+    std::atomic<size_t> in_use{0};
+    std::atomic<uint64_t> peak_in_use{0};
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> waits{0};
+    std::atomic<uint64_t> total_wait_ns{0};
+    std::atomic<uint64_t> max_wait_ns{0};
+    std::atomic<uint64_t> busy_ns{0};
+};
+
+Result<ConnectionPool> ConnectionPool::open(const std::string& filename, size_t size, int flags) {
+    ConnectionOptions options;
+    options.flags = flags;
+    return open(filename, size, options);
+}
+
+Result<ConnectionPool> ConnectionPool::open(const std::string& filename, size_t size, const ConnectionOptions& options) {
+    if (size == 0) {
+        return error("Failed to open connection pool: size must be at least 1");
+    }
+
+    auto pooled = options;
+    pooled.flags |= SQLITE_OPEN_NOMUTEX;
+
+    auto state = std::make_shared<State>(size);
+    for (size_t i = 0; i < size; ++i) {
+        auto conn = Connection::connect(filename, pooled);
+        if (!conn) {
+            return error("Failed to open connection pool: " + conn.error());
+        }
+        state->connections.push_back(std::move(*conn));
+    }
+
+    return ConnectionPool(std::move(state));
+}
+
+ConnectionPool::Lease ConnectionPool::acquire() {
+    auto index = state_->try_take();
+
+    if (!index) {
+        auto wait_start = std::chrono::steady_clock::now();
+        while (!index) {
+            // Read the release count before retrying, so a release that
+            // lands in between makes wait() return immediately
+            uint32_t seen = state_->releases.load(std::memory_order_acquire);
+            index = state_->try_take();
+            if (!index) {
+                state_->releases.wait(seen, std::memory_order_acquire);
+            }
+        }
+
+        uint64_t waited = elapsed_ns(wait_start);
+        state_->waits.fetch_add(1, std::memory_order_relaxed);
+        state_->total_wait_ns.fetch_add(waited, std::memory_order_relaxed);
+        update_max(state_->max_wait_ns, waited);
+    }
+
+    state_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    size_t in_use = state_->in_use.fetch_add(1, std::memory_order_relaxed) + 1;
+    update_max(state_->peak_in_use, in_use);
+
+    return Lease(state_, *index, &state_->connections[*index]);
+}
+
+std::optional<ConnectionPool::Lease> ConnectionPool::try_acquire() {
+    auto index = state_->try_take();
+    if (!index) {
+        return std::nullopt;
+    }
+
+    state_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    size_t in_use = state_->in_use.fetch_add(1, std::memory_order_relaxed) + 1;
+    update_max(state_->peak_in_use, in_use);
+
+    return Lease(state_, *index, &state_->connections[*index]);
+}
+
+size_t ConnectionPool::size() const {
+    return state_->connections.size();
+}
+
+PoolStats ConnectionPool::stats() const {
+    PoolStats stats;
+    stats.size = state_->connections.size();
+    stats.in_use = state_->in_use.load(std::memory_order_relaxed);
+    stats.peak_in_use = state_->peak_in_use.load(std::memory_order_relaxed);
+    stats.acquisitions = state_->acquisitions.load(std::memory_order_relaxed);
+    stats.waits = state_->waits.load(std::memory_order_relaxed);
+    stats.total_wait_ns = state_->total_wait_ns.load(std::memory_order_relaxed);
+    stats.max_wait_ns = state_->max_wait_ns.load(std::memory_order_relaxed);
+    stats.busy_ns = state_->busy_ns.load(std::memory_order_relaxed);
+    stats.uptime_ns = elapsed_ns(state_->opened_at);
+    return stats;
+}
+
+ConnectionPool::Lease::Lease(std::shared_ptr<State> state, size_t index, Connection* conn)
+    : state_(std::move(state)),
+      index_(index),
+      conn_(conn),
+      leased_at_(std::chrono::steady_clock::now()) {}
+
+ConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : state_(std::move(other.state_)),
+      index_(other.index_),
+      conn_(other.conn_),
+      leased_at_(other.leased_at_) {
+    other.conn_ = nullptr;
+}
+
+ConnectionPool::Lease& ConnectionPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        state_ = std::move(other.state_);
+        index_ = other.index_;
+        conn_ = other.conn_;
+        leased_at_ = other.leased_at_;
+        other.conn_ = nullptr;
+    }
+    return *this;
+}
+
+ConnectionPool::Lease::~Lease() {
+    release();
+}
+
+void ConnectionPool::Lease::release() noexcept {
+    if (!conn_) {
+        return;
+    }
+
+    // Clear the deadline first so an expired one can't interrupt the rollback
+    conn_->clear_deadline();
+
+    // Don't hand the next user a transaction left open by this one
+    // Goes through the C API: Connection::rollback() builds a std::string and
+    // may record the run, either of which can throw
+    if (conn_->in_transaction()) {
+        sqlite3_exec(conn_->handle(), "ROLLBACK", nullptr, nullptr, nullptr);
+    }
+
+    state_->busy_ns.fetch_add(elapsed_ns(leased_at_), std::memory_order_relaxed);
+    state_->in_use.fetch_sub(1, std::memory_order_relaxed);
+    state_->put(index_);
+
+    conn_ = nullptr;
+    state_.reset();
+}
+
+} // namespace sqlgen::sqlite
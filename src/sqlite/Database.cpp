@@ -0,0 +1,46 @@
+#include "sqlgen/sqlite/Database.hpp"
+#include <algorithm>
+#include <thread>
+
+namespace sqlgen::sqlite {
+
+Result<Database> Database::open(const std::string& filename, size_t readers) {
+    return open(filename, readers, ConnectionOptions{});
+}
+
+Result<Database> Database::open(const std::string& filename, size_t readers, ConnectionOptions options) {
+    if (readers == 0) {
+        readers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // The writer creates the file and switches it to WAL before any reader
+    // opens it; journal_mode=WAL is persistent, so readers pick it up.
+    // Connecting fails if SQLite can't use WAL (e.g. for ":memory:")
+    ConnectionOptions writer_options = options;
+    writer_options.flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+    writer_options.journal_mode = JournalMode::Wal;
+    auto writer = Connection::connect(filename, writer_options);
+    if (!writer) {
+        return error("Failed to open database: " + writer.error());
+    }
+
+    // Readers share the busy handling and cache settings; the file format
+    // and journal mode are the writer's to set
+    ConnectionOptions reader_options = std::move(options);
+    reader_options.flags = SQLITE_OPEN_READONLY;
+    reader_options.journal_mode.reset();
+    reader_options.page_size.reset();
+    auto pool = ConnectionPool::open(filename, readers, reader_options);
+    if (!pool) {
+        return error("Failed to open database: " + pool.error());
+    }
+
+    return Database(std::make_unique<Writer>(std::move(*writer)), std::move(*pool));
+}
+
+Result<Nothing> Database::execute(const std::string& sql) {
+    auto lease = writer();
+    return lease->execute(sql);
+}
+
+} // namespace sqlgen::sqlite
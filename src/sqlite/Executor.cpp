@@ -0,0 +1,89 @@
+#include "sqlgen/sqlite/Executor.hpp"
+#include <algorithm>
+
+namespace sqlgen::sqlite {
+
+ThreadPoolExecutor::ThreadPoolExecutor(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this] { run(); });
+    }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPoolExecutor::post(std::move_only_function<void()> work) {
+    {
+        std::lock_guard lock(mutex_);
+        queue_.push_back(std::move(work));
+    }
+    ready_.notify_one();
+}
+
+void ThreadPoolExecutor::run() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        ready_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return;  // Stopping with nothing left to run
+        }
+
+        auto work = std::move(queue_.front());
+        queue_.pop_front();
+
+        lock.unlock();
+        work();
+        lock.lock();
+    }
+}
+
+void ManualExecutor::post(std::move_only_function<void()> work) {
+    std::lock_guard lock(mutex_);
+    queue_.push_back(std::move(work));
+}
+
+bool ManualExecutor::run_one() {
+    std::move_only_function<void()> work;
+    {
+        std::lock_guard lock(mutex_);
+        if (queue_.empty()) {
+            return false;
+        }
+        work = std::move(queue_.front());
+        queue_.pop_front();
+    }
+    work();
+    return true;
+}
+
+size_t ManualExecutor::run() {
+    size_t count = 0;
+    while (run_one()) {
+        ++count;
+    }
+    return count;
+}
+
+size_t ManualExecutor::pending() const {
+    std::lock_guard lock(mutex_);
+    return queue_.size();
+}
+
+Executor& default_executor() {
+    static ThreadPoolExecutor executor;
+    return executor;
+}
+
+} // namespace sqlgen::sqlite
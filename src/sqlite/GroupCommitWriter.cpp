@@ -0,0 +1,184 @@
+#include "sqlgen/sqlite/GroupCommitWriter.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace sqlgen::sqlite {
+
+GroupCommitWriter::GroupCommitWriter(Connection conn, GroupCommitOptions options)
+    : conn_(std::move(conn)), options_(options) {
+    if (options_.max_batch == 0) {
+        options_.max_batch = 1;
+    }
+    thread_ = std::thread([this] { run(); });
+}
+
+GroupCommitWriter::~GroupCommitWriter() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_one();
+    thread_.join();
+}
+
+std::future<Result<Nothing>> GroupCommitWriter::submit(Write write) {
+    std::promise<Result<Nothing>> done;
+    auto future = done.get_future();
+
+    bool wake = false;
+    {
+        std::lock_guard lock(mutex_);
+        if (stopping_) {
+            done.set_value(error("Failed to submit write: writer is shutting down"));
+            return future;
+        }
+        queue_.push_back(Pending{std::move(write), std::move(done)});
+        // The writer only needs waking for the first write of a window and
+        // when a batch fills up
+        wake = queue_.size() == 1 || queue_.size() >= options_.max_batch;
+    }
+    if (wake) {
+        ready_.notify_one();
+    }
+    return future;
+}
+
+GroupCommitStats GroupCommitWriter::stats() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+void GroupCommitWriter::run() {
+    std::vector<Pending> batch;
+    std::unique_lock lock(mutex_);
+
+    while (true) {
+        ready_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return;  // Stopping with nothing left to apply
+        }
+
+        // Let more writes join the batch until the window closes or it fills
+        auto deadline = std::chrono::steady_clock::now() + options_.window;
+        ready_.wait_until(lock, deadline, [&] {
+            return stopping_ || queue_.size() >= options_.max_batch;
+        });
+
+        size_t count = std::min(queue_.size(), options_.max_batch);
+        batch.assign(std::make_move_iterator(queue_.begin()),
+                     std::make_move_iterator(queue_.begin() + static_cast<std::ptrdiff_t>(count)));
+        queue_.erase(queue_.begin(), queue_.begin() + static_cast<std::ptrdiff_t>(count));
+
+        lock.unlock();
+        apply(batch);
+        batch.clear();
+        lock.lock();
+    }
+}
+
+Result<Nothing> GroupCommitWriter::prepare_savepoints() {
+    if (savepoint_) {
+        return Nothing{};
+    }
+    auto savepoint = conn_.prepare(std::string("SAVEPOINT group_write"));
+    auto release = conn_.prepare(std::string("RELEASE group_write"));
+    auto rollback_to = conn_.prepare(std::string("ROLLBACK TO group_write"));
+    for (auto* stmt : {&savepoint, &release, &rollback_to}) {
+        if (!*stmt) {
+            return error("Failed to prepare savepoint: " + stmt->error());
+        }
+    }
+    savepoint_ = std::move(*savepoint);
+    release_ = std::move(*release);
+    rollback_to_ = std::move(*rollback_to);
+    return Nothing{};
+}
+
+Result<Nothing> GroupCommitWriter::apply_write(Write& write, bool& intact) {
+    auto result = savepoint_->execute();
+    if (!result) {
+        intact = conn_.in_transaction();
+        return result;
+    }
+
+    try {
+        result = write(conn_);
+    } catch (const std::exception& e) {
+        result = error(std::string("Write threw an exception: ") + e.what());
+    } catch (...) {
+        result = error("Write threw an unknown exception");
+    }
+
+    if (result) {
+        result = release_->execute();
+        if (result) {
+            return result;
+        }
+    }
+
+    // Undo this write alone; RELEASE then drops the savepoint itself
+    auto undone = rollback_to_->execute();
+    if (undone) {
+        undone = release_->execute();
+    }
+    intact = undone.has_value() && conn_.in_transaction();
+    return result;
+}
+
+void GroupCommitWriter::apply(std::vector<Pending>& batch) {
+    std::vector<Result<Nothing>> results;
+    results.reserve(batch.size());
+    uint64_t failed = 0;
+
+    Result<Nothing> committed = prepare_savepoints();
+    if (committed) {
+        committed = conn_.begin_transaction();
+    }
+    if (committed) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            bool intact = true;
+            auto result = apply_write(batch[i].write, intact);
+            if (!result) {
+                ++failed;
+            }
+            results.push_back(std::move(result));
+            if (!intact) {
+                // Earlier writes went with the transaction, later ones have
+                // nothing to run in
+                committed = error("transaction ended by write " + std::to_string(i + 1) + " of " +
+                                  std::to_string(batch.size()));
+                break;
+            }
+        }
+        if (committed) {
+            committed = conn_.commit();
+        }
+    }
+    if (!committed && conn_.in_transaction()) {
+        conn_.rollback();
+    }
+
+    // Counted before any future is ready, so a submitter sees its write
+    {
+        std::lock_guard lock(mutex_);
+        if (committed) {
+            ++stats_.batches;
+            stats_.writes += batch.size() - failed;
+            stats_.failed_writes += failed;
+        } else {
+            stats_.failed_writes += batch.size();
+            ++stats_.failed_commits;
+        }
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (committed || (i < results.size() && !results[i])) {
+            // A write that failed by itself reports its own error
+            batch[i].done.set_value(std::move(results[i]));
+        } else {
+            batch[i].done.set_value(error("Failed to commit write batch: " + committed.error()));
+        }
+    }
+}
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,291 @@
+#include "sqlgen/sqlite/Instrumentation.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <glaze/glaze.hpp>
+
+namespace sqlgen::sqlite {
+
+namespace {
+
+void update_min(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value < current &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void update_max(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+// Called from inside SQLite, so nothing may propagate out of it; a run whose
+// stats can't be allocated goes unrecorded
+int trace_profile(unsigned type, void* context, void* p, void* x) noexcept try {
+    if (type == SQLITE_TRACE_PROFILE) {
+        auto* instrumentation = static_cast<Instrumentation*>(context);
+        auto* stmt = static_cast<sqlite3_stmt*>(p);
+        auto ns = *static_cast<sqlite3_int64*>(x);
+        if (sqlite3_stmt_isexplain(stmt)) {
+            return 0;  // The slow query log's own EXPLAIN QUERY PLAN
+        }
+
+        const char* sql = sqlite3_sql(stmt);
+        auto stats = instrumentation->stats(sql ? sql : "");
+        stats->phase(Phase::Execute).record(static_cast<uint64_t>(ns));
+        stats->executions.fetch_add(1, std::memory_order_relaxed);
+        stats->add_planner_counters(stmt);
+
+        if (stats->slow_log->is_slow(static_cast<uint64_t>(ns))) {
+            RunPhases phases;
+            phases.execute_ns = static_cast<uint64_t>(ns);
+            stats->slow_log->record(stmt, stats->sql, phases, 0, {});
+        }
+    }
+    return 0;
+} catch (...) {
+    return 0;
+}
+
+uint64_t per_run(uint64_t total, uint64_t runs) {
+    return runs == 0 ? total : total / runs;
+}
+
+} // namespace
+
+uint64_t HistogramSnapshot::percentile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    auto rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (const auto& bucket : buckets) {
+        seen += bucket.count;
+        if (seen >= rank) {
+            return std::min(bucket.upper_ns, max_ns);
+        }
+    }
+    return max_ns;
+}
+
+size_t LatencyHistogram::bucket_index(uint64_t ns) noexcept {
+    if (ns < sub_buckets) {
+        return static_cast<size_t>(ns);
+    }
+
+    if (ns >> max_exponent) {
+        return bucket_count - 1;
+    }
+
+    // The top sub_bucket_bits + 1 bits pick the bucket within the power of two
+    size_t exponent = static_cast<size_t>(std::bit_width(ns)) - 1;
+    size_t shift = exponent - sub_bucket_bits;
+    size_t mantissa = static_cast<size_t>(ns >> shift);
+    return (shift + 1) * sub_buckets + (mantissa - sub_buckets);
+}
+
+uint64_t LatencyHistogram::bucket_lower(size_t index) noexcept {
+    if (index < sub_buckets) {
+        return index;
+    }
+    size_t shift = index / sub_buckets - 1;
+    uint64_t mantissa = sub_buckets + index % sub_buckets;
+    return mantissa << shift;
+}
+
+uint64_t LatencyHistogram::bucket_upper(size_t index) noexcept {
+    if (index == bucket_count - 1) {
+        return UINT64_MAX;
+    }
+    return bucket_lower(index + 1) - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns) noexcept {
+    buckets_[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(ns, std::memory_order_relaxed);
+    update_min(min_, ns);
+    update_max(max_, ns);
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+    HistogramSnapshot snapshot;
+    for (size_t i = 0; i < bucket_count; ++i) {
+        auto count = buckets_[i].load(std::memory_order_relaxed);
+        if (count > 0) {
+            snapshot.buckets.push_back({bucket_lower(i), bucket_upper(i), count});
+            snapshot.count += count;
+        }
+    }
+    if (snapshot.count == 0) {
+        return snapshot;
+    }
+
+    // Taken from the buckets, so count and the percentiles agree even if
+    // values are recorded while this runs
+    snapshot.sum_ns = sum_.load(std::memory_order_relaxed);
+    snapshot.min_ns = min_.load(std::memory_order_relaxed);
+    snapshot.max_ns = max_.load(std::memory_order_relaxed);
+    snapshot.p50_ns = snapshot.percentile(0.50);
+    snapshot.p90_ns = snapshot.percentile(0.90);
+    snapshot.p99_ns = snapshot.percentile(0.99);
+    return snapshot;
+}
+
+void LatencyHistogram::reset() noexcept {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+void QueryStats::add_planner_counters(sqlite3_stmt* stmt) noexcept {
+    auto take = [stmt](int op) { return static_cast<uint64_t>(sqlite3_stmt_status(stmt, op, 1)); };
+    fullscan_steps.fetch_add(take(SQLITE_STMTSTATUS_FULLSCAN_STEP), std::memory_order_relaxed);
+    sorts.fetch_add(take(SQLITE_STMTSTATUS_SORT), std::memory_order_relaxed);
+    autoindexes.fetch_add(take(SQLITE_STMTSTATUS_AUTOINDEX), std::memory_order_relaxed);
+    vm_steps.fetch_add(take(SQLITE_STMTSTATUS_VM_STEP), std::memory_order_relaxed);
+}
+
+PlannerCounters QueryStats::planner() const noexcept {
+    PlannerCounters counters;
+    counters.fullscan_steps = fullscan_steps.load(std::memory_order_relaxed);
+    counters.sorts = sorts.load(std::memory_order_relaxed);
+    counters.autoindexes = autoindexes.load(std::memory_order_relaxed);
+    counters.vm_steps = vm_steps.load(std::memory_order_relaxed);
+    return counters;
+}
+
+const QueryShapeSnapshot* InstrumentationSnapshot::find(std::string_view sql) const {
+    auto it = std::ranges::find(queries, sql, &QueryShapeSnapshot::sql);
+    return it == queries.end() ? nullptr : &*it;
+}
+
+std::vector<SuspiciousQuery> InstrumentationSnapshot::suspicious(const SuspicionThresholds& thresholds) const {
+    std::vector<SuspiciousQuery> report;
+    for (const auto& shape : queries) {
+        const auto& planner = shape.planner;
+        const uint64_t runs = shape.executions;
+
+        std::vector<std::string> reasons;
+        if (per_run(planner.fullscan_steps, runs) >= thresholds.fullscan_steps_per_run) {
+            reasons.push_back("full table scan: " + std::to_string(per_run(planner.fullscan_steps, runs)) +
+                              " steps per run");
+        }
+        if (planner.autoindexes > 0) {
+            reasons.push_back("automatic index: " + std::to_string(per_run(planner.autoindexes, runs)) +
+                              " rows indexed per run");
+        }
+        if (planner.sorts > 0 && per_run(planner.vm_steps, runs) >= thresholds.sort_vm_steps_per_run) {
+            reasons.push_back("temp B-tree sort: " + std::to_string(planner.sorts) + " sorts in " +
+                              std::to_string(runs) + " runs");
+        }
+
+        if (!reasons.empty()) {
+            report.push_back({shape.sql, runs, planner, std::move(reasons)});
+        }
+    }
+
+    std::ranges::sort(report, std::ranges::greater{}, [](const SuspiciousQuery& query) {
+        return per_run(query.planner.vm_steps, query.executions);
+    });
+    return report;
+}
+
+std::string InstrumentationSnapshot::to_json() const {
+    auto json = glz::write_json(*this);
+    if (!json) {
+        return "{}";
+    }
+    return std::move(*json);
+}
+
+std::shared_ptr<QueryStats> Instrumentation::stats(std::string_view sql) {
+    std::lock_guard lock(mutex_);
+    auto it = queries_.find(sql);
+    if (it != queries_.end()) {
+        return it->second;
+    }
+    auto stats = std::make_shared<QueryStats>(std::string(sql), slow_log_);
+    return queries_.emplace(std::string(sql), std::move(stats)).first->second;
+}
+
+InstrumentationSnapshot Instrumentation::snapshot() const {
+    std::vector<std::shared_ptr<QueryStats>> queries;
+    {
+        std::lock_guard lock(mutex_);
+        queries.reserve(queries_.size());
+        for (const auto& [sql, stats] : queries_) {
+            queries.push_back(stats);
+        }
+    }
+
+    InstrumentationSnapshot snapshot;
+    snapshot.queries.reserve(queries.size());
+    for (const auto& stats : queries) {
+        auto& shape = snapshot.queries.emplace_back();
+        shape.sql = stats->sql;
+        shape.executions = stats->executions.load(std::memory_order_relaxed);
+        shape.rows = stats->rows.load(std::memory_order_relaxed);
+        shape.bytes = stats->bytes.load(std::memory_order_relaxed);
+        shape.emit = stats->phase(Phase::Emit).snapshot();
+        shape.prepare = stats->phase(Phase::Prepare).snapshot();
+        shape.step = stats->phase(Phase::Step).snapshot();
+        shape.decode = stats->phase(Phase::Decode).snapshot();
+        shape.execute = stats->phase(Phase::Execute).snapshot();
+        shape.planner = stats->planner();
+    }
+
+    std::ranges::sort(snapshot.queries, {}, &QueryShapeSnapshot::sql);
+    return snapshot;
+}
+
+void Instrumentation::reset() {
+    std::lock_guard lock(mutex_);
+    queries_.clear();
+}
+
+void Instrumentation::attach_trace(sqlite3* db) {
+    sqlite3_trace_v2(db, SQLITE_TRACE_PROFILE, trace_profile, this);
+}
+
+void Instrumentation::detach_trace(sqlite3* db) {
+    sqlite3_trace_v2(db, 0, nullptr, nullptr);
+}
+
+void QueryProbe::finish() noexcept {
+    if (!stats_) {
+        return;
+    }
+
+    stats_->executions.fetch_add(1, std::memory_order_relaxed);
+    stats_->rows.fetch_add(rows_, std::memory_order_relaxed);
+    stats_->bytes.fetch_add(bytes_, std::memory_order_relaxed);
+    stats_->phase(Phase::Step).record(phases_.step_ns);
+    if (rows_ > 0) {
+        stats_->phase(Phase::Decode).record(phases_.decode_ns);
+    }
+    if (stmt_) {
+        stats_->add_planner_counters(stmt_);
+        if (stats_->slow_log && stats_->slow_log->is_slow(phases_.total_ns())) {
+            // Building the entry allocates; if that fails the entry is
+            // skipped rather than escaping a noexcept function
+            try {
+                stats_->slow_log->record(stmt_, stats_->sql, phases_, rows_, parameter_types_);
+            } catch (...) {
+            }
+        }
+    }
+    stats_.reset();
+}
+
+} // namespace sqlgen::sqlite
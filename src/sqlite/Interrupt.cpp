@@ -0,0 +1,61 @@
+#include "sqlgen/sqlite/Interrupt.hpp"
+#include <string>
+#include <utility>
+
+namespace sqlgen::sqlite {
+
+namespace {
+
+// SQLite reports both a progress handler stop and sqlite3_interrupt() as
+// SQLITE_INTERRUPT. The handler runs on the thread stepping the statement,
+// so it leaves a note there for step_error to tell the two apart.
+thread_local bool deadline_fired = false;
+
+int64_t to_ns(QueryDeadline::Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+Error step_error(sqlite3* db, int rc, std::string_view what) {
+    if ((rc & 0xff) == SQLITE_INTERRUPT) {
+        bool deadline = std::exchange(deadline_fired, false);
+        return std::string(deadline ? deadline_exceeded_error : cancelled_error) + " (" + std::string(what) + ")";
+    }
+    return std::string(what) + ": " + sqlite3_errmsg(db);
+}
+
+void QueryDeadline::install(sqlite3* db) noexcept {
+    sqlite3_progress_handler(db, check_interval, on_progress, this);
+}
+
+void QueryDeadline::set(Clock::time_point deadline) noexcept {
+    deadline_ns_.store(to_ns(deadline), std::memory_order_relaxed);
+}
+
+std::optional<QueryDeadline::Clock::time_point> QueryDeadline::get() const noexcept {
+    int64_t ns = deadline_ns_.load(std::memory_order_relaxed);
+    if (ns == none) {
+        return std::nullopt;
+    }
+    return Clock::time_point(std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+int QueryDeadline::on_progress(void* self) noexcept {
+    int64_t deadline = static_cast<QueryDeadline*>(self)->deadline_ns_.load(std::memory_order_relaxed);
+    if (deadline == none || to_ns(Clock::now()) < deadline) {
+        return 0;
+    }
+    deadline_fired = true;
+    return 1;  // Stop the statement with SQLITE_INTERRUPT
+}
+
+void CancelHandle::cancel() const {
+    // Holding the connection open for the call; sqlite3_interrupt is only
+    // safe on an open connection
+    if (auto db = db_.lock()) {
+        sqlite3_interrupt(db.get());
+    }
+}
+
+} // namespace sqlgen::sqlite
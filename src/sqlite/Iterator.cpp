@@ -1,54 +1,142 @@
 #include "sqlgen/sqlite/Iterator.hpp"
-#include <cstring>
 
 namespace sqlgen::sqlite {
 
-Iterator::Iterator(sqlite3_stmt* stmt, sqlite3* conn)
+Iterator::Iterator(sqlite3_stmt* stmt, sqlite3* conn, QueryProbe probe)
     : end_(false),
       num_cols_(sqlite3_column_count(stmt)),
       stmt_(stmt, [](sqlite3_stmt* s) { if (s) sqlite3_finalize(s); }),
-      conn_(conn, [](sqlite3*) {}) // Don't close connection - it's owned elsewhere
+      conn_(conn, [](sqlite3*) {}), // Don't close connection - it's owned elsewhere
+      probe_(std::move(probe))
 {
     step();  // Step to first row
 }
 
+Iterator::Iterator(std::shared_ptr<sqlite3_stmt> stmt, sqlite3* conn, QueryProbe probe)
+    : end_(false),
+      num_cols_(sqlite3_column_count(stmt.get())),
+      stmt_(std::move(stmt)),
+      conn_(conn, [](sqlite3*) {}),
+      probe_(std::move(probe))
+{
+    step();  // Step to first row
+}
+
+Iterator& Iterator::operator=(Iterator&& other) noexcept {
+    if (this != &other) {
+        close();
+        end_ = other.end_;
+        num_cols_ = other.num_cols_;
+        error_ = std::move(other.error_);
+        stmt_ = std::move(other.stmt_);
+        conn_ = std::move(other.conn_);
+        probe_ = std::move(other.probe_);
+    }
+    return *this;
+}
+
+void Iterator::close() noexcept {
+    // The probe reads the statement's counters, so it goes first
+    probe_.finish();
+    if (stmt_ && !end_) {
+        sqlite3_reset(stmt_.get());
+    }
+}
+
 void Iterator::step() {
     if (end_) return;
 
-    int rc = sqlite3_step(stmt_.get());
+    int rc = probe_.time(Phase::Step, [&] { return sqlite3_step(stmt_.get()); });
     if (rc == SQLITE_ROW) {
-        end_ = false;
-    } else if (rc == SQLITE_DONE) {
-        end_ = true;
-    } else {
-        end_ = true;
+        probe_.add_row();
+        return;
+    }
+
+    end_ = true;
+    if (rc != SQLITE_DONE) {
+        error_ = step_error(sqlite3_db_handle(stmt_.get()), rc, "Failed to step statement");
     }
+    // Release the statement's read snapshot as soon as we're done with it
+    sqlite3_reset(stmt_.get());
+    probe_.finish();
 }
 
 std::optional<Iterator::Row> Iterator::next() {
-    if (end_) {
+    Row row;
+    if (!next(row)) {
         return std::nullopt;
     }
+    return row;
+}
 
-    Row row;
-    row.reserve(num_cols_);
+bool Iterator::next(Row& out) {
+    if (end_) {
+        return false;
+    }
 
+    if (probe_) {
+        probe_.add_bytes(probe_.time(Phase::Decode, [&] { return read_row(out); }));
+    } else {
+        read_row(out);
+    }
+
+    step();  // Move to next row
+    return true;
+}
+
+size_t Iterator::read_row(Row& out) {
+    size_t bytes = 0;
+    out.resize(num_cols_);
     for (int i = 0; i < num_cols_; ++i) {
+        auto& cell = out[i];
         if (sqlite3_column_type(stmt_.get(), i) == SQLITE_NULL) {
-            row.push_back(std::nullopt);
+            cell.reset();
+            continue;
+        }
+
+        const char* text = reinterpret_cast<const char*>(
+            sqlite3_column_text(stmt_.get(), i));
+        if (!text) {
+            cell.reset();
+            continue;
+        }
+
+        size_t size = static_cast<size_t>(sqlite3_column_bytes(stmt_.get(), i));
+        if (cell) {
+            cell->assign(text, size);  // Reuses the existing capacity
         } else {
-            const char* text = reinterpret_cast<const char*>(
-                sqlite3_column_text(stmt_.get(), i));
-            if (text) {
-                row.push_back(std::string(text));
-            } else {
-                row.push_back(std::nullopt);
-            }
+            cell.emplace(text, size);
         }
+        bytes += size;
     }
+    return bytes;
+}
 
-    step();  // Move to next row
-    return row;
+Result<std::vector<Iterator::Row>> Iterator::collect() {
+    std::vector<Row> rows;
+    Row row;
+    while (next(row)) {
+        rows.push_back(std::move(row));
+    }
+    if (error_) {
+        return error(*error_);
+    }
+    return rows;
+}
+
+size_t Iterator::next_batch(std::vector<Row>& rows, size_t n) {
+    size_t count = 0;
+    while (count < n && !end_) {
+        if (count == rows.size()) {
+            rows.emplace_back();
+        }
+        next(rows[count]);
+        ++count;
+    }
+
+    // Only shrinks on the final, partial batch
+    rows.resize(count);
+    return count;
 }
 
 } // namespace sqlgen::sqlite
@@ -0,0 +1,161 @@
+#include "sqlgen/sqlite/SlowQueryLog.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <unordered_map>
+
+namespace sqlgen::sqlite {
+
+namespace {
+
+std::string milliseconds(uint64_t ns) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3f ms", static_cast<double>(ns) / 1e6);
+    return buffer;
+}
+
+} // namespace
+
+const char* type_name(int type) noexcept {
+    switch (type) {
+        case SQLITE_INTEGER:
+            return "INTEGER";
+        case SQLITE_FLOAT:
+            return "REAL";
+        case SQLITE_TEXT:
+            return "TEXT";
+        case SQLITE_BLOB:
+            return "BLOB";
+        default:
+            return "NULL";
+    }
+}
+
+void SlowQueryLog::configure(std::chrono::nanoseconds threshold, size_t capacity) {
+    {
+        std::lock_guard lock(mutex_);
+        if (entries_.size() == capacity_ && next_ != 0) {
+            // Unwrap so the entries run oldest to newest
+            std::ranges::rotate(entries_, entries_.begin() + static_cast<ptrdiff_t>(next_));
+        }
+        if (entries_.size() > capacity) {
+            entries_.erase(entries_.begin(), entries_.end() - static_cast<ptrdiff_t>(capacity));
+        }
+        capacity_ = capacity;
+        next_ = entries_.size() == capacity_ ? 0 : entries_.size();
+    }
+    threshold_ns_.store(static_cast<uint64_t>(std::max<int64_t>(threshold.count(), 0)), std::memory_order_relaxed);
+}
+
+void SlowQueryLog::record(sqlite3_stmt* stmt, const std::string& sql, const RunPhases& phases, uint64_t rows,
+                          const std::vector<int>& parameter_types) {
+    SlowQuery entry;
+    entry.sql = sql;
+    entry.parameter_types.reserve(parameter_types.size());
+    for (int type : parameter_types) {
+        entry.parameter_types.emplace_back(type_name(type));
+    }
+    entry.phases = phases;
+    entry.rows = rows;
+    entry.plan = explain(sqlite3_db_handle(stmt), sql);
+    entry.finished_at = std::chrono::system_clock::now();
+    record(std::move(entry));
+}
+
+void SlowQueryLog::record(SlowQuery entry) {
+    std::lock_guard lock(mutex_);
+    ++total_;
+    if (capacity_ == 0) {
+        return;
+    }
+
+    if (entries_.size() < capacity_) {
+        entries_.push_back(std::move(entry));
+        next_ = entries_.size() % capacity_;
+    } else {
+        entries_[next_] = std::move(entry);
+        next_ = (next_ + 1) % capacity_;
+    }
+}
+
+std::vector<SlowQuery> SlowQueryLog::entries() const {
+    std::lock_guard lock(mutex_);
+    if (entries_.size() < capacity_) {
+        return entries_;
+    }
+
+    std::vector<SlowQuery> ordered;
+    ordered.reserve(entries_.size());
+    ordered.insert(ordered.end(), entries_.begin() + static_cast<ptrdiff_t>(next_), entries_.end());
+    ordered.insert(ordered.end(), entries_.begin(), entries_.begin() + static_cast<ptrdiff_t>(next_));
+    return ordered;
+}
+
+uint64_t SlowQueryLog::total() const {
+    std::lock_guard lock(mutex_);
+    return total_;
+}
+
+void SlowQueryLog::clear() {
+    std::lock_guard lock(mutex_);
+    entries_.clear();
+    next_ = 0;
+    total_ = 0;
+}
+
+std::string SlowQueryLog::dump() const {
+    std::string out;
+    for (const auto& entry : entries()) {
+        const auto& p = entry.phases;
+        auto unix_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            entry.finished_at.time_since_epoch()).count();
+
+        out += "slow query at " + std::to_string(unix_ms) + " (unix ms): " + milliseconds(p.total_ns()) +
+               ", " + std::to_string(entry.rows) + " rows\n";
+        out += "  sql: " + entry.sql + "\n";
+        if (!entry.parameter_types.empty()) {
+            out += "  parameters:";
+            for (const auto& type : entry.parameter_types) {
+                out += " " + type;
+            }
+            out += "\n";
+        }
+        out += "  phases: emit " + milliseconds(p.emit_ns) + ", prepare " + milliseconds(p.prepare_ns) +
+               ", step " + milliseconds(p.step_ns) + ", decode " + milliseconds(p.decode_ns) +
+               ", execute " + milliseconds(p.execute_ns) + "\n";
+        if (!entry.plan.empty()) {
+            out += "  plan:\n";
+            for (const auto& line : entry.plan) {
+                out += "    " + line + "\n";
+            }
+        }
+    }
+    return out;
+}
+
+std::vector<std::string> SlowQueryLog::explain(sqlite3* db, const std::string& sql) {
+    std::vector<std::string> plan;
+    std::string explain_sql = "EXPLAIN QUERY PLAN " + sql;
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, explain_sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return plan;
+    }
+
+    // Rows are (id, parent, notused, detail); parent 0 is the top level
+    std::unordered_map<int, size_t> depth_of;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        int id = sqlite3_column_int(stmt, 0);
+        int parent = sqlite3_column_int(stmt, 1);
+        auto found = depth_of.find(parent);
+        size_t depth = found == depth_of.end() ? 0 : found->second + 1;
+        depth_of[id] = depth;
+
+        const auto* detail = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+        plan.push_back(std::string(depth * 2, ' ') + (detail ? detail : ""));
+    }
+    sqlite3_finalize(stmt);
+    return plan;
+}
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,109 @@
+#include "sqlgen/sqlite/Statement.hpp"
+
+namespace sqlgen::sqlite {
+
+Result<Nothing> Statement::check_bind(int rc, int index, int type) {
+    if (rc != SQLITE_OK) {
+        std::string err_msg = sqlite3_errmsg(sqlite3_db_handle(stmt_.get()));
+        return error("Failed to bind parameter " + std::to_string(index) + ": " + err_msg);
+    }
+
+    // SQLite can't report what was bound, so the slow query log relies on this
+    if (stats_) {
+        if (bound_types_.size() < static_cast<size_t>(index)) {
+            bound_types_.resize(static_cast<size_t>(index), SQLITE_NULL);
+        }
+        bound_types_[static_cast<size_t>(index - 1)] = type;
+    }
+    return Nothing{};
+}
+
+Result<Nothing> Statement::bind_null(int index) {
+    return check_bind(sqlite3_bind_null(stmt_.get(), index), index, SQLITE_NULL);
+}
+
+Result<Nothing> Statement::bind(int index, int64_t value) {
+    return check_bind(sqlite3_bind_int64(stmt_.get(), index, value), index, SQLITE_INTEGER);
+}
+
+Result<Nothing> Statement::bind(int index, double value) {
+    return check_bind(sqlite3_bind_double(stmt_.get(), index, value), index, SQLITE_FLOAT);
+}
+
+Result<Nothing> Statement::bind(int index, std::string_view value) {
+    int rc = sqlite3_bind_text64(stmt_.get(), index, value.data(), value.size(),
+                                 SQLITE_TRANSIENT, SQLITE_UTF8);
+    return check_bind(rc, index, SQLITE_TEXT);
+}
+
+Result<Nothing> Statement::bind(int index, std::span<const std::byte> value) {
+    int rc = sqlite3_bind_blob64(stmt_.get(), index, value.data(), value.size(),
+                                 SQLITE_TRANSIENT);
+    return check_bind(rc, index, SQLITE_BLOB);
+}
+
+Result<Nothing> Statement::reset() {
+    if (sqlite3_reset(stmt_.get()) != SQLITE_OK) {
+        // sqlite3_reset reports the error of the last step; the statement
+        // itself is reset regardless
+        return error("Failed to reset statement: " +
+                     std::string(sqlite3_errmsg(sqlite3_db_handle(stmt_.get()))));
+    }
+    return Nothing{};
+}
+
+Result<Nothing> Statement::clear_bindings() {
+    sqlite3_clear_bindings(stmt_.get());
+    bound_types_.clear();
+    return Nothing{};
+}
+
+Result<Nothing> Statement::execute() {
+    const uint64_t start = stats_ ? now_ns() : 0;
+
+    int rc;
+    while ((rc = sqlite3_step(stmt_.get())) == SQLITE_ROW) {
+        // Discard result rows
+    }
+
+    if (stats_) {
+        RunPhases phases = std::exchange(setup_, {});
+        phases.execute_ns = now_ns() - start;
+        stats_->phase(Phase::Execute).record(phases.execute_ns);
+        stats_->executions.fetch_add(1, std::memory_order_relaxed);
+        stats_->add_planner_counters(stmt_.get());
+        if (stats_->slow_log && stats_->slow_log->is_slow(phases.total_ns())) {
+            stats_->slow_log->record(stmt_.get(), stats_->sql, phases, 0, parameter_types());
+        }
+    }
+
+    if (rc != SQLITE_DONE) {
+        auto err = step_error(sqlite3_db_handle(stmt_.get()), rc, "Failed to execute statement");
+        sqlite3_reset(stmt_.get());
+        return error(err);
+    }
+
+    sqlite3_reset(stmt_.get());
+    return Nothing{};
+}
+
+Result<Iterator> Statement::query() {
+    // Start from the first row even if the statement was stepped before
+    sqlite3_reset(stmt_.get());
+    return Iterator(stmt_, sqlite3_db_handle(stmt_.get()), probe());
+}
+
+QueryProbe Statement::probe() {
+    if (!stats_) {
+        return {};
+    }
+    return QueryProbe(stats_, stmt_.get(), std::exchange(setup_, {}), parameter_types());
+}
+
+std::vector<int> Statement::parameter_types() const {
+    std::vector<int> types = bound_types_;
+    types.resize(static_cast<size_t>(parameter_count()), SQLITE_NULL);
+    return types;
+}
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,61 @@
+#include "sqlgen/sqlite/StatementCache.hpp"
+
+namespace sqlgen::sqlite {
+
+std::shared_ptr<sqlite3_stmt> StatementCache::find(const StatementKey& key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+}
+
+void StatementCache::insert(StatementKey key, std::shared_ptr<sqlite3_stmt> stmt) {
+    if (capacity_ == 0) {
+        return;
+    }
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        it->second->second = std::move(stmt);
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+
+    evict_to(capacity_ - 1);
+    entries_.emplace_front(key, std::move(stmt));
+    index_.emplace(std::move(key), entries_.begin());
+}
+
+void StatementCache::clear() {
+    index_.clear();
+    entries_.clear();
+}
+
+void StatementCache::set_capacity(size_t capacity) {
+    capacity_ = capacity;
+    evict_to(capacity_);
+}
+
+StatementCacheStats StatementCache::stats() const {
+    StatementCacheStats stats = stats_;
+    stats.size = entries_.size();
+    stats.capacity = capacity_;
+    return stats;
+}
+
+void StatementCache::evict_to(size_t size) {
+    while (entries_.size() > size) {
+        // A statement still held by a Statement/Iterator stays alive until
+        // its last owner releases it
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+} // namespace sqlgen::sqlite
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Sample {
+    int64_t id;
+    double reading;
+};
+
+class AsyncTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(conn_.execute(create_table<Sample>()).has_value());
+        std::vector<Sample> rows;
+        for (int64_t i = 1; i <= 10; ++i) {
+            rows.push_back({i, static_cast<double>(i) * 1.5});
+        }
+        ASSERT_TRUE(conn_.insert_all(rows).has_value());
+    }
+
+    sqlite::Connection conn_{std::move(sqlite::connect(":memory:").value())};
+};
+
+sqlite::Task<Result<std::vector<Sample>>> fetch(sqlite::Connection& conn, sqlite::Executor& executor,
+                                                size_t yield_every) {
+    co_return co_await conn.async_query<Sample>(select_from<Sample>() | order_by("id"_c), executor, yield_every);
+}
+
+TEST_F(AsyncTest, QueryResumesWithDecodedRows) {
+    sqlite::ManualExecutor executor;
+    auto task = fetch(conn_, executor, 0);
+    task.start();
+
+    // Nothing runs until the executor is driven
+    EXPECT_FALSE(task.done());
+    EXPECT_EQ(executor.pending(), 1u);
+
+    executor.run();
+    ASSERT_TRUE(task.done());
+    ASSERT_TRUE(task.result().has_value()) << task.result().error();
+    ASSERT_EQ(task.result()->size(), 10u);
+    EXPECT_DOUBLE_EQ(task.result()->at(9).reading, 15.0);
+}
+
+TEST_F(AsyncTest, LongScanYieldsBetweenSlices) {
+    sqlite::ManualExecutor executor;
+    auto task = fetch(conn_, executor, 3);
+    task.start();
+
+    // Work posted while the scan runs gets a turn between slices
+    std::vector<int> order;
+    executor.run_one();  // rows 1-3
+    executor.post([&] { order.push_back(1); });
+    EXPECT_FALSE(task.done());
+    executor.run_one();  // rows 4-6
+    executor.run_one();  // The other work item
+    EXPECT_EQ(order.size(), 1u);
+
+    // Four slices in all: 3 + 3 + 3 + 1 rows, the last one finding the end
+    EXPECT_EQ(executor.run(), 2u);
+    ASSERT_TRUE(task.done());
+    EXPECT_EQ(task.result()->size(), 10u);
+}
+
+TEST_F(AsyncTest, ErrorsResumeWithResult) {
+    sqlite::ManualExecutor executor;
+    auto task = [](sqlite::Connection& conn, sqlite::Executor& ex) -> sqlite::Task<Result<std::vector<int64_t>>> {
+        co_return co_await conn.async_query<int64_t>(std::string("SELECT nope FROM Sample"), ex);
+    }(conn_, executor);
+    task.start();
+    executor.run();
+
+    ASSERT_TRUE(task.done());
+    EXPECT_FALSE(task.result().has_value());
+}
+
+TEST_F(AsyncTest, ExecuteAndQueryInSequence) {
+    sqlite::ManualExecutor executor;
+    auto task = [](sqlite::Connection& conn, sqlite::Executor& ex) -> sqlite::Task<Result<size_t>> {
+        auto deleted = co_await conn.async_execute(delete_from<Sample>() | where("id"_c > 4), ex);
+        if (!deleted) {
+            co_return error(deleted.error());
+        }
+        auto rows = co_await conn.async_query<Sample>(select_from<Sample>(), ex);
+        if (!rows) {
+            co_return error(rows.error());
+        }
+        co_return rows->size();
+    }(conn_, executor);
+    task.start();
+    executor.run();
+
+    ASSERT_TRUE(task.done());
+    ASSERT_TRUE(task.result().has_value());
+    EXPECT_EQ(*task.result(), 4u);
+}
+
+TEST_F(AsyncTest, RunsOnThreadPoolAndResumesOnCaller) {
+    sqlite::ThreadPoolExecutor pool(2);
+    sqlite::ManualExecutor loop;
+
+    std::thread::id ran_on;
+    auto task = [](sqlite::Connection& conn, sqlite::Executor& workers, sqlite::Executor& loop,
+                   std::thread::id& ran_on) -> sqlite::Task<Result<std::vector<Sample>>> {
+        auto rows = co_await conn.async_query<Sample>(select_from<Sample>(), workers, 4).resume_on(loop);
+        ran_on = std::this_thread::get_id();
+        co_return rows;
+    }(conn_, pool, loop, ran_on);
+    task.start();
+
+    // The query runs on the pool; the continuation waits for the loop
+    while (!task.done()) {
+        loop.run_one();
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(ran_on, std::this_thread::get_id());
+    ASSERT_TRUE(task.result().has_value());
+    EXPECT_EQ(task.result()->size(), 10u);
+}
+
+} // namespace sqlgen::test
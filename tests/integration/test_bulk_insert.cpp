@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+#include "sqlgen/constraints.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Reading {
+    PrimaryKey<int64_t> id;
+    std::string sensor;
+    double value;
+    std::optional<std::string> note;
+};
+
+class BulkInsertTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(conn_.execute(create_table<Reading>()).has_value());
+    }
+
+    static std::vector<Reading> make_rows(int64_t first, size_t count) {
+        std::vector<Reading> rows;
+        for (size_t i = 0; i < count; ++i) {
+            int64_t id = first + static_cast<int64_t>(i);
+            rows.push_back(Reading{PrimaryKey<int64_t>{id}, "s" + std::to_string(id % 7),
+                                   static_cast<double>(id) * 0.5,
+                                   id % 2 ? std::optional<std::string>("odd") : std::nullopt});
+        }
+        return rows;
+    }
+
+    int64_t count() {
+        auto iter = conn_.query<int64_t>(std::string("SELECT COUNT(*) FROM Reading"));
+        EXPECT_TRUE(iter.has_value());
+        return iter->next().value().value_or(-1);
+    }
+
+    sqlite::Connection conn_{std::move(sqlite::connect(":memory:").value())};
+};
+
+TEST_F(BulkInsertTest, InsertsAllRowsInChunks) {
+    auto rows = make_rows(1, 2500);
+    auto result = conn_.insert_all(std::span<const Reading>(rows), 1000);
+    ASSERT_TRUE(result.has_value()) << result.error();
+    EXPECT_EQ(count(), 2500);
+
+    auto back = conn_.query<Reading>(select_from<Reading>() | where("id"_c == 7))->collect();
+    ASSERT_TRUE(back.has_value());
+    ASSERT_EQ(back->size(), 1u);
+    EXPECT_EQ(back->at(0).sensor, "s0");
+    EXPECT_DOUBLE_EQ(back->at(0).value, 3.5);
+    EXPECT_EQ(back->at(0).note, "odd");
+}
+
+TEST_F(BulkInsertTest, AcceptsContiguousRanges) {
+    auto rows = make_rows(1, 10);
+    ASSERT_TRUE(conn_.insert_all(rows).has_value());
+    EXPECT_EQ(count(), 10);
+}
+
+TEST_F(BulkInsertTest, EmptyInputIsNoop) {
+    std::vector<Reading> rows;
+    EXPECT_TRUE(conn_.insert_all(rows).has_value());
+    EXPECT_EQ(count(), 0);
+}
+
+TEST_F(BulkInsertTest, FailureRollsBackCurrentChunkOnly) {
+    auto rows = make_rows(1, 25);
+    rows[22].id = 3;  // Duplicate key in the third chunk
+
+    auto result = conn_.insert_all(rows, 10);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_FALSE(result.error().empty());
+    EXPECT_EQ(count(), 20);
+
+    // The connection is usable and no transaction is left open
+    ASSERT_TRUE(conn_.insert_all(make_rows(100, 5)).has_value());
+    EXPECT_EQ(count(), 25);
+}
+
+TEST_F(BulkInsertTest, JoinsCallerTransaction) {
+    ASSERT_TRUE(conn_.begin_transaction().has_value());
+    ASSERT_TRUE(conn_.insert_all(make_rows(1, 30), 10).has_value());
+    ASSERT_TRUE(conn_.rollback().has_value());
+    EXPECT_EQ(count(), 0);
+}
+
+TEST_F(BulkInsertTest, ReusesCachedInsertStatement) {
+    ASSERT_TRUE(conn_.insert_all(make_rows(1, 5)).has_value());
+    auto before = conn_.statement_cache_stats();
+    ASSERT_TRUE(conn_.insert_all(make_rows(6, 5)).has_value());
+    auto after = conn_.statement_cache_stats();
+    EXPECT_EQ(after.misses, before.misses);
+    EXPECT_EQ(count(), 10);
+}
+
+TEST_F(BulkInsertTest, MultiRowValues) {
+    auto rows = make_rows(1, 53);
+    // A chunk of 10 caps each statement at 10 rows: 5 batched statements
+    // plus 3 single-row inserts
+    auto result = conn_.insert_batched(rows, 10);
+    ASSERT_TRUE(result.has_value()) << result.error();
+    EXPECT_EQ(count(), 53);
+
+    auto back = conn_.query<Reading>(select_from<Reading>() | order_by("id"_c))->collect();
+    ASSERT_TRUE(back.has_value());
+    ASSERT_EQ(back->size(), 53u);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(back->at(i).id.get(), rows[i].id.get());
+        EXPECT_EQ(back->at(i).sensor, rows[i].sensor);
+        EXPECT_EQ(back->at(i).note, rows[i].note);
+    }
+}
+
+TEST_F(BulkInsertTest, MultiRowFailureRollsBackChunk) {
+    auto rows = make_rows(1, 30);
+    rows[25].id = 1;
+
+    EXPECT_FALSE(conn_.insert_batched(rows, 10).has_value());
+    EXPECT_EQ(count(), 20);
+}
+
+TEST_F(BulkInsertTest, MaxInsertRowsFollowsVariableLimit) {
+    size_t rows = conn_.max_insert_rows<Reading>();
+    ASSERT_GE(rows, 1u);
+    EXPECT_TRUE(conn_.prepare(insert<Reading>().rows(rows)).has_value());
+    EXPECT_FALSE(conn_.prepare(insert<Reading>().rows(rows + 1)).has_value());
+
+    // Cached statements: one single-row and one batched
+    ASSERT_TRUE(conn_.insert_batched(make_rows(1, 25), 10).has_value());
+    auto before = conn_.statement_cache_stats();
+    ASSERT_TRUE(conn_.insert_batched(make_rows(100, 25), 10).has_value());
+    EXPECT_EQ(conn_.statement_cache_stats().misses, before.misses);
+}
+
+} // namespace sqlgen::test
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <thread>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+
+using namespace std::chrono_literals;
+
+namespace sqlgen::test {
+
+struct Ledger {
+    int64_t id;
+    int64_t amount;
+};
+
+class BusyPolicyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = ::testing::TempDir() + "glz_sqlgen_busy_" +
+                ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".db";
+        remove_files();
+
+        auto setup = sqlite::connect(path_);
+        ASSERT_TRUE(setup.has_value());
+        ASSERT_TRUE(setup->execute(create_table<Ledger>()).has_value());
+    }
+
+    void TearDown() override {
+        remove_files();
+    }
+
+    void remove_files() {
+        for (const char* suffix : {"", "-wal", "-shm", "-journal"}) {
+            std::remove((path_ + suffix).c_str());
+        }
+    }
+
+    static sqlite::BusyPolicy quick_policy(std::chrono::milliseconds max_wait) {
+        sqlite::BusyPolicy policy;
+        policy.max_wait = max_wait;
+        policy.initial_backoff = 200us;
+        policy.max_backoff = 5ms;
+        return policy;
+    }
+
+    const std::string insert_sql = "INSERT INTO Ledger (id, amount) VALUES (1, 100)";
+    std::string path_;
+};
+
+TEST_F(BusyPolicyTest, FailsImmediatelyWithoutPolicy) {
+    auto holder = sqlite::connect(path_);
+    auto writer = sqlite::connect(path_);
+    ASSERT_TRUE(holder.has_value() && writer.has_value());
+    ASSERT_TRUE(holder->execute(std::string("BEGIN IMMEDIATE")).has_value());
+
+    auto start = std::chrono::steady_clock::now();
+    auto inserted = writer->execute(insert_sql);
+    ASSERT_FALSE(inserted.has_value());
+    EXPECT_NE(inserted.error().find("locked"), std::string::npos) << inserted.error();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+    EXPECT_EQ(writer->contention_stats().busy_events, 0u);
+}
+
+TEST_F(BusyPolicyTest, GivesUpAfterMaxWait) {
+    auto holder = sqlite::connect(path_);
+    auto writer = sqlite::connect(path_);
+    ASSERT_TRUE(holder.has_value() && writer.has_value());
+    writer->set_busy_policy(quick_policy(60ms));
+    ASSERT_TRUE(holder->execute(std::string("BEGIN IMMEDIATE")).has_value());
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(writer->execute(insert_sql).has_value());
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, 55ms);
+    EXPECT_LT(elapsed, 5s);
+
+    auto stats = writer->contention_stats();
+    EXPECT_EQ(stats.busy_events, 1u);
+    EXPECT_GT(stats.retries, 1u);
+    EXPECT_EQ(stats.timeouts, 1u);
+    EXPECT_GT(stats.wait_ns, 0u);
+    EXPECT_LE(stats.wait_ns, stats.max_wait_ns);
+}
+
+TEST_F(BusyPolicyTest, WaitsForLockToBeReleased) {
+    auto holder = sqlite::connect(path_);
+    auto writer = sqlite::connect(path_);
+    ASSERT_TRUE(holder.has_value() && writer.has_value());
+    writer->set_busy_policy(quick_policy(5s));
+    ASSERT_TRUE(holder->execute(std::string("BEGIN IMMEDIATE")).has_value());
+
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(30ms);
+        (void)holder->commit();
+    });
+    auto inserted = writer->execute(insert_sql);
+    releaser.join();
+
+    ASSERT_TRUE(inserted.has_value()) << inserted.error();
+    auto stats = writer->contention_stats();
+    EXPECT_GE(stats.busy_events, 1u);
+    EXPECT_GT(stats.retries, 0u);
+    EXPECT_EQ(stats.timeouts, 0u);
+    EXPECT_GE(stats.max_wait_ns, 20'000'000u);
+}
+
+TEST_F(BusyPolicyTest, StatementOutlivesConnection) {
+    auto holder = sqlite::connect(path_);
+    ASSERT_TRUE(holder.has_value());
+
+    std::optional<sqlite::Statement> insert;
+    {
+        auto writer = sqlite::connect(path_);
+        ASSERT_TRUE(writer.has_value());
+        writer->set_busy_policy(quick_policy(5s));
+        auto prepared = writer->prepare(insert_sql);
+        ASSERT_TRUE(prepared.has_value()) << prepared.error();
+        insert.emplace(std::move(*prepared));
+    }
+    ASSERT_TRUE(holder->execute(std::string("BEGIN IMMEDIATE")).has_value());
+
+    // The busy policy went with the Connection, so the lock is not waited for
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(insert->execute().has_value());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
+
+TEST_F(BusyPolicyTest, StatementOutlivesMovedOverOrClearedPolicy) {
+    auto holder = sqlite::connect(path_);
+    auto writer = sqlite::connect(path_);
+    auto other = sqlite::connect(path_);
+    ASSERT_TRUE(holder.has_value() && writer.has_value() && other.has_value());
+    writer->set_busy_policy(quick_policy(5s));
+    other->set_busy_policy(quick_policy(5s));
+
+    auto moved_over = writer->prepare(insert_sql);
+    auto cleared = other->prepare(insert_sql);
+    ASSERT_TRUE(moved_over.has_value() && cleared.has_value());
+    *writer = std::move(sqlite::connect(path_).value());
+    other->clear_busy_policy();
+
+    ASSERT_TRUE(holder->execute(std::string("BEGIN IMMEDIATE")).has_value());
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(moved_over->execute().has_value());
+    EXPECT_FALSE(cleared->execute().has_value());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
+
+TEST_F(BusyPolicyTest, CommitRetriedUntilReadersFinish) {
+    // In rollback journal mode a commit needs every reader gone
+    auto reader = sqlite::connect(path_);
+    auto writer = sqlite::connect(path_);
+    ASSERT_TRUE(reader.has_value() && writer.has_value());
+    writer->set_busy_policy(quick_policy(5s));
+
+    ASSERT_TRUE(writer->begin_transaction().has_value());
+    ASSERT_TRUE(writer->execute(insert_sql).has_value());
+
+    ASSERT_TRUE(reader->execute(std::string("BEGIN")).has_value());
+    auto rows = reader->query(std::string("SELECT * FROM Ledger"));
+    ASSERT_TRUE(rows.has_value());
+
+    std::thread finisher([&] {
+        std::this_thread::sleep_for(30ms);
+        (void)reader->commit();
+    });
+    auto committed = writer->commit();
+    finisher.join();
+
+    ASSERT_TRUE(committed.has_value()) << committed.error();
+    EXPECT_FALSE(writer->in_transaction());
+    EXPECT_GT(writer->contention_stats().retries, 0u);
+}
+
+TEST_F(BusyPolicyTest, PolicyFromConnectionOptions) {
+    sqlite::ConnectionOptions options;
+    options.busy_timeout = 1000ms;
+    options.busy_policy = quick_policy(250ms);
+
+    auto conn = sqlite::connect(path_, options);
+    ASSERT_TRUE(conn.has_value()) << conn.error();
+
+    auto applied = conn->options();
+    ASSERT_TRUE(applied.has_value());
+    ASSERT_TRUE(applied->busy_policy.has_value());
+    EXPECT_EQ(applied->busy_policy->max_wait, 250ms);
+    EXPECT_EQ(applied->busy_timeout, 0ms);  // Replaced by the policy
+
+    conn->clear_busy_policy();
+    EXPECT_FALSE(conn->busy_policy().has_value());
+}
+
+TEST(BusyPolicyBackoff, GrowsToCap) {
+    sqlite::BusyPolicy policy;
+    policy.initial_backoff = 100us;
+    policy.max_backoff = 1ms;
+    policy.multiplier = 2.0;
+
+    EXPECT_EQ(policy.backoff(0), 100us);
+    EXPECT_EQ(policy.backoff(1), 200us);
+    EXPECT_EQ(policy.backoff(3), 800us);
+    EXPECT_EQ(policy.backoff(4), 1ms);
+    EXPECT_EQ(policy.backoff(40), 1ms);
+}
+
+} // namespace sqlgen::test
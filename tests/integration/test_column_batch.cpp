@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <numeric>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+#include "sqlgen/constraints.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Trade {
+    PrimaryKey<int64_t> id;
+    Varchar<8> symbol;
+    double price;
+    std::optional<int64_t> qty;
+    bool settled;
+};
+
+struct Totals {
+    int64_t settled;
+    double total;
+};
+
+struct Qty {
+    int64_t qty;
+};
+
+struct SmallQty {
+    uint8_t qty;
+};
+
+class ColumnBatchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(conn_.execute(create_table<Trade>()).has_value());
+        ASSERT_TRUE(conn_.execute(std::string(
+            "INSERT INTO Trade VALUES "
+            "(1, 'AAPL', 10.5, 100, 1), "
+            "(2, 'MSFT', 20.25, NULL, 0), "
+            "(3, 'GOOG', 30.0, 300, 1), "
+            "(4, 'AMZN', 40.75, 400, 0), "
+            "(5, 'NVDA', 50.0, NULL, 1)")).has_value());
+    }
+
+    sqlite::Connection conn_{std::move(sqlite::connect(":memory:").value())};
+};
+
+TEST_F(ColumnBatchTest, SingleBatchHoldsDenseColumns) {
+    auto iter = conn_.fetch_columns<Trade>(select_from<Trade>() | order_by("id"_c), 0);
+    ASSERT_TRUE(iter.has_value()) << iter.error();
+
+    sqlite::ColumnBatch<Trade> batch;
+    auto has_rows = iter->next(batch);
+    ASSERT_TRUE(has_rows.has_value()) << has_rows.error();
+    ASSERT_TRUE(*has_rows);
+    ASSERT_EQ(batch.size(), 5u);
+
+    const std::vector<int64_t>& ids = batch.column<0>();
+    EXPECT_EQ(ids, (std::vector<int64_t>{1, 2, 3, 4, 5}));
+
+    const std::vector<double>& prices = batch.column<"price">();
+    EXPECT_DOUBLE_EQ(std::accumulate(prices.begin(), prices.end(), 0.0), 151.5);
+
+    const sqlite::TextColumn& symbols = batch.column<"symbol">();
+    ASSERT_EQ(symbols.size(), 5u);
+    EXPECT_EQ(symbols[0], "AAPL");
+    EXPECT_EQ(symbols[4], "NVDA");
+    EXPECT_EQ(symbols.bytes, "AAPLMSFTGOOGAMZNNVDA");
+
+    const std::vector<uint8_t>& settled = batch.column<"settled">();
+    EXPECT_EQ(settled, (std::vector<uint8_t>{1, 0, 1, 0, 1}));
+
+    constexpr size_t qty = sqlite::ColumnBatch<Trade>::index_of<"qty">;
+    EXPECT_EQ(batch.column<qty>(), (std::vector<int64_t>{100, 0, 300, 400, 0}));
+    EXPECT_EQ(batch.nulls<qty>(), (std::vector<uint8_t>{0, 1, 0, 0, 1}));
+    EXPECT_TRUE(batch.nulls<0>().empty());
+
+    auto done = iter->next(batch);
+    ASSERT_TRUE(done.has_value());
+    EXPECT_FALSE(*done);
+    EXPECT_TRUE(batch.empty());
+}
+
+TEST_F(ColumnBatchTest, FixedSizeBatches) {
+    auto iter = conn_.fetch_columns<Trade>(select_from<Trade>() | order_by("id"_c), 2);
+    ASSERT_TRUE(iter.has_value());
+
+    sqlite::ColumnBatch<Trade> batch;
+    std::vector<size_t> sizes;
+    std::vector<int64_t> ids;
+    while (true) {
+        auto has_rows = iter->next(batch);
+        ASSERT_TRUE(has_rows.has_value());
+        if (!*has_rows) break;
+        sizes.push_back(batch.size());
+        ids.insert(ids.end(), batch.column<0>().begin(), batch.column<0>().end());
+    }
+
+    EXPECT_EQ(sizes, (std::vector<size_t>{2, 2, 1}));
+    EXPECT_EQ(ids, (std::vector<int64_t>{1, 2, 3, 4, 5}));
+    EXPECT_TRUE(iter->end());
+}
+
+TEST_F(ColumnBatchTest, AggregateProjection) {
+    auto iter = conn_.fetch_columns<Totals>(
+        std::string("SELECT settled, SUM(price) AS total FROM Trade GROUP BY settled ORDER BY settled"), 0);
+    ASSERT_TRUE(iter.has_value());
+
+    sqlite::ColumnBatch<Totals> batch;
+    ASSERT_TRUE(iter->next(batch).value());
+    EXPECT_EQ(batch.column<"settled">(), (std::vector<int64_t>{0, 1}));
+    EXPECT_DOUBLE_EQ(batch.column<"total">()[0], 61.0);
+    EXPECT_DOUBLE_EQ(batch.column<"total">()[1], 90.5);
+}
+
+TEST_F(ColumnBatchTest, NullInRequiredFieldFails) {
+    auto iter = conn_.fetch_columns<Qty>(std::string("SELECT qty FROM Trade ORDER BY id"), 0);
+    ASSERT_TRUE(iter.has_value());
+
+    sqlite::ColumnBatch<Qty> batch;
+    auto result = iter->next(batch);
+    EXPECT_FALSE(result.has_value());
+    // Only the row before the NULL is kept
+    EXPECT_EQ(batch.column<"qty">(), (std::vector<int64_t>{100}));
+}
+
+TEST_F(ColumnBatchTest, MissingColumns) {
+    // The optional qty may be left out; it reads as NULL
+    auto lenient = conn_.fetch_columns<Trade>(
+        std::string("SELECT id, symbol, price, settled FROM Trade ORDER BY id"), 0);
+    ASSERT_TRUE(lenient.has_value());
+    sqlite::ColumnBatch<Trade> batch;
+    auto result = lenient->next(batch);
+    ASSERT_TRUE(result.has_value()) << result.error();
+    constexpr size_t qty = sqlite::ColumnBatch<Trade>::index_of<"qty">;
+    EXPECT_EQ(batch.nulls<qty>(), (std::vector<uint8_t>{1, 1, 1, 1, 1}));
+
+    // A required field without a column is an error
+    auto strict = conn_.fetch_columns<Trade>(std::string("SELECT id, symbol, qty, settled FROM Trade"), 0);
+    ASSERT_TRUE(strict.has_value());
+    result = strict->next(batch);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_NE(result.error().find("no result column for field 'price'"), std::string::npos) << result.error();
+    EXPECT_TRUE(batch.empty());
+}
+
+TEST_F(ColumnBatchTest, BadRowKeepsEarlierRowsOfBatch) {
+    // Row 3 fails on its last field
+    auto iter = conn_.fetch_columns<Trade>(std::string(
+        "SELECT id, symbol, price, qty, CASE WHEN id = 3 THEN NULL ELSE settled END AS settled "
+        "FROM Trade ORDER BY id"), 0);
+    ASSERT_TRUE(iter.has_value());
+
+    sqlite::ColumnBatch<Trade> batch;
+    auto result = iter->next(batch);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_NE(result.error().find("settled"), std::string::npos);
+
+    // The other fields of the bad row had already been appended; every
+    // column is cut back
+    ASSERT_EQ(batch.size(), 2u);
+    EXPECT_EQ(batch.column<"id">(), (std::vector<int64_t>{1, 2}));
+    EXPECT_EQ(batch.column<"symbol">().bytes, "AAPLMSFT");
+    EXPECT_EQ(batch.column<"symbol">().size(), 2u);
+    EXPECT_EQ(batch.column<"price">().size(), 2u);
+    constexpr size_t qty = sqlite::ColumnBatch<Trade>::index_of<"qty">;
+    EXPECT_EQ(batch.nulls<qty>(), (std::vector<uint8_t>{0, 1}));
+    EXPECT_EQ(batch.column<"settled">(), (std::vector<uint8_t>{1, 0}));
+
+    // Reading carries on after the bad row
+    auto rest = iter->next(batch);
+    ASSERT_TRUE(rest.has_value()) << rest.error();
+    EXPECT_TRUE(*rest);
+    EXPECT_EQ(batch.column<"id">(), (std::vector<int64_t>{4, 5}));
+    EXPECT_EQ(batch.nulls<qty>(), (std::vector<uint8_t>{0, 1}));
+}
+
+TEST_F(ColumnBatchTest, OutOfRangeIntegerFails) {
+    auto iter = conn_.fetch_columns<SmallQty>(std::string("SELECT qty FROM Trade WHERE qty IS NOT NULL ORDER BY id"), 0);
+    ASSERT_TRUE(iter.has_value());
+
+    sqlite::ColumnBatch<SmallQty> batch;
+    auto result = iter->next(batch);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_NE(result.error().find("300"), std::string::npos);
+    EXPECT_EQ(batch.column<"qty">(), (std::vector<uint8_t>{100}));
+}
+
+} // namespace sqlgen::test
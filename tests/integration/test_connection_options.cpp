@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+
+namespace sqlgen::test {
+
+struct TunedRow {
+    int64_t id;
+    double value;
+};
+
+class ConnectionOptionsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = ::testing::TempDir() + "glz_sqlgen_options_" +
+                ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".db";
+        remove_files();
+    }
+
+    void TearDown() override {
+        remove_files();
+    }
+
+    void remove_files() {
+        for (const char* suffix : {"", "-wal", "-shm", "-journal"}) {
+            std::remove((path_ + suffix).c_str());
+        }
+    }
+
+    std::string path_;
+};
+
+TEST_F(ConnectionOptionsTest, DefaultsReportedBack) {
+    auto conn = sqlite::connect(path_);
+    ASSERT_TRUE(conn.has_value()) << conn.error();
+
+    auto options = conn->options();
+    ASSERT_TRUE(options.has_value()) << options.error();
+    EXPECT_EQ(options->flags, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    EXPECT_EQ(options->journal_mode, sqlite::JournalMode::Delete);
+    EXPECT_EQ(options->synchronous, sqlite::Synchronous::Full);
+    EXPECT_EQ(options->busy_timeout, std::chrono::milliseconds(0));
+    EXPECT_TRUE(options->page_size.has_value());
+}
+
+TEST_F(ConnectionOptionsTest, OltpProfileApplied) {
+    auto conn = sqlite::connect(path_, sqlite::ConnectionOptions::oltp());
+    ASSERT_TRUE(conn.has_value()) << conn.error();
+
+    auto options = conn->options();
+    ASSERT_TRUE(options.has_value()) << options.error();
+    EXPECT_EQ(options->journal_mode, sqlite::JournalMode::Wal);
+    EXPECT_EQ(options->synchronous, sqlite::Synchronous::Normal);
+    EXPECT_EQ(options->cache_size, -64 * 1024);
+    EXPECT_EQ(options->temp_store, sqlite::TempStore::Memory);
+    EXPECT_EQ(options->busy_timeout, std::chrono::milliseconds(5000));
+}
+
+TEST_F(ConnectionOptionsTest, BulkLoadProfileApplied) {
+    auto conn = sqlite::connect(path_, sqlite::ConnectionOptions::bulk_load());
+    ASSERT_TRUE(conn.has_value()) << conn.error();
+
+    auto options = conn->options();
+    ASSERT_TRUE(options.has_value()) << options.error();
+    EXPECT_EQ(options->journal_mode, sqlite::JournalMode::Off);
+    EXPECT_EQ(options->synchronous, sqlite::Synchronous::Off);
+
+    ASSERT_TRUE(conn->execute(create_table<TunedRow>()).has_value());
+    std::vector<TunedRow> rows{{1, 0.5}, {2, 1.5}};
+    EXPECT_TRUE(conn->insert_all(rows).has_value());
+}
+
+TEST_F(ConnectionOptionsTest, ReadOnlyAnalyticsProfileApplied) {
+    {
+        auto writer = sqlite::connect(path_);
+        ASSERT_TRUE(writer.has_value());
+        ASSERT_TRUE(writer->execute(create_table<TunedRow>()).has_value());
+    }
+
+    auto conn = sqlite::connect(path_, sqlite::ConnectionOptions::read_only_analytics());
+    ASSERT_TRUE(conn.has_value()) << conn.error();
+
+    auto options = conn->options();
+    ASSERT_TRUE(options.has_value()) << options.error();
+    EXPECT_EQ(options->flags, SQLITE_OPEN_READONLY);
+    EXPECT_EQ(options->temp_store, sqlite::TempStore::Memory);
+    EXPECT_EQ(options->cache_size, -256 * 1024);
+
+    EXPECT_FALSE(conn->execute(std::string("INSERT INTO TunedRow (id, value) VALUES (1, 1.0)")).has_value());
+}
+
+TEST_F(ConnectionOptionsTest, PageSizeAppliedToNewDatabase) {
+    sqlite::ConnectionOptions options;
+    options.page_size = 8192;
+    options.journal_mode = sqlite::JournalMode::Wal;
+
+    auto conn = sqlite::connect(path_, options);
+    ASSERT_TRUE(conn.has_value()) << conn.error();
+    EXPECT_EQ(conn->options()->page_size, 8192);
+}
+
+TEST_F(ConnectionOptionsTest, FailsWhenSettingIsRejected) {
+    // An in-memory database can only journal in memory or not at all
+    auto conn = sqlite::connect(":memory:", sqlite::ConnectionOptions::oltp());
+    ASSERT_FALSE(conn.has_value());
+    EXPECT_NE(conn.error().find("journal_mode=wal"), std::string::npos);
+}
+
+TEST_F(ConnectionOptionsTest, InvalidValueFailsBeforeAnySettingIsApplied) {
+    sqlite::ConnectionOptions options;
+    options.journal_mode = sqlite::JournalMode::Wal;
+    options.page_size = 1000;
+
+    auto conn = sqlite::connect(path_, options);
+    ASSERT_FALSE(conn.has_value());
+    EXPECT_NE(conn.error().find("page_size 1000"), std::string::npos) << conn.error();
+
+    // journal_mode=WAL would have persisted in the file
+    auto plain = sqlite::connect(path_);
+    ASSERT_TRUE(plain.has_value());
+    EXPECT_EQ(plain->options()->journal_mode, sqlite::JournalMode::Delete);
+}
+
+TEST_F(ConnectionOptionsTest, PoolConnectionsShareOptions) {
+    auto pool = sqlite::ConnectionPool::open(path_, 2, sqlite::ConnectionOptions::oltp());
+    ASSERT_TRUE(pool.has_value()) << pool.error();
+
+    auto lease = pool->acquire();
+    auto options = lease->options();
+    ASSERT_TRUE(options.has_value());
+    EXPECT_EQ(options->journal_mode, sqlite::JournalMode::Wal);
+    EXPECT_TRUE(options->flags & SQLITE_OPEN_NOMUTEX);
+}
+
+TEST(ConnectionOptionsNames, PragmaSpelling) {
+    EXPECT_EQ(sqlite::to_string(sqlite::JournalMode::Wal), "wal");
+    EXPECT_EQ(sqlite::to_string(sqlite::Synchronous::Normal), "normal");
+    EXPECT_EQ(sqlite::to_string(sqlite::TempStore::Memory), "memory");
+}
+
+} // namespace sqlgen::test
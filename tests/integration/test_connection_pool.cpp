@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Counter {
+    int64_t id;
+    int64_t value;
+};
+
+class ConnectionPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = ::testing::TempDir() + "glz_sqlgen_pool_" +
+                ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".db";
+        std::remove(path_.c_str());
+
+        auto conn = sqlite::connect(path_);
+        ASSERT_TRUE(conn.has_value());
+        ASSERT_TRUE(conn->execute(create_table<Counter>()).has_value());
+        ASSERT_TRUE(conn->insert_all(std::vector<Counter>{{1, 10}, {2, 20}, {3, 30}}).has_value());
+    }
+
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+
+    std::string path_;
+};
+
+TEST_F(ConnectionPoolTest, OpensConnections) {
+    auto pool = sqlite::ConnectionPool::open(path_, 4);
+    ASSERT_TRUE(pool.has_value()) << pool.error();
+    EXPECT_EQ(pool->size(), 4u);
+
+    auto lease = pool->acquire();
+    auto rows = lease->query<Counter>(select_from<Counter>() | order_by("id"_c))->collect();
+    ASSERT_TRUE(rows.has_value());
+    EXPECT_EQ(rows->size(), 3u);
+}
+
+TEST_F(ConnectionPoolTest, RejectsEmptyPool) {
+    EXPECT_FALSE(sqlite::ConnectionPool::open(path_, 0).has_value());
+}
+
+TEST_F(ConnectionPoolTest, LeasesAreExclusiveAndReturned) {
+    auto pool = sqlite::ConnectionPool::open(path_, 2);
+    ASSERT_TRUE(pool.has_value());
+
+    {
+        auto a = pool->acquire();
+        auto b = pool->acquire();
+        EXPECT_NE(&a.get(), &b.get());
+        EXPECT_EQ(pool->stats().in_use, 2u);
+        EXPECT_FALSE(pool->try_acquire().has_value());
+    }
+
+    EXPECT_EQ(pool->stats().in_use, 0u);
+    auto c = pool->try_acquire();
+    EXPECT_TRUE(c.has_value());
+}
+
+TEST_F(ConnectionPoolTest, MovedLeaseReleasesOnce) {
+    auto pool = sqlite::ConnectionPool::open(path_, 1);
+    ASSERT_TRUE(pool.has_value());
+
+    {
+        auto a = pool->acquire();
+        auto b = std::move(a);
+        EXPECT_EQ(pool->stats().in_use, 1u);
+    }
+    EXPECT_EQ(pool->stats().in_use, 0u);
+    EXPECT_EQ(pool->stats().acquisitions, 1u);
+    EXPECT_TRUE(pool->try_acquire().has_value());
+}
+
+TEST_F(ConnectionPoolTest, ReleaseRollsBackOpenTransaction) {
+    auto pool = sqlite::ConnectionPool::open(path_, 1);
+    ASSERT_TRUE(pool.has_value());
+
+    {
+        auto lease = pool->acquire();
+        ASSERT_TRUE(lease->begin_transaction().has_value());
+        ASSERT_TRUE(lease->execute(std::string("DELETE FROM Counter")).has_value());
+    }
+
+    auto lease = pool->acquire();
+    EXPECT_FALSE(lease->in_transaction());
+    auto count = lease->query<int64_t>(std::string("SELECT COUNT(*) FROM Counter"))->next();
+    EXPECT_EQ(count.value().value(), 3);
+}
+
+TEST_F(ConnectionPoolTest, ReleaseRollsBackPastExpiredDeadline) {
+    auto pool = sqlite::ConnectionPool::open(path_, 1);
+    ASSERT_TRUE(pool.has_value());
+
+    {
+        auto lease = pool->acquire();
+        ASSERT_TRUE(lease->begin_transaction().has_value());
+        ASSERT_TRUE(lease->execute(std::string("DELETE FROM Counter")).has_value());
+        lease->set_deadline(std::chrono::steady_clock::now() - std::chrono::seconds(1));
+    }
+
+    auto lease = pool->acquire();
+    EXPECT_FALSE(lease->in_transaction());
+    EXPECT_FALSE(lease->deadline().has_value());
+    auto count = lease->query<int64_t>(std::string("SELECT COUNT(*) FROM Counter"))->next();
+    EXPECT_EQ(count.value().value(), 3);
+}
+
+TEST_F(ConnectionPoolTest, ConcurrentReaders) {
+    constexpr size_t pool_size = 3;
+    constexpr int threads = 8;
+    constexpr int iterations = 200;
+
+    auto pool = sqlite::ConnectionPool::open(path_, pool_size);
+    ASSERT_TRUE(pool.has_value());
+
+    std::atomic<int> holders{0};
+    std::atomic<int> max_holders{0};
+    std::atomic<int64_t> total{0};
+    std::atomic<int> failures{0};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < iterations; ++i) {
+                auto lease = pool->acquire();
+                int now = ++holders;
+                int seen = max_holders.load();
+                while (now > seen && !max_holders.compare_exchange_weak(seen, now)) {
+                }
+
+                auto sum = lease->query<int64_t>(std::string("SELECT SUM(value) FROM Counter"));
+                auto value = sum ? sum->next() : Result<std::optional<int64_t>>(std::nullopt);
+                if (value && *value) {
+                    total += **value;
+                } else {
+                    ++failures;
+                }
+                --holders;
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(total.load(), int64_t{60} * threads * iterations);
+    EXPECT_LE(max_holders.load(), static_cast<int>(pool_size));
+
+    auto stats = pool->stats();
+    EXPECT_EQ(stats.acquisitions, static_cast<uint64_t>(threads * iterations));
+    EXPECT_EQ(stats.in_use, 0u);
+    EXPECT_LE(stats.peak_in_use, pool_size);
+    EXPECT_GE(stats.total_wait_ns, stats.max_wait_ns);
+    EXPECT_GT(stats.utilization(), 0.0);
+    EXPECT_LE(stats.utilization(), 1.0);
+}
+
+TEST_F(ConnectionPoolTest, LeaseKeepsPoolAlive) {
+    std::optional<sqlite::ConnectionPool::Lease> lease;
+    {
+        auto pool = sqlite::ConnectionPool::open(path_, 1);
+        ASSERT_TRUE(pool.has_value());
+        lease.emplace(pool->acquire());
+    }
+    auto count = (*lease)->query<int64_t>(std::string("SELECT COUNT(*) FROM Counter"))->next();
+    EXPECT_EQ(count.value().value(), 3);
+}
+
+} // namespace sqlgen::test
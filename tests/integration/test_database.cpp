@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Message {
+    int64_t id;
+    std::string kind;
+};
+
+static_assert(is_write_query_v<decltype(insert<Message>())>);
+static_assert(is_write_query_v<decltype(delete_from<Message>() | where("id"_c == 1))>);
+static_assert(is_write_query_v<decltype(update<Message>(set("kind"_c, "x")))>);
+static_assert(is_write_query_v<decltype(create_table<Message>())>);
+static_assert(!is_write_query_v<decltype(select_from<Message>())>);
+static_assert(!is_write_query_v<decltype(select_from<Message>() | where("id"_c > 1))>);
+
+class DatabaseTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = ::testing::TempDir() + "glz_sqlgen_db_" +
+                ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".db";
+        remove_files();
+    }
+
+    void TearDown() override {
+        remove_files();
+    }
+
+    void remove_files() {
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            std::remove((path_ + suffix).c_str());
+        }
+    }
+
+    std::string path_;
+};
+
+TEST_F(DatabaseTest, OpensInWalMode) {
+    auto db = sqlite::Database::open(path_, 2);
+    ASSERT_TRUE(db.has_value()) << db.error();
+    EXPECT_EQ(db->reader_count(), 2u);
+
+    auto mode = db->query<std::string>(std::string("PRAGMA journal_mode"));
+    ASSERT_TRUE(mode.has_value());
+    ASSERT_EQ(mode->size(), 1u);
+    EXPECT_EQ(mode->front(), "wal");
+}
+
+TEST_F(DatabaseTest, RejectsInMemoryDatabase) {
+    EXPECT_FALSE(sqlite::Database::open(":memory:", 1).has_value());
+}
+
+TEST_F(DatabaseTest, RoutesBuildersByType) {
+    auto db = sqlite::Database::open(path_, 2);
+    ASSERT_TRUE(db.has_value());
+
+    ASSERT_TRUE(db->execute(create_table<Message>()).has_value());
+    ASSERT_TRUE(db->insert_all(std::vector<Message>{{1, "a"}, {2, "b"}, {3, "c"}}).has_value());
+    ASSERT_TRUE(db->execute(update<Message>(set("kind"_c, "z")) | where("id"_c == 2)).has_value());
+    ASSERT_TRUE(db->execute(delete_from<Message>() | where("id"_c == 3)).has_value());
+
+    auto before = db->reader_stats().acquisitions;
+    auto rows = db->query<Message>(select_from<Message>() | order_by("id"_c));
+    ASSERT_TRUE(rows.has_value()) << rows.error();
+    ASSERT_EQ(rows->size(), 2u);
+    EXPECT_EQ(rows->at(1).kind, "z");
+    EXPECT_EQ(db->reader_stats().acquisitions, before + 1);
+}
+
+TEST_F(DatabaseTest, ReadersAreReadOnly) {
+    auto db = sqlite::Database::open(path_, 1);
+    ASSERT_TRUE(db.has_value());
+    ASSERT_TRUE(db->execute(create_table<Message>()).has_value());
+
+    auto reader = db->reader();
+    EXPECT_FALSE(reader->execute(std::string("INSERT INTO Message (id, kind) VALUES (1, 'x')")).has_value());
+}
+
+TEST_F(DatabaseTest, ReadersShareBusyHandling) {
+    sqlite::ConnectionOptions options;
+    options.busy_timeout = std::chrono::milliseconds(1234);
+    options.cache_size = -1024;
+    options.flags = SQLITE_OPEN_READONLY;  // Ignored: the writer must write
+    auto db = sqlite::Database::open(path_, 2, options);
+    ASSERT_TRUE(db.has_value()) << db.error();
+    ASSERT_TRUE(db->execute(create_table<Message>()).has_value());
+
+    auto timeout = db->query<int64_t>(std::string("PRAGMA busy_timeout"));
+    ASSERT_TRUE(timeout.has_value());
+    EXPECT_EQ(timeout->front(), 1234);
+    auto cache = db->query<int64_t>(std::string("PRAGMA cache_size"));
+    ASSERT_TRUE(cache.has_value());
+    EXPECT_EQ(cache->front(), -1024);
+
+    options.busy_timeout.reset();
+    options.busy_policy = sqlite::BusyPolicy{.max_wait = std::chrono::milliseconds(250)};
+    db = sqlite::Database::open(path_, 2, options);
+    ASSERT_TRUE(db.has_value()) << db.error();
+    auto policy = db->reader()->busy_policy();
+    ASSERT_TRUE(policy.has_value());
+    EXPECT_EQ(policy->max_wait, std::chrono::milliseconds(250));
+    EXPECT_TRUE(db->writer()->busy_policy().has_value());
+}
+
+TEST_F(DatabaseTest, WriteLeaseRollsBackOpenTransaction) {
+    auto db = sqlite::Database::open(path_, 1);
+    ASSERT_TRUE(db.has_value());
+    ASSERT_TRUE(db->execute(create_table<Message>()).has_value());
+
+    {
+        auto writer = db->writer();
+        ASSERT_TRUE(writer->begin_transaction().has_value());
+        ASSERT_TRUE(writer->insert_all(std::vector<Message>{{1, "a"}}).has_value());
+    }
+
+    EXPECT_FALSE(db->writer()->in_transaction());
+    auto rows = db->query<Message>(select_from<Message>());
+    ASSERT_TRUE(rows.has_value());
+    EXPECT_TRUE(rows->empty());
+}
+
+TEST_F(DatabaseTest, ConcurrentReadersAndWriters) {
+    constexpr int writers = 2;
+    constexpr int readers = 4;
+    constexpr int iterations = 100;
+
+    auto db = sqlite::Database::open(path_, readers);
+    ASSERT_TRUE(db.has_value());
+    ASSERT_TRUE(db->execute(create_table<Message>()).has_value());
+
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            for (int i = 0; i < iterations; ++i) {
+                Message message{w * iterations + i, "w"};
+                if (!db->insert_all(std::span<const Message>(&message, 1))) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&] {
+            size_t last = 0;
+            for (int i = 0; i < iterations; ++i) {
+                auto rows = db->query<Message>(select_from<Message>());
+                // Rows only ever accumulate, and no reader sees SQLITE_BUSY
+                if (!rows || rows->size() < last) {
+                    ++failures;
+                } else {
+                    last = rows->size();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    auto count = db->query<int64_t>(std::string("SELECT COUNT(*) FROM Message"));
+    ASSERT_TRUE(count.has_value());
+    EXPECT_EQ(count->front(), writers * iterations);
+}
+
+} // namespace sqlgen::test
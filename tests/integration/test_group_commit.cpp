@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+#include "sqlgen/constraints.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Tally {
+    PrimaryKey<int64_t> id;
+    int64_t hits;
+};
+
+class GroupCommitTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = ::testing::TempDir() + "glz_sqlgen_group_" +
+                ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".db";
+        std::remove(path_.c_str());
+
+        auto conn = sqlite::connect(path_);
+        ASSERT_TRUE(conn.has_value());
+        ASSERT_TRUE(conn->execute(create_table<Tally>()).has_value());
+    }
+
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+
+    sqlite::Connection open() {
+        return std::move(sqlite::connect(path_).value());
+    }
+
+    int64_t count() {
+        auto conn = open();
+        return conn.query<int64_t>(std::string("SELECT COUNT(*) FROM Tally"))->next().value().value_or(-1);
+    }
+
+    static std::string insert_sql(int64_t id) {
+        return "INSERT INTO Tally (id, hits) VALUES (" + std::to_string(id) + ", 0)";
+    }
+
+    std::string path_;
+};
+
+TEST_F(GroupCommitTest, AppliesSubmittedWrites) {
+    sqlite::GroupCommitWriter writer(open());
+
+    auto a = writer.submit(insert_sql(1));
+    auto b = writer.submit(insert_sql(2));
+    auto c = writer.submit(update<Tally>(set("hits"_c, 5)) | where("id"_c == 1));
+
+    EXPECT_TRUE(a.get().has_value());
+    EXPECT_TRUE(b.get().has_value());
+    EXPECT_TRUE(c.get().has_value());
+    EXPECT_EQ(count(), 2);
+}
+
+TEST_F(GroupCommitTest, FailedWriteDoesNotAbortBatch) {
+    // A long window keeps all three writes in one transaction
+    sqlite::GroupCommitWriter writer(open(), {.window = std::chrono::milliseconds(200), .max_batch = 3});
+
+    auto first = writer.submit(insert_sql(1));
+    auto duplicate = writer.submit(insert_sql(1));
+    auto third = writer.submit(insert_sql(3));
+
+    EXPECT_TRUE(first.get().has_value());
+    EXPECT_FALSE(duplicate.get().has_value());
+    EXPECT_TRUE(third.get().has_value());
+    EXPECT_EQ(count(), 2);
+
+    auto stats = writer.stats();
+    EXPECT_EQ(stats.batches, 1u);
+    EXPECT_EQ(stats.writes, 2u);
+    EXPECT_EQ(stats.failed_writes, 1u);
+}
+
+TEST_F(GroupCommitTest, ThrowingWriteIsRolledBackAlone) {
+    sqlite::GroupCommitWriter writer(open(), {.window = std::chrono::milliseconds(200), .max_batch = 3});
+
+    auto first = writer.submit(insert_sql(1));
+    auto throws = writer.submit([](sqlite::Connection& conn) -> Result<Nothing> {
+        auto inserted = conn.execute(std::string("INSERT INTO Tally (id, hits) VALUES (2, 0)"));
+        if (inserted) {
+            throw std::runtime_error("boom");
+        }
+        return inserted;
+    });
+    auto third = writer.submit(insert_sql(3));
+
+    EXPECT_TRUE(first.get().has_value());
+    auto thrown = throws.get();
+    ASSERT_FALSE(thrown.has_value());
+    EXPECT_NE(thrown.error().find("boom"), std::string::npos);
+    EXPECT_TRUE(third.get().has_value());
+    EXPECT_EQ(count(), 2);
+}
+
+TEST_F(GroupCommitTest, WriteEndingTransactionFailsBatch) {
+    sqlite::GroupCommitWriter writer(open(), {.window = std::chrono::milliseconds(200), .max_batch = 3});
+
+    auto first = writer.submit(insert_sql(1));
+    auto ends = writer.submit([](sqlite::Connection& conn) { return conn.execute(std::string("ROLLBACK")); });
+    auto third = writer.submit(insert_sql(3));
+
+    EXPECT_FALSE(first.get().has_value());
+    EXPECT_FALSE(ends.get().has_value());
+    auto skipped = third.get();
+    ASSERT_FALSE(skipped.has_value());
+    EXPECT_NE(skipped.error().find("transaction ended by write 2"), std::string::npos);
+    EXPECT_EQ(count(), 0);
+
+    auto stats = writer.stats();
+    EXPECT_EQ(stats.batches, 0u);
+    EXPECT_EQ(stats.writes, 0u);
+    EXPECT_EQ(stats.failed_writes, 3u);
+    EXPECT_EQ(stats.failed_commits, 1u);
+    EXPECT_EQ(stats.mean_batch(), 0.0);
+
+    // The writer carries on with the next batch; the failed one does not
+    // count towards the mean
+    EXPECT_TRUE(writer.submit(insert_sql(4)).get().has_value());
+    EXPECT_EQ(count(), 1);
+    stats = writer.stats();
+    EXPECT_EQ(stats.batches, 1u);
+    EXPECT_EQ(stats.failed_commits, 1u);
+    EXPECT_DOUBLE_EQ(stats.mean_batch(), 1.0);
+}
+
+TEST_F(GroupCommitTest, RunsCallableWrites) {
+    sqlite::GroupCommitWriter writer(open());
+
+    auto done = writer.submit([](sqlite::Connection& conn) -> Result<Nothing> {
+        auto stmt = conn.prepare(insert<Tally>());
+        if (!stmt) {
+            return error(stmt.error());
+        }
+        auto bound = stmt->bind_row(Tally{PrimaryKey<int64_t>{7}, 1});
+        if (!bound) {
+            return bound;
+        }
+        return stmt->execute();
+    });
+
+    auto result = done.get();
+    EXPECT_TRUE(result.has_value()) << result.error();
+    EXPECT_EQ(count(), 1);
+}
+
+TEST_F(GroupCommitTest, BatchesConcurrentSubmitters) {
+    constexpr int threads = 8;
+    constexpr int per_thread = 50;
+
+    {
+        sqlite::GroupCommitWriter writer(open(), {.window = std::chrono::milliseconds(2), .max_batch = 64});
+
+        std::vector<std::thread> workers;
+        std::atomic<int> failures{0};
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                std::vector<std::future<Result<Nothing>>> pending;
+                for (int i = 0; i < per_thread; ++i) {
+                    pending.push_back(writer.submit(insert_sql(t * per_thread + i)));
+                }
+                for (auto& f : pending) {
+                    if (!f.get()) ++failures;
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+
+        EXPECT_EQ(failures.load(), 0);
+        auto stats = writer.stats();
+        EXPECT_EQ(stats.writes, static_cast<uint64_t>(threads * per_thread));
+        EXPECT_LT(stats.batches, stats.writes);
+        EXPECT_GE(stats.batches, stats.writes / 64);
+    }
+
+    EXPECT_EQ(count(), threads * per_thread);
+}
+
+TEST_F(GroupCommitTest, DestructorDrainsQueue) {
+    std::vector<std::future<Result<Nothing>>> pending;
+    {
+        sqlite::GroupCommitWriter writer(open(), {.window = std::chrono::seconds(10), .max_batch = 1000});
+        for (int i = 0; i < 20; ++i) {
+            pending.push_back(writer.submit(insert_sql(i)));
+        }
+    }
+
+    for (auto& f : pending) {
+        EXPECT_TRUE(f.get().has_value());
+    }
+    EXPECT_EQ(count(), 20);
+}
+
+} // namespace sqlgen::test
@@ -0,0 +1,262 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Probe {
+    int64_t id;
+    std::string label;
+};
+
+class InstrumentationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(conn_.execute(create_table<Probe>()).has_value());
+        std::vector<Probe> rows;
+        for (int64_t i = 1; i <= 5; ++i) {
+            rows.push_back({i, "label" + std::to_string(i)});
+        }
+        ASSERT_TRUE(conn_.insert_all(rows).has_value());
+    }
+
+    // The shape a builder's statement is recorded under
+    template <class QueryBuilder>
+    std::string shape_of(const QueryBuilder& builder) {
+        return std::string(conn_.prepare(builder)->sql());
+    }
+
+    sqlite::Connection conn_{std::move(sqlite::connect(":memory:").value())};
+};
+
+TEST_F(InstrumentationTest, DisabledByDefault) {
+    EXPECT_EQ(conn_.instrumentation(), nullptr);
+}
+
+TEST_F(InstrumentationTest, RecordsPhasesPerQueryShape) {
+    auto instrumentation = conn_.enable_instrumentation();
+
+    for (int64_t min_id : {0, 3}) {
+        auto iter = conn_.query<Probe>(select_from<Probe>() | where("id"_c > min_id));
+        ASSERT_TRUE(iter.has_value()) << iter.error();
+        ASSERT_TRUE(iter->collect().has_value());
+    }
+
+    auto snapshot = instrumentation->snapshot();
+    auto* shape = snapshot.find(shape_of(select_from<Probe>() | where("id"_c > 0)));
+    ASSERT_NE(shape, nullptr);
+    EXPECT_EQ(shape->executions, 2u);
+    EXPECT_EQ(shape->rows, 7u);  // 5 + 2
+    EXPECT_GT(shape->bytes, 7u * 8);
+    EXPECT_EQ(shape->emit.count, 1u);     // The second run hit the statement cache
+    EXPECT_EQ(shape->prepare.count, 1u);
+    EXPECT_EQ(shape->step.count, 2u);     // One sample per run
+    EXPECT_EQ(shape->decode.count, 2u);
+    EXPECT_GE(shape->step.max_ns, shape->step.min_ns);
+}
+
+TEST_F(InstrumentationTest, ExecuteIsTraced) {
+    auto instrumentation = conn_.enable_instrumentation();
+    const std::string sql = "DELETE FROM Probe WHERE id = 1";
+    ASSERT_TRUE(conn_.execute(sql).has_value());
+    ASSERT_TRUE(conn_.execute(sql).has_value());
+
+    auto snapshot = instrumentation->snapshot();
+    auto* shape = snapshot.find(sql);
+    ASSERT_NE(shape, nullptr);
+    EXPECT_EQ(shape->executions, 2u);
+    EXPECT_EQ(shape->execute.count, 2u);
+}
+
+TEST_F(InstrumentationTest, ExecutedBuildersShareOneShape) {
+    auto instrumentation = conn_.enable_instrumentation();
+    auto rename = [](int64_t id) {
+        return update<Probe>(set("label"_c, "renamed" + std::to_string(id))) | where("id"_c == id);
+    };
+    for (int64_t id = 1; id <= 100; ++id) {
+        ASSERT_TRUE(conn_.execute(rename(id)).has_value());
+    }
+
+    auto snapshot = instrumentation->snapshot();
+    EXPECT_EQ(snapshot.queries.size(), 1u);
+    auto* shape = snapshot.find(shape_of(rename(1)));
+    ASSERT_NE(shape, nullptr);
+    EXPECT_EQ(shape->executions, 100u);
+
+    auto label = conn_.query<std::string>(std::string("SELECT label FROM Probe WHERE id = 5"))->collect();
+    ASSERT_TRUE(label.has_value()) << label.error();
+    EXPECT_EQ(label->front(), "renamed5");
+}
+
+TEST_F(InstrumentationTest, PreparedStatementExecuteIsTimed) {
+    auto instrumentation = conn_.enable_instrumentation();
+    auto stmt = conn_.prepare(std::string("UPDATE Probe SET label = ? WHERE id = ?"));
+    ASSERT_TRUE(stmt.has_value());
+    for (int64_t id = 1; id <= 3; ++id) {
+        ASSERT_TRUE(stmt->bind_all(std::tuple{std::string("x"), id}).has_value());
+        ASSERT_TRUE(stmt->execute().has_value());
+    }
+
+    auto snapshot = instrumentation->snapshot();
+    auto* shape = snapshot.find("UPDATE Probe SET label = ? WHERE id = ?");
+    ASSERT_NE(shape, nullptr);
+    EXPECT_EQ(shape->executions, 3u);
+    EXPECT_EQ(shape->execute.count, 3u);
+    EXPECT_EQ(shape->prepare.count, 1u);
+}
+
+TEST_F(InstrumentationTest, AbandonedAndViewedRunsAreRecorded) {
+    auto instrumentation = conn_.enable_instrumentation();
+    const std::string sql = "SELECT id, label FROM Probe ORDER BY id";
+
+    {
+        auto iter = conn_.query(sql);
+        ASSERT_TRUE(iter.has_value());
+        ASSERT_TRUE(iter->next().has_value());  // Dropped after one row
+    }
+    {
+        auto iter = conn_.query(sql);
+        ASSERT_TRUE(iter.has_value());
+        size_t seen = 0;
+        iter->for_each_row([&](sqlite::RowView) { ++seen; });
+        EXPECT_EQ(seen, 5u);
+    }
+
+    auto snapshot = instrumentation->snapshot();
+    auto* shape = snapshot.find(sql);
+    ASSERT_NE(shape, nullptr);
+    EXPECT_EQ(shape->executions, 2u);
+    // The first run stepped to its second row before being dropped
+    EXPECT_EQ(shape->rows, 2u + 5u);
+    EXPECT_EQ(shape->step.count, 2u);
+}
+
+TEST_F(InstrumentationTest, DisableStopsRecording) {
+    auto instrumentation = conn_.enable_instrumentation();
+    conn_.disable_instrumentation();
+    EXPECT_EQ(conn_.instrumentation(), nullptr);
+
+    ASSERT_TRUE(conn_.query<Probe>(select_from<Probe>())->collect().has_value());
+    EXPECT_TRUE(instrumentation->snapshot().queries.empty());
+}
+
+TEST_F(InstrumentationTest, SnapshotExportsJson) {
+    auto instrumentation = conn_.enable_instrumentation();
+    ASSERT_TRUE(conn_.query<Probe>(select_from<Probe>())->collect().has_value());
+
+    auto json = instrumentation->snapshot().to_json();
+    EXPECT_NE(json.find("\"queries\""), std::string::npos);
+    EXPECT_NE(json.find("\"step\""), std::string::npos);
+    EXPECT_NE(json.find("\"p99_ns\""), std::string::npos);
+    EXPECT_NE(json.find("FROM"), std::string::npos);
+}
+
+TEST_F(InstrumentationTest, CollectsPlannerCounters) {
+    auto instrumentation = conn_.enable_instrumentation();
+    const std::string scan = "SELECT id FROM Probe WHERE label = 'label3'";
+    for (int run = 0; run < 2; ++run) {
+        auto iter = conn_.query(scan);
+        ASSERT_TRUE(iter.has_value());
+        iter->for_each_row([](sqlite::RowView) {});
+    }
+
+    auto snapshot = instrumentation->snapshot();
+    auto* shape = snapshot.find(scan);
+    ASSERT_NE(shape, nullptr);
+    // The counters are reset after each run, so both runs add 4 scan steps
+    // (the 5 rows, less the first) rather than the second also re-adding the first
+    EXPECT_EQ(shape->planner.fullscan_steps, 2u * 4);
+    EXPECT_GT(shape->planner.vm_steps, 0u);
+    EXPECT_EQ(shape->planner.autoindexes, 0u);
+}
+
+TEST_F(InstrumentationTest, ReportsSuspiciousQueries) {
+    std::vector<Probe> rows;
+    for (int64_t i = 6; i <= 3000; ++i) {
+        rows.push_back({i, "label" + std::to_string(i % 100)});
+    }
+    ASSERT_TRUE(conn_.insert_all(rows).has_value());
+    ASSERT_TRUE(conn_.execute(std::string("CREATE INDEX probe_id ON Probe (id)")).has_value());
+
+    auto instrumentation = conn_.enable_instrumentation();
+    const std::string scan = "SELECT id FROM Probe WHERE label = 'label7'";
+    const std::string join = "SELECT a.id FROM Probe a JOIN Probe b ON a.label = b.label WHERE a.id < 10";
+    for (const auto& sql : {scan, join}) {
+        auto iter = conn_.query(sql);
+        ASSERT_TRUE(iter.has_value()) << iter.error();
+        iter->for_each_row([](sqlite::RowView) {});
+    }
+    // Served by the index, so not reported
+    ASSERT_TRUE(conn_.query<Probe>(select_from<Probe>() | where("id"_c == int64_t{42}))->collect().has_value());
+
+    auto report = instrumentation->snapshot().suspicious();
+    ASSERT_EQ(report.size(), 2u);
+
+    auto find = [&](const std::string& sql) {
+        return std::ranges::find(report, sql, &sqlite::SuspiciousQuery::sql);
+    };
+    auto scanned = find(scan);
+    ASSERT_NE(scanned, report.end());
+    EXPECT_GE(scanned->planner.fullscan_steps, 2999u);
+    EXPECT_NE(scanned->reasons.front().find("full table scan"), std::string::npos);
+
+    auto joined = find(join);
+    ASSERT_NE(joined, report.end());
+    EXPECT_GT(joined->planner.autoindexes, 0u);
+    EXPECT_TRUE(std::ranges::any_of(joined->reasons, [](const std::string& reason) {
+        return reason.find("automatic index") != std::string::npos;
+    }));
+
+    // Looser thresholds let the scan through
+    sqlite::SuspicionThresholds thresholds;
+    thresholds.fullscan_steps_per_run = 1000000;
+    auto relaxed = instrumentation->snapshot().suspicious(thresholds);
+    ASSERT_EQ(relaxed.size(), 1u);
+    EXPECT_EQ(relaxed.front().sql, join);
+}
+
+TEST_F(InstrumentationTest, PreparedStatementPlannerCounters) {
+    auto instrumentation = conn_.enable_instrumentation();
+    const std::string sql = "UPDATE Probe SET label = 'x' WHERE label = 'label2'";
+    auto stmt = conn_.prepare(sql);
+    ASSERT_TRUE(stmt.has_value());
+    ASSERT_TRUE(stmt->execute().has_value());
+
+    auto snapshot = instrumentation->snapshot();
+    auto* shape = snapshot.find(sql);
+    ASSERT_NE(shape, nullptr);
+    EXPECT_EQ(shape->planner.fullscan_steps, 4u);
+}
+
+TEST(LatencyHistogramTest, BucketsBoundRelativeError) {
+    using sqlite::LatencyHistogram;
+    for (uint64_t ns : {0ull, 7ull, 8ull, 1000ull, 123456789ull, (1ull << 40) + 12345}) {
+        auto index = LatencyHistogram::bucket_index(ns);
+        EXPECT_LE(LatencyHistogram::bucket_lower(index), ns);
+        EXPECT_GE(LatencyHistogram::bucket_upper(index), ns);
+        EXPECT_LE(LatencyHistogram::bucket_upper(index) - LatencyHistogram::bucket_lower(index),
+                  ns / LatencyHistogram::sub_buckets);
+    }
+    EXPECT_EQ(LatencyHistogram::bucket_index(UINT64_MAX), LatencyHistogram::bucket_count - 1);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+    auto histogram = std::make_unique<sqlite::LatencyHistogram>();
+    for (uint64_t us = 1; us <= 1000; ++us) {
+        histogram->record(us * 1000);
+    }
+
+    auto snapshot = histogram->snapshot();
+    EXPECT_EQ(snapshot.count, 1000u);
+    EXPECT_EQ(snapshot.min_ns, 1000u);
+    EXPECT_EQ(snapshot.max_ns, 1000000u);
+    EXPECT_NEAR(static_cast<double>(snapshot.p50_ns), 500000.0, 500000.0 / 8);
+    EXPECT_NEAR(static_cast<double>(snapshot.p99_ns), 990000.0, 990000.0 / 8);
+    EXPECT_DOUBLE_EQ(snapshot.mean_ns(), 500500.0);
+}
+
+} // namespace sqlgen::test
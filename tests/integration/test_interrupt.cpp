@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+
+using namespace sqlgen::literals;
+using namespace std::chrono_literals;
+
+namespace sqlgen::test {
+
+struct Tile {
+    int64_t id;
+    int64_t x;
+};
+
+struct Layer {
+    int64_t id;
+    int64_t depth;
+};
+
+// Counts forever unless interrupted
+const std::string endless_sql =
+    "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n) SELECT count(*) FROM n";
+
+class InterruptTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(conn_.execute(create_table<Tile>()).has_value());
+        ASSERT_TRUE(conn_.execute(create_table<Layer>()).has_value());
+        std::vector<Tile> tiles;
+        std::vector<Layer> layers;
+        for (int64_t i = 1; i <= 1000; ++i) {
+            tiles.push_back({i, i % 10});
+            layers.push_back({i, i % 7});
+        }
+        ASSERT_TRUE(conn_.insert_all(tiles).has_value());
+        ASSERT_TRUE(conn_.insert_all(layers).has_value());
+    }
+
+    // An accidental cross join: a billion rows
+    static auto runaway() {
+        return select_from<Tile>() | cross_join<Layer, "a">() | cross_join<Layer, "b">();
+    }
+
+    // Step a typed iterator until it ends, returning its error if any
+    template <class T>
+    static Result<size_t> drain(sqlite::TypedIterator<T>& iter) {
+        size_t rows = 0;
+        T row{};
+        while (true) {
+            auto more = iter.next(row);
+            if (!more) {
+                return error(more.error());
+            }
+            if (!*more) {
+                return rows;
+            }
+            ++rows;
+        }
+    }
+
+    sqlite::Connection conn_{std::move(sqlite::connect(":memory:").value())};
+};
+
+TEST_F(InterruptTest, DeadlineStopsRunawayQuery) {
+    conn_.set_timeout(50ms);
+    auto start = std::chrono::steady_clock::now();
+
+    auto iter = conn_.query<Tile>(runaway());
+    ASSERT_TRUE(iter.has_value()) << iter.error();
+    auto drained = drain(*iter);
+
+    ASSERT_FALSE(drained.has_value());
+    EXPECT_TRUE(sqlite::is_deadline_exceeded(drained.error())) << drained.error();
+    EXPECT_FALSE(sqlite::is_cancelled(drained.error()));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
+
+TEST_F(InterruptTest, DeadlineReportedByUntypedIterator) {
+    conn_.set_timeout(20ms);
+    auto iter = conn_.query(endless_sql);
+    ASSERT_TRUE(iter.has_value());
+
+    EXPECT_FALSE(iter->next().has_value());
+    ASSERT_TRUE(iter->last_error().has_value());
+    EXPECT_TRUE(sqlite::is_deadline_exceeded(*iter->last_error()));
+
+    conn_.set_timeout(20ms);
+    auto rows = conn_.query(endless_sql)->collect();
+    ASSERT_FALSE(rows.has_value());
+    EXPECT_TRUE(sqlite::is_deadline_exceeded(rows.error()));
+}
+
+TEST_F(InterruptTest, DeadlineStopsExecute) {
+    conn_.set_timeout(20ms);
+    auto executed = conn_.execute(endless_sql);
+    ASSERT_FALSE(executed.has_value());
+    EXPECT_TRUE(sqlite::is_deadline_exceeded(executed.error())) << executed.error();
+
+    conn_.set_timeout(20ms);
+    auto stmt = conn_.prepare(endless_sql);
+    ASSERT_TRUE(stmt.has_value());
+    auto run = stmt->execute();
+    ASSERT_FALSE(run.has_value());
+    EXPECT_TRUE(sqlite::is_deadline_exceeded(run.error())) << run.error();
+}
+
+TEST_F(InterruptTest, QueriesRunAgainOnceCleared) {
+    conn_.set_timeout(10ms);
+    ASSERT_FALSE(conn_.execute(endless_sql).has_value());
+
+    conn_.clear_deadline();
+    EXPECT_FALSE(conn_.deadline().has_value());
+    auto rows = conn_.query<Tile>(select_from<Tile>())->collect();
+    ASSERT_TRUE(rows.has_value()) << rows.error();
+    EXPECT_EQ(rows->size(), 1000u);
+}
+
+TEST_F(InterruptTest, ScopedTimeoutRestoresPreviousDeadline) {
+    EXPECT_FALSE(conn_.deadline().has_value());
+    {
+        auto guard = conn_.scoped_timeout(20ms);
+        EXPECT_TRUE(conn_.deadline().has_value());
+        EXPECT_TRUE(sqlite::is_deadline_exceeded(conn_.execute(endless_sql).error()));
+    }
+    EXPECT_FALSE(conn_.deadline().has_value());
+
+    auto outer = std::chrono::steady_clock::now() + 1h;
+    conn_.set_deadline(outer);
+    {
+        auto guard = conn_.scoped_timeout(1ms);
+    }
+    ASSERT_TRUE(conn_.deadline().has_value());
+    EXPECT_EQ(*conn_.deadline(), outer);
+}
+
+TEST_F(InterruptTest, CancelFromAnotherThread) {
+    auto handle = conn_.cancel_handle();
+    std::atomic<bool> started{false};
+    Result<size_t> drained = 0;
+
+    std::thread worker([&] {
+        auto iter = conn_.query<Tile>(runaway());
+        if (!iter) {
+            drained = error(iter.error());
+            return;
+        }
+        Tile row{};
+        auto first = iter->next(row);
+        started = true;
+        drained = first ? drain(*iter) : Result<size_t>(error(first.error()));
+    });
+
+    while (!started) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(10ms);
+    handle.cancel();
+    worker.join();
+
+    ASSERT_FALSE(drained.has_value());
+    EXPECT_TRUE(sqlite::is_cancelled(drained.error())) << drained.error();
+    EXPECT_FALSE(sqlite::is_deadline_exceeded(drained.error()));
+}
+
+TEST_F(InterruptTest, CancelWhileIdleDoesNotAffectLaterQueries) {
+    conn_.cancel_handle().cancel();
+    auto rows = conn_.query<Tile>(select_from<Tile>())->collect();
+    ASSERT_TRUE(rows.has_value()) << rows.error();
+    EXPECT_EQ(rows->size(), 1000u);
+}
+
+TEST(CancelHandleTest, OutlivesConnection) {
+    sqlite::CancelHandle handle;
+    {
+        auto conn = sqlite::connect(":memory:");
+        ASSERT_TRUE(conn.has_value());
+        handle = conn->cancel_handle();
+    }
+    handle.cancel();  // Nothing to interrupt
+    sqlite::CancelHandle{}.cancel();
+}
+
+// A count that takes well over QueryDeadline::check_interval VM operations
+const std::string counted_sql =
+    "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 100000) SELECT count(*) FROM n";
+
+TEST(DeadlineLifetimeTest, IteratorOutlivesConnection) {
+    std::optional<sqlite::TypedIterator<int64_t>> iter;
+    {
+        auto conn = sqlite::connect(":memory:");
+        ASSERT_TRUE(conn.has_value());
+        conn->set_timeout(1h);
+        auto opened = conn->query<int64_t>(counted_sql);
+        ASSERT_TRUE(opened.has_value()) << opened.error();
+        iter.emplace(std::move(*opened));
+    }
+
+    // The statement keeps the database open, but the deadline went with the Connection
+    auto count = iter->next();
+    ASSERT_TRUE(count.has_value()) << count.error();
+    EXPECT_EQ(count->value_or(0), 100000);
+}
+
+TEST(DeadlineLifetimeTest, IteratorOutlivesMovedOverConnection) {
+    auto conn = sqlite::connect(":memory:");
+    ASSERT_TRUE(conn.has_value());
+    conn->set_timeout(1h);
+    auto iter = conn->query<int64_t>(counted_sql);
+    ASSERT_TRUE(iter.has_value()) << iter.error();
+
+    *conn = std::move(sqlite::connect(":memory:").value());
+
+    auto count = iter->next();
+    ASSERT_TRUE(count.has_value()) << count.error();
+    EXPECT_EQ(count->value_or(0), 100000);
+}
+
+TEST(InterruptErrorTest, OtherErrorsKeepTheirMessage) {
+    auto conn = sqlite::connect(":memory:");
+    ASSERT_TRUE(conn.has_value());
+    auto executed = conn->execute(std::string("SELECT * FROM missing"));
+    ASSERT_FALSE(executed.has_value());
+    EXPECT_FALSE(sqlite::is_deadline_exceeded(executed.error()));
+    EXPECT_FALSE(sqlite::is_cancelled(executed.error()));
+}
+
+} // namespace sqlgen::test
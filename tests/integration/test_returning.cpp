@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Parcel {
+    int64_t id;
+    std::string destination;
+    double weight;
+};
+
+struct ParcelKey {
+    int64_t id;
+};
+
+static_assert(is_write_query_v<decltype(insert<Parcel>() | returning("id"_c))>);
+static_assert(is_write_query_v<decltype(update<Parcel>(set("weight"_c, 1.0)) | returning())>);
+static_assert(is_write_query_v<decltype(delete_from<Parcel>() | where("id"_c == 1) | returning("id"_c))>);
+
+class ReturningQueryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(conn_.execute(std::string(
+            "CREATE TABLE Parcel (id INTEGER PRIMARY KEY, destination TEXT NOT NULL, weight REAL NOT NULL)")).has_value());
+        ASSERT_TRUE(conn_.insert_all(std::vector<Parcel>{
+            {1, "Oslo", 2.5}, {2, "Lima", 0.5}, {3, "Oslo", 7.0}, {4, "Pune", 1.25}}).has_value());
+    }
+
+    size_t count() {
+        auto rows = conn_.query<int64_t>(select_from<Parcel>(count_star()))->collect();
+        return rows ? static_cast<size_t>(rows->front()) : 0;
+    }
+
+    sqlite::Connection conn_{std::move(sqlite::connect(":memory:").value())};
+};
+
+TEST_F(ReturningQueryTest, DeleteReturnsAffectedKeys) {
+    auto keys = conn_.query<ParcelKey>(delete_from<Parcel>() | where("destination"_c == "Oslo") | returning("id"_c));
+    ASSERT_TRUE(keys.has_value()) << keys.error();
+    auto rows = keys->collect();
+    ASSERT_TRUE(rows.has_value()) << rows.error();
+
+    std::vector<int64_t> ids;
+    for (const auto& row : *rows) {
+        ids.push_back(row.id);
+    }
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ(ids, (std::vector<int64_t>{1, 3}));
+    EXPECT_EQ(count(), 2u);
+}
+
+TEST_F(ReturningQueryTest, UpdateReturnsNewRows) {
+    auto iter = conn_.query<Parcel>(update<Parcel>(set("weight"_c, 9.0)) | where("id"_c == 2) | returning());
+    ASSERT_TRUE(iter.has_value()) << iter.error();
+    auto rows = iter->collect();
+    ASSERT_TRUE(rows.has_value()) << rows.error();
+    ASSERT_EQ(rows->size(), 1u);
+    EXPECT_EQ(rows->at(0).id, 2);
+    EXPECT_EQ(rows->at(0).destination, "Lima");
+    EXPECT_DOUBLE_EQ(rows->at(0).weight, 9.0);
+}
+
+TEST_F(ReturningQueryTest, ReturningExpressionsAreBound) {
+    // The update is cached by shape; the second run binds new values
+    for (double factor : {2.0, 10.0}) {
+        auto doubled = conn_.query<double>(
+            update<Parcel>(set("weight"_c, 1.0)) | where("id"_c == 4) | returning("weight"_c * factor));
+        ASSERT_TRUE(doubled.has_value()) << doubled.error();
+        auto rows = doubled->collect();
+        ASSERT_TRUE(rows.has_value()) << rows.error();
+        ASSERT_EQ(rows->size(), 1u);
+        EXPECT_DOUBLE_EQ(rows->front(), factor);
+    }
+}
+
+TEST_F(ReturningQueryTest, InsertReturnsGeneratedKey) {
+    auto stmt = conn_.prepare(insert<Parcel>() | returning("id"_c));
+    ASSERT_TRUE(stmt.has_value()) << stmt.error();
+
+    struct NewParcel {
+        std::optional<int64_t> id;  // NULL lets SQLite assign the rowid
+        std::string destination;
+        double weight;
+    };
+    ASSERT_TRUE(stmt->bind_row(NewParcel{std::nullopt, "Kyiv", 3.0}).has_value());
+    auto keys = stmt->query<int64_t>();
+    ASSERT_TRUE(keys.has_value());
+    auto rows = keys->collect();
+    ASSERT_TRUE(rows.has_value()) << rows.error();
+    ASSERT_EQ(rows->size(), 1u);
+    EXPECT_EQ(rows->front(), 5);
+    EXPECT_EQ(count(), 5u);
+}
+
+TEST_F(ReturningQueryTest, NothingAffectedReturnsNoRows) {
+    auto rows = conn_.query<ParcelKey>(delete_from<Parcel>() | where("id"_c > 100) | returning("id"_c))->collect();
+    ASSERT_TRUE(rows.has_value()) << rows.error();
+    EXPECT_TRUE(rows->empty());
+    EXPECT_EQ(count(), 4u);
+}
+
+TEST_F(ReturningQueryTest, DroppedIteratorEndsWriteTransaction) {
+    {
+        auto removed = conn_.query<ParcelKey>(delete_from<Parcel>() | where("id"_c > 0) | returning("id"_c));
+        ASSERT_TRUE(removed.has_value()) << removed.error();
+        auto first = removed->next();
+        ASSERT_TRUE(first.has_value() && first->has_value());
+        EXPECT_EQ(sqlite3_txn_state(conn_.handle(), nullptr), SQLITE_TXN_WRITE);
+    }
+    EXPECT_EQ(sqlite3_txn_state(conn_.handle(), nullptr), SQLITE_TXN_NONE);
+}
+
+TEST(ReturningDatabaseTest, RoutedToWriter) {
+    const std::string path = ::testing::TempDir() + "glz_sqlgen_returning.db";
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((path + suffix).c_str());
+    }
+    {
+        auto db = sqlite::Database::open(path, 1);
+        ASSERT_TRUE(db.has_value()) << db.error();
+        ASSERT_TRUE(db->execute(create_table<Parcel>()).has_value());
+        ASSERT_TRUE(db->insert_all(std::vector<Parcel>{{1, "Oslo", 1.0}, {2, "Rome", 2.0}}).has_value());
+
+        auto removed = db->query<ParcelKey>(delete_from<Parcel>() | where("weight"_c > 1.5) | returning("id"_c));
+        ASSERT_TRUE(removed.has_value()) << removed.error();
+        ASSERT_EQ(removed->size(), 1u);
+        EXPECT_EQ(removed->front().id, 2);
+    }
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((path + suffix).c_str());
+    }
+}
+
+} // namespace sqlgen::test
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Doc {
+    int64_t id;
+    std::string title;
+    std::optional<std::string> body;
+    double score;
+    std::vector<std::byte> data;
+};
+
+class RowViewTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(conn_.execute(std::string(
+            "CREATE TABLE Doc (id INTEGER, title TEXT, body TEXT, score REAL, data BLOB);"
+            "INSERT INTO Doc VALUES "
+            "(1, 'first', 'hello', 0.5, x'0102'), "
+            "(2, 'second', NULL, 1.5, NULL), "
+            "(3, 'third', 'world', 2.5, x'ff')")).has_value());
+    }
+
+    sqlite::Connection conn_{std::move(sqlite::connect(":memory:").value())};
+};
+
+TEST_F(RowViewTest, TypedAccessors) {
+    auto iter = conn_.query(select_from<Doc>() | where("id"_c == 1));
+    ASSERT_TRUE(iter.has_value());
+    ASSERT_FALSE(iter->end());
+
+    auto row = iter->view();
+    EXPECT_EQ(row.size(), 5);
+    EXPECT_EQ(row.name(1), "title");
+    EXPECT_EQ(row.get<int64_t>(0), 1);
+    EXPECT_EQ(row.get<std::string_view>(1), "first");
+    EXPECT_EQ(row.get<std::optional<std::string_view>>(2), "hello");
+    EXPECT_DOUBLE_EQ(row.get<double>(3), 0.5);
+
+    auto data = row.get<std::span<const std::byte>>(4);
+    ASSERT_EQ(data.size(), 2u);
+    EXPECT_EQ(data[1], std::byte{0x02});
+}
+
+TEST_F(RowViewTest, NullHandling) {
+    auto iter = conn_.query(select_from<Doc>() | where("id"_c == 2));
+    ASSERT_TRUE(iter.has_value());
+
+    auto row = iter->view();
+    EXPECT_TRUE(row.is_null(2));
+    EXPECT_FALSE(row.get<std::optional<std::string_view>>(2).has_value());
+    EXPECT_TRUE(row.text(2).empty());
+    EXPECT_TRUE(row.blob(4).empty());
+
+    std::optional<std::string> body = "stale";
+    ASSERT_TRUE(row.decode(2, body).has_value());
+    EXPECT_FALSE(body.has_value());
+}
+
+TEST_F(RowViewTest, ForEachRowVisitsAll) {
+    auto iter = conn_.query(select_from<Doc>() | order_by("id"_c));
+    ASSERT_TRUE(iter.has_value());
+
+    double total = 0;
+    size_t title_bytes = 0;
+    iter->for_each_row([&](sqlite::RowView row) {
+        total += row.get<double>(3);
+        title_bytes += row.text(1).size();
+    });
+
+    EXPECT_DOUBLE_EQ(total, 4.5);
+    EXPECT_EQ(title_bytes, std::string("firstsecondthird").size());
+    EXPECT_TRUE(iter->end());
+}
+
+TEST_F(RowViewTest, ForEachRowStopsEarly) {
+    auto iter = conn_.query(select_from<Doc>() | order_by("id"_c));
+    ASSERT_TRUE(iter.has_value());
+
+    std::vector<int64_t> seen;
+    iter->for_each_row([&](sqlite::RowView row) {
+        seen.push_back(row.get<int64_t>(0));
+        return seen.size() < 2;
+    });
+    EXPECT_EQ(seen, (std::vector<int64_t>{1, 2}));
+
+    // The iterator continues after the row that stopped the scan
+    auto rest = iter->next();
+    ASSERT_TRUE(rest.has_value());
+    EXPECT_EQ(rest->at(0), "3");
+}
+
+TEST_F(RowViewTest, AdvanceSkipsRows) {
+    auto iter = conn_.query(select_from<Doc>("title"_c) | order_by("id"_c));
+    ASSERT_TRUE(iter.has_value());
+
+    iter->advance();
+    EXPECT_EQ(iter->view().text(0), "second");
+    iter->advance();
+    iter->advance();
+    EXPECT_TRUE(iter->end());
+}
+
+} // namespace sqlgen::test
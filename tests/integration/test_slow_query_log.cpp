@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Visit {
+    int64_t id;
+    std::string page;
+    double seconds;
+};
+
+class SlowQueryLogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(conn_.execute(create_table<Visit>()).has_value());
+        std::vector<Visit> rows;
+        for (int64_t i = 1; i <= 20; ++i) {
+            rows.push_back({i, "/page/" + std::to_string(i % 4), 0.5 * static_cast<double>(i)});
+        }
+        ASSERT_TRUE(conn_.insert_all(rows).has_value());
+    }
+
+    bool plan_mentions(const sqlite::SlowQuery& entry, std::string_view text) {
+        return std::ranges::any_of(entry.plan, [&](const std::string& line) {
+            return line.find(text) != std::string::npos;
+        });
+    }
+
+    sqlite::Connection conn_{std::move(sqlite::connect(":memory:").value())};
+};
+
+TEST_F(SlowQueryLogTest, OffByDefault) {
+    auto instrumentation = conn_.enable_instrumentation();
+    ASSERT_TRUE(conn_.query<Visit>(select_from<Visit>())->collect().has_value());
+
+    EXPECT_FALSE(instrumentation->slow_query_log()->enabled());
+    EXPECT_TRUE(instrumentation->slow_query_log()->entries().empty());
+}
+
+TEST_F(SlowQueryLogTest, RecordsQueryWithPlanAndParameterTypes) {
+    auto log = conn_.enable_slow_query_log(std::chrono::nanoseconds(0));
+
+    auto rows = conn_.query<Visit>(select_from<Visit>() | where("id"_c > int64_t{15}))->collect();
+    ASSERT_TRUE(rows.has_value());
+
+    auto entries = log->entries();
+    ASSERT_EQ(entries.size(), 1u);
+    const auto& entry = entries.front();
+    EXPECT_NE(entry.sql.find("FROM \"Visit\""), std::string::npos);
+    EXPECT_EQ(entry.parameter_types, std::vector<std::string>{"INTEGER"});
+    EXPECT_EQ(entry.rows, 5u);
+    EXPECT_TRUE(plan_mentions(entry, "SCAN"));
+
+    // The first run built and prepared the statement
+    EXPECT_GT(entry.phases.emit_ns, 0u);
+    EXPECT_GT(entry.phases.prepare_ns, 0u);
+    EXPECT_EQ(entry.phases.total_ns(),
+              entry.phases.emit_ns + entry.phases.prepare_ns + entry.phases.step_ns + entry.phases.decode_ns);
+}
+
+TEST_F(SlowQueryLogTest, CachedRunsSkipSetupPhases) {
+    auto log = conn_.enable_slow_query_log(std::chrono::nanoseconds(0));
+    for (int64_t id : {1, 2}) {
+        ASSERT_TRUE(conn_.query<Visit>(select_from<Visit>() | where("id"_c == id))->collect().has_value());
+    }
+
+    auto entries = log->entries();
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[1].phases.emit_ns, 0u);
+    EXPECT_EQ(entries[1].phases.prepare_ns, 0u);
+}
+
+TEST_F(SlowQueryLogTest, FastQueriesAreNotLogged) {
+    auto log = conn_.enable_slow_query_log(std::chrono::hours(1));
+    ASSERT_TRUE(conn_.query<Visit>(select_from<Visit>())->collect().has_value());
+
+    EXPECT_TRUE(log->entries().empty());
+    EXPECT_EQ(log->total(), 0u);
+}
+
+TEST_F(SlowQueryLogTest, RingBufferKeepsNewest) {
+    auto log = conn_.enable_slow_query_log(std::chrono::nanoseconds(0), 3);
+    for (int i = 1; i <= 5; ++i) {
+        auto iter = conn_.query("SELECT id FROM Visit WHERE id = " + std::to_string(i));
+        ASSERT_TRUE(iter.has_value());
+        iter->for_each_row([](sqlite::RowView) {});
+    }
+
+    auto entries = log->entries();
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_EQ(entries[0].sql, "SELECT id FROM Visit WHERE id = 3");
+    EXPECT_EQ(entries[2].sql, "SELECT id FROM Visit WHERE id = 5");
+    EXPECT_EQ(log->total(), 5u);
+
+    // Shrinking keeps the newest
+    log->configure(std::chrono::nanoseconds(0), 2);
+    entries = log->entries();
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].sql, "SELECT id FROM Visit WHERE id = 4");
+    EXPECT_EQ(entries[1].sql, "SELECT id FROM Visit WHERE id = 5");
+}
+
+TEST_F(SlowQueryLogTest, RecordsPreparedStatementExecute) {
+    auto log = conn_.enable_slow_query_log(std::chrono::nanoseconds(0));
+    auto stmt = conn_.prepare(std::string("UPDATE Visit SET seconds = ? WHERE page = ?"));
+    ASSERT_TRUE(stmt.has_value());
+    ASSERT_TRUE(stmt->bind_all(std::tuple{1.5, std::string("/page/1")}).has_value());
+    ASSERT_TRUE(stmt->execute().has_value());
+
+    auto entries = log->entries();
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].parameter_types, (std::vector<std::string>{"REAL", "TEXT"}));
+    EXPECT_GT(entries[0].phases.execute_ns, 0u);
+    EXPECT_TRUE(plan_mentions(entries[0], "SCAN"));
+}
+
+TEST_F(SlowQueryLogTest, UnboundParametersAreNull) {
+    auto log = conn_.enable_slow_query_log(std::chrono::nanoseconds(0));
+    auto stmt = conn_.prepare(std::string("SELECT id FROM Visit WHERE page = ? OR id = ?"));
+    ASSERT_TRUE(stmt.has_value());
+    ASSERT_TRUE(stmt->bind(2, int64_t{3}).has_value());
+    stmt->query()->for_each_row([](sqlite::RowView) {});
+
+    auto entries = log->entries();
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].parameter_types, (std::vector<std::string>{"NULL", "INTEGER"}));
+}
+
+TEST_F(SlowQueryLogTest, RecordsExecutedSql) {
+    ASSERT_TRUE(conn_.execute(std::string("CREATE INDEX visit_page ON Visit (page)")).has_value());
+    auto log = conn_.enable_slow_query_log(std::chrono::nanoseconds(0));
+    ASSERT_TRUE(conn_.execute(std::string("DELETE FROM Visit WHERE page = '/page/2'")).has_value());
+
+    auto entries = log->entries();
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].sql, "DELETE FROM Visit WHERE page = '/page/2'");
+    EXPECT_TRUE(plan_mentions(entries[0], "visit_page"));
+}
+
+TEST_F(SlowQueryLogTest, DisableStopsLogging) {
+    auto log = conn_.enable_slow_query_log(std::chrono::nanoseconds(0));
+    conn_.disable_slow_query_log();
+    EXPECT_FALSE(log->enabled());
+
+    ASSERT_TRUE(conn_.query<Visit>(select_from<Visit>())->collect().has_value());
+    EXPECT_TRUE(log->entries().empty());
+    EXPECT_NE(conn_.instrumentation(), nullptr);
+}
+
+TEST_F(SlowQueryLogTest, DumpIsReadable) {
+    auto log = conn_.enable_slow_query_log(std::chrono::nanoseconds(0));
+    auto stmt = conn_.prepare(std::string("SELECT page, COUNT(*) FROM Visit WHERE seconds > ? GROUP BY page"));
+    ASSERT_TRUE(stmt.has_value());
+    ASSERT_TRUE(stmt->bind(1, 2.0).has_value());
+    stmt->query()->for_each_row([](sqlite::RowView) {});
+
+    auto dump = log->dump();
+    EXPECT_NE(dump.find("sql: SELECT page, COUNT(*) FROM Visit"), std::string::npos);
+    EXPECT_NE(dump.find("parameters: REAL"), std::string::npos);
+    EXPECT_NE(dump.find("plan:"), std::string::npos);
+    EXPECT_NE(dump.find(" ms"), std::string::npos);
+}
+
+TEST(SlowQueryExplain, IndentsNestedSteps) {
+    auto conn = sqlite::connect(":memory:");
+    ASSERT_TRUE(conn.has_value());
+    ASSERT_TRUE(conn->execute(std::string("CREATE TABLE a (x INTEGER); CREATE TABLE b (y INTEGER)")).has_value());
+
+    auto plan = sqlite::SlowQueryLog::explain(conn->handle(),
+                                              "SELECT x FROM a WHERE x IN (SELECT y FROM b) ORDER BY x");
+    ASSERT_FALSE(plan.empty());
+    EXPECT_TRUE(std::ranges::any_of(plan, [](const std::string& line) { return line.starts_with("  "); }));
+
+    EXPECT_TRUE(sqlite::SlowQueryLog::explain(conn->handle(), "SELECT FROM nowhere").empty());
+}
+
+} // namespace sqlgen::test
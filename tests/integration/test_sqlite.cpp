@@ -204,4 +204,67 @@ TEST_F(SQLiteTest, MoveSemantics) {
     ASSERT_TRUE(conn2.execute(std::string("CREATE TABLE test (id INTEGER)")).has_value());
 }
 
+TEST_F(SQLiteTest, NextIntoReusedRow) {
+    ASSERT_TRUE(conn_.execute(std::string(
+        "CREATE TABLE t (id INTEGER, name TEXT);"
+        "INSERT INTO t VALUES (1, 'a fairly long first name'), (2, NULL), (3, 'c')")).has_value());
+
+    auto iter = conn_.query("SELECT id, name FROM t ORDER BY id");
+    ASSERT_TRUE(iter.has_value());
+
+    sqlite::Iterator::Row row;
+    ASSERT_TRUE(iter->next(row));
+    EXPECT_EQ(row.size(), 2u);
+    EXPECT_EQ(row[1].value(), "a fairly long first name");
+    const auto* id_buffer = row[0]->data();
+
+    ASSERT_TRUE(iter->next(row));
+    EXPECT_EQ(row[0].value(), "2");
+    EXPECT_FALSE(row[1].has_value());
+    EXPECT_EQ(row[0]->data(), id_buffer);  // Same string storage reused
+
+    ASSERT_TRUE(iter->next(row));
+    EXPECT_EQ(row[1].value(), "c");
+
+    EXPECT_FALSE(iter->next(row));
+    EXPECT_EQ(row[0].value(), "3");  // Untouched at end
+    EXPECT_TRUE(iter->end());
+    EXPECT_FALSE(iter->last_error().has_value());
+}
+
+TEST_F(SQLiteTest, NextBatch) {
+    ASSERT_TRUE(conn_.execute(std::string(
+        "CREATE TABLE t (id INTEGER);"
+        "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 10) "
+        "INSERT INTO t SELECT x FROM c")).has_value());
+
+    auto iter = conn_.query("SELECT id FROM t ORDER BY id");
+    ASSERT_TRUE(iter.has_value());
+
+    std::vector<sqlite::Iterator::Row> batch;
+    std::vector<std::string> seen;
+    size_t batches = 0;
+    while (size_t n = iter->next_batch(batch, 4)) {
+        EXPECT_EQ(batch.size(), n);
+        for (const auto& row : batch) {
+            seen.push_back(row[0].value());
+        }
+        ++batches;
+    }
+
+    EXPECT_EQ(batches, 3u);
+    ASSERT_EQ(seen.size(), 10u);
+    EXPECT_EQ(seen.front(), "1");
+    EXPECT_EQ(seen.back(), "10");
+    EXPECT_TRUE(batch.empty());
+}
+
+TEST_F(SQLiteTest, IteratorReportsStepError) {
+    auto iter = conn_.query("SELECT abs(-9223372036854775807 - 1)");
+    ASSERT_TRUE(iter.has_value());
+    EXPECT_TRUE(iter->end());
+    ASSERT_TRUE(iter->last_error().has_value());
+    EXPECT_NE(iter->last_error()->find("overflow"), std::string::npos) << *iter->last_error();
+}
+
 } // namespace sqlgen::test
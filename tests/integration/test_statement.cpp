@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+#include "sqlgen/constraints.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Account {
+    PrimaryKey<int64_t> id;
+    Varchar<32> name;
+    std::optional<std::string> email;
+    double balance;
+    bool active;
+};
+
+class StatementTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(conn_.execute(create_table<Account>()).has_value());
+    }
+
+    std::string scalar(const std::string& sql) {
+        auto iter = conn_.query(sql);
+        EXPECT_TRUE(iter.has_value());
+        auto row = iter->next();
+        EXPECT_TRUE(row.has_value());
+        return row->at(0).value_or("NULL");
+    }
+
+    sqlite::Connection conn_{std::move(sqlite::connect(":memory:").value())};
+};
+
+TEST_F(StatementTest, BindRowFromInsertBuilder) {
+    auto stmt = conn_.prepare(insert<Account>());
+    ASSERT_TRUE(stmt.has_value()) << stmt.error();
+    EXPECT_EQ(stmt->parameter_count(), 5);
+
+    Account a{PrimaryKey<int64_t>{1}, Varchar<32>{"alice"}, std::string("a@example.com"), 10.5, true};
+    ASSERT_TRUE(stmt->bind_row(a).has_value());
+    ASSERT_TRUE(stmt->execute().has_value());
+
+    // Reuse the same statement for a second row without re-preparing
+    Account b{PrimaryKey<int64_t>{2}, Varchar<32>{"bob"}, std::nullopt, 0.25, false};
+    ASSERT_TRUE(stmt->bind_row(b).has_value());
+    ASSERT_TRUE(stmt->execute().has_value());
+
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM Account"), "2");
+    EXPECT_EQ(scalar("SELECT name FROM Account WHERE id = 1"), "alice");
+    EXPECT_EQ(scalar("SELECT email FROM Account WHERE id = 2"), "NULL");
+    EXPECT_EQ(scalar("SELECT active FROM Account WHERE id = 2"), "0");
+    EXPECT_EQ(scalar("SELECT balance FROM Account WHERE id = 2"), "0.25");
+}
+
+TEST_F(StatementTest, PrepareSelectBindsParams) {
+    ASSERT_TRUE(conn_.execute(std::string(
+        "INSERT INTO Account VALUES (1, 'alice', NULL, 5.0, 1), (2, 'bob', NULL, 7.0, 1)")).has_value());
+
+    auto query = select_from<Account>("name"_c) | where("id"_c == 1);
+    auto stmt = conn_.prepare(query);
+    ASSERT_TRUE(stmt.has_value()) << stmt.error();
+
+    auto iter = stmt->query();
+    ASSERT_TRUE(iter.has_value());
+    auto row = iter->next();
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(row->at(0).value(), "alice");
+
+    // Rebind values from another builder of the same type
+    ASSERT_TRUE(stmt->reset().has_value());
+    auto next_query = select_from<Account>("name"_c) | where("id"_c == 2);
+    ASSERT_TRUE(stmt->bind_all(next_query.params()).has_value());
+
+    auto iter2 = stmt->query();
+    ASSERT_TRUE(iter2.has_value());
+    auto row2 = iter2->next();
+    ASSERT_TRUE(row2.has_value());
+    EXPECT_EQ(row2->at(0).value(), "bob");
+}
+
+TEST_F(StatementTest, PrepareUpdateAndDelete) {
+    ASSERT_TRUE(conn_.execute(std::string(
+        "INSERT INTO Account VALUES (1, 'alice', NULL, 5.0, 1)")).has_value());
+
+    auto upd = conn_.prepare(update<Account>(set("balance"_c, 9.5)) | where("id"_c == 1));
+    ASSERT_TRUE(upd.has_value()) << upd.error();
+    ASSERT_TRUE(upd->execute().has_value());
+    EXPECT_EQ(scalar("SELECT balance FROM Account WHERE id = 1"), "9.5");
+
+    auto del = conn_.prepare(delete_from<Account>() | where("name"_c == "alice"));
+    ASSERT_TRUE(del.has_value()) << del.error();
+    ASSERT_TRUE(del->execute().has_value());
+    EXPECT_EQ(scalar("SELECT COUNT(*) FROM Account"), "0");
+}
+
+TEST_F(StatementTest, BindIndividualValues) {
+    auto stmt = conn_.prepare(std::string("SELECT ?1, ?2, ?3, ?4"));
+    ASSERT_TRUE(stmt.has_value());
+
+    ASSERT_TRUE(stmt->bind(1, 42).has_value());
+    ASSERT_TRUE(stmt->bind(2, std::string("text")).has_value());
+    ASSERT_TRUE(stmt->bind(3, std::optional<int>{}).has_value());
+    ASSERT_TRUE(stmt->bind(4, true).has_value());
+
+    auto iter = stmt->query();
+    ASSERT_TRUE(iter.has_value());
+    auto row = iter->next();
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(row->at(0).value(), "42");
+    EXPECT_EQ(row->at(1).value(), "text");
+    EXPECT_FALSE(row->at(2).has_value());
+    EXPECT_EQ(row->at(3).value(), "1");
+}
+
+TEST_F(StatementTest, ClearBindingsResetsToNull) {
+    auto stmt = conn_.prepare(std::string("SELECT ?1"));
+    ASSERT_TRUE(stmt.has_value());
+    ASSERT_TRUE(stmt->bind(1, 7).has_value());
+    ASSERT_TRUE(stmt->clear_bindings().has_value());
+
+    auto iter = stmt->query();
+    ASSERT_TRUE(iter.has_value());
+    auto row = iter->next();
+    ASSERT_TRUE(row.has_value());
+    EXPECT_FALSE(row->at(0).has_value());
+}
+
+TEST_F(StatementTest, BindOutOfRangeFails) {
+    auto stmt = conn_.prepare(std::string("SELECT ?1"));
+    ASSERT_TRUE(stmt.has_value());
+    auto result = stmt->bind(2, 1);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_FALSE(result.error().empty());
+}
+
+TEST_F(StatementTest, ExecuteReportsConstraintViolation) {
+    auto stmt = conn_.prepare(insert<Account>());
+    ASSERT_TRUE(stmt.has_value());
+
+    Account a{PrimaryKey<int64_t>{1}, Varchar<32>{"alice"}, std::nullopt, 1.0, true};
+    ASSERT_TRUE(stmt->bind_row(a).has_value());
+    ASSERT_TRUE(stmt->execute().has_value());
+
+    // Same primary key again
+    ASSERT_TRUE(stmt->bind_row(a).has_value());
+    EXPECT_FALSE(stmt->execute().has_value());
+
+    // The statement is still usable afterwards
+    a.id = 2;
+    ASSERT_TRUE(stmt->bind_row(a).has_value());
+    EXPECT_TRUE(stmt->execute().has_value());
+}
+
+TEST_F(StatementTest, PrepareInvalidSqlFails) {
+    auto stmt = conn_.prepare(std::string("SELECT FROM"));
+    ASSERT_FALSE(stmt.has_value());
+    EXPECT_FALSE(stmt.error().empty());
+}
+
+} // namespace sqlgen::test
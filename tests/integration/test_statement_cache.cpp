@@ -0,0 +1,260 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+#include "sqlgen/constraints.hpp"
+#include "sqlgen/functions.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Item {
+    PrimaryKey<int64_t> id;
+    std::string name;
+    int64_t qty;
+};
+
+class StatementCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(conn_.execute(create_table<Item>()).has_value());
+        ASSERT_TRUE(conn_.execute(std::string(
+            "INSERT INTO Item VALUES (1, 'bolt', 10), (2, 'nut', 20), (3, 'gear', 30)")).has_value());
+    }
+
+    std::optional<std::string> name_of(int64_t id) {
+        auto iter = conn_.query(select_from<Item>("name"_c) | where("id"_c == id));
+        EXPECT_TRUE(iter.has_value()) << iter.error();
+        auto row = iter->next();
+        if (!row) return std::nullopt;
+        return row->at(0);
+    }
+
+    sqlite::Connection conn_{std::move(sqlite::connect(":memory:").value())};
+};
+
+TEST_F(StatementCacheTest, SameQueryTypeHitsCache) {
+    auto before = conn_.statement_cache_stats();
+
+    EXPECT_EQ(name_of(1), "bolt");
+    EXPECT_EQ(name_of(2), "nut");
+    EXPECT_EQ(name_of(3), "gear");
+
+    auto after = conn_.statement_cache_stats();
+    EXPECT_EQ(after.misses - before.misses, 1u);
+    EXPECT_EQ(after.hits - before.hits, 2u);
+    EXPECT_EQ(after.size, before.size + 1);
+}
+
+TEST_F(StatementCacheTest, DifferentShapesGetDifferentStatements) {
+    auto by_id = [&](int64_t id) { return select_from<Item>("name"_c) | where("id"_c == id); };
+    auto by_qty = [&](int64_t qty) { return select_from<Item>("name"_c) | where("qty"_c > qty); };
+
+    auto a = conn_.query(by_id(2));
+    ASSERT_TRUE(a.has_value());
+    EXPECT_EQ(a->next()->at(0), "nut");
+
+    auto b = conn_.query(by_qty(25));
+    ASSERT_TRUE(b.has_value());
+    EXPECT_EQ(b->next()->at(0), "gear");
+
+    EXPECT_EQ(conn_.statement_cache_stats().hits, 0u);
+}
+
+TEST_F(StatementCacheTest, SqlTextFallback) {
+    auto before = conn_.statement_cache_stats();
+    for (int i = 0; i < 3; ++i) {
+        auto stmt = conn_.prepare(std::string("SELECT qty FROM Item WHERE id = ?1"));
+        ASSERT_TRUE(stmt.has_value());
+        ASSERT_TRUE(stmt->bind(1, i + 1).has_value());
+        auto iter = stmt->query();
+        ASSERT_TRUE(iter.has_value());
+        EXPECT_EQ(iter->next()->at(0), std::to_string((i + 1) * 10));
+    }
+    auto after = conn_.statement_cache_stats();
+    EXPECT_EQ(after.misses - before.misses, 1u);
+    EXPECT_EQ(after.hits - before.hits, 2u);
+}
+
+TEST_F(StatementCacheTest, HitClearsPreviousBindings) {
+    {
+        auto stmt = conn_.prepare(std::string("SELECT ?1"));
+        ASSERT_TRUE(stmt.has_value());
+        ASSERT_TRUE(stmt->bind(1, 5).has_value());
+    }
+
+    auto stmt = conn_.prepare(std::string("SELECT ?1"));
+    ASSERT_TRUE(stmt.has_value());
+    auto iter = stmt->query();
+    ASSERT_TRUE(iter.has_value());
+    EXPECT_FALSE(iter->next()->at(0).has_value());
+}
+
+TEST_F(StatementCacheTest, InUseStatementIsNotShared) {
+    auto first = conn_.query(select_from<Item>("name"_c) | where("id"_c == 1));
+    ASSERT_TRUE(first.has_value());
+
+    // Same query type while the first iterator is still open
+    auto second = conn_.query(select_from<Item>("name"_c) | where("id"_c == 2));
+    ASSERT_TRUE(second.has_value());
+
+    EXPECT_EQ(first->next()->at(0), "bolt");
+    EXPECT_EQ(second->next()->at(0), "nut");
+}
+
+TEST_F(StatementCacheTest, AbandonedIteratorIsReset) {
+    {
+        auto iter = conn_.query(select_from<Item>("name"_c) | where("qty"_c > 0));
+        ASSERT_TRUE(iter.has_value());
+        ASSERT_TRUE(iter->next().has_value());
+    }
+
+    auto iter = conn_.query(select_from<Item>("name"_c) | where("qty"_c > 0));
+    ASSERT_TRUE(iter.has_value());
+    size_t rows = 0;
+    while (iter->next()) ++rows;
+    EXPECT_EQ(rows, 3u);
+}
+
+TEST_F(StatementCacheTest, DroppedIteratorsResetTheirStatement) {
+    auto stmt = conn_.prepare(select_from<Item>() | where("qty"_c > 0));
+    ASSERT_TRUE(stmt.has_value());
+
+    {
+        auto iter = stmt->query();
+        ASSERT_TRUE(iter.has_value());
+        ASSERT_TRUE(iter->next().has_value());
+        EXPECT_TRUE(sqlite3_stmt_busy(stmt->handle()));
+    }
+    EXPECT_FALSE(sqlite3_stmt_busy(stmt->handle()));
+
+    {
+        auto iter = stmt->query<Item>();
+        ASSERT_TRUE(iter.has_value());
+        ASSERT_TRUE(iter->next().has_value());
+        EXPECT_TRUE(sqlite3_stmt_busy(stmt->handle()));
+    }
+    EXPECT_FALSE(sqlite3_stmt_busy(stmt->handle()));
+
+    {
+        auto iter = stmt->fetch_columns<Item>(1);
+        ASSERT_TRUE(iter.has_value());
+        sqlite::ColumnBatch<Item> batch;
+        ASSERT_TRUE(iter->next(batch).has_value());
+        EXPECT_TRUE(sqlite3_stmt_busy(stmt->handle()));
+    }
+    EXPECT_FALSE(sqlite3_stmt_busy(stmt->handle()));
+
+    // Move-assigning over an iterator ends its run too
+    auto iter = stmt->query<Item>();
+    ASSERT_TRUE(iter.has_value());
+    ASSERT_TRUE(iter->next().has_value());
+    auto other = conn_.query<Item>(std::string("SELECT * FROM Item"));
+    ASSERT_TRUE(other.has_value());
+    *iter = std::move(*other);
+    EXPECT_FALSE(sqlite3_stmt_busy(stmt->handle()));
+    auto rows = iter->collect();
+    ASSERT_TRUE(rows.has_value()) << rows.error();
+    EXPECT_EQ(rows->size(), 3u);
+}
+
+TEST(StatementCacheWalTest, DroppedIteratorReleasesReadSnapshot) {
+    const std::string path = ::testing::TempDir() + "glz_sqlgen_dropped_iterator.db";
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((path + suffix).c_str());
+    }
+    {
+        auto reader = sqlite::connect(path);
+        auto writer = sqlite::connect(path);
+        ASSERT_TRUE(reader.has_value() && writer.has_value());
+        ASSERT_TRUE(reader->execute(std::string("PRAGMA journal_mode=WAL")).has_value());
+        ASSERT_TRUE(reader->execute(create_table<Item>()).has_value());
+        ASSERT_TRUE(reader->execute(std::string(
+            "INSERT INTO Item VALUES (1, 'bolt', 10), (2, 'nut', 20), (3, 'gear', 30)")).has_value());
+
+        auto count = [&] {
+            auto n = reader->query<int64_t>(select_from<Item>(count_star()));
+            return n.has_value() ? n->next().value_or(std::nullopt).value_or(-1) : -1;
+        };
+
+        {
+            auto iter = reader->query<Item>(select_from<Item>() | where("qty"_c > 0));
+            ASSERT_TRUE(iter.has_value());
+            ASSERT_TRUE(iter->next().has_value());
+        }
+        EXPECT_EQ(count(), 3);
+
+        ASSERT_TRUE(writer->execute(std::string("INSERT INTO Item VALUES (4, 'cog', 40)")).has_value());
+        EXPECT_EQ(count(), 4);
+    }
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((path + suffix).c_str());
+    }
+}
+
+TEST_F(StatementCacheTest, ReleasedStatementIsReused) {
+    auto query = select_from<Item>("name"_c) | where("id"_c == 1);
+
+    sqlite3_stmt* first = nullptr;
+    {
+        auto stmt = conn_.prepare(query);
+        ASSERT_TRUE(stmt.has_value());
+        first = stmt->handle();
+    }
+
+    auto again = conn_.prepare(query);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ(again->handle(), first);
+
+    // While it is held, the next user gets a private copy
+    auto copy = conn_.prepare(query);
+    ASSERT_TRUE(copy.has_value());
+    EXPECT_NE(copy->handle(), first);
+}
+
+TEST_F(StatementCacheTest, EvictsLeastRecentlyUsed) {
+    conn_.clear_statement_cache();
+    conn_.set_statement_cache_capacity(2);
+    auto before = conn_.statement_cache_stats();
+
+    ASSERT_TRUE(conn_.prepare(std::string("SELECT 1")).has_value());
+    ASSERT_TRUE(conn_.prepare(std::string("SELECT 2")).has_value());
+    ASSERT_TRUE(conn_.prepare(std::string("SELECT 1")).has_value());  // Refresh
+    ASSERT_TRUE(conn_.prepare(std::string("SELECT 3")).has_value());  // Evicts SELECT 2
+
+    auto mid = conn_.statement_cache_stats();
+    EXPECT_EQ(mid.evictions - before.evictions, 1u);
+    EXPECT_EQ(mid.size, 2u);
+    EXPECT_EQ(mid.capacity, 2u);
+
+    ASSERT_TRUE(conn_.prepare(std::string("SELECT 1")).has_value());
+    EXPECT_EQ(conn_.statement_cache_stats().hits, mid.hits + 1);
+    ASSERT_TRUE(conn_.prepare(std::string("SELECT 2")).has_value());
+    EXPECT_EQ(conn_.statement_cache_stats().misses, mid.misses + 1);
+}
+
+TEST_F(StatementCacheTest, ZeroCapacityDisablesCaching) {
+    conn_.set_statement_cache_capacity(0);
+    EXPECT_EQ(conn_.statement_cache_stats().size, 0u);
+
+    EXPECT_EQ(name_of(1), "bolt");
+    EXPECT_EQ(name_of(1), "bolt");
+    EXPECT_EQ(conn_.statement_cache_stats().size, 0u);
+}
+
+TEST_F(StatementCacheTest, StatementOutlivesConnection) {
+    std::optional<sqlite::Statement> stmt;
+    {
+        auto conn = sqlite::connect(":memory:");
+        ASSERT_TRUE(conn.has_value());
+        auto prepared = conn->prepare(std::string("SELECT 42"));
+        ASSERT_TRUE(prepared.has_value());
+        stmt.emplace(std::move(*prepared));
+    }
+    // The connection close is deferred until the statement is finalized
+    EXPECT_EQ(stmt->sql(), "SELECT 42");
+}
+
+} // namespace sqlgen::test
@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include "sqlgen/sqlite.hpp"
+#include "sqlgen/query_builders.hpp"
+#include "sqlgen/query_clauses.hpp"
+#include "sqlgen/constraints.hpp"
+#include "sqlgen/functions.hpp"
+
+using namespace sqlgen::literals;
+
+namespace sqlgen::test {
+
+struct Employee {
+    PrimaryKey<int64_t> id;
+    Varchar<16> name;
+    std::optional<std::string> email;
+    double salary;
+    bool active;
+};
+
+struct EmployeeName {
+    std::string name;
+};
+
+struct Event {
+    int64_t id;
+    Date day;
+    DateTime at;
+    Timestamp ts;
+    std::vector<std::byte> payload;
+};
+
+class TypedQueryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(conn_.execute(create_table<Employee>()).has_value());
+        ASSERT_TRUE(conn_.execute(std::string(
+            "INSERT INTO Employee VALUES "
+            "(1, 'alice', 'a@example.com', 1500.5, 1), "
+            "(2, 'bob', NULL, 900.0, 0), "
+            "(3, 'carol', NULL, 2100.25, 1)")).has_value());
+    }
+
+    sqlite::Connection conn_{std::move(sqlite::connect(":memory:").value())};
+};
+
+TEST_F(TypedQueryTest, DecodesAllFields) {
+    auto iter = conn_.query<Employee>(select_from<Employee>() | order_by("id"_c));
+    ASSERT_TRUE(iter.has_value()) << iter.error();
+    auto rows = iter->collect();
+    ASSERT_TRUE(rows.has_value()) << rows.error();
+    ASSERT_EQ(rows->size(), 3u);
+
+    const auto& alice = rows->at(0);
+    EXPECT_EQ(alice.id.get(), 1);
+    EXPECT_EQ(alice.name.get(), "alice");
+    EXPECT_EQ(alice.email, "a@example.com");
+    EXPECT_DOUBLE_EQ(alice.salary, 1500.5);
+    EXPECT_TRUE(alice.active);
+
+    const auto& bob = rows->at(1);
+    EXPECT_EQ(bob.id.get(), 2);
+    EXPECT_FALSE(bob.email.has_value());
+    EXPECT_FALSE(bob.active);
+}
+
+TEST_F(TypedQueryTest, NextReturnsRowsThenNullopt) {
+    auto iter = conn_.query<Employee>(select_from<Employee>() | where("salary"_c > 1000.0) | order_by("id"_c));
+    ASSERT_TRUE(iter.has_value());
+
+    auto first = iter->next();
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(first->has_value());
+    EXPECT_EQ((*first)->name.get(), "alice");
+
+    auto second = iter->next();
+    ASSERT_TRUE(second.has_value() && second->has_value());
+    EXPECT_EQ((*second)->name.get(), "carol");
+
+    auto done = iter->next();
+    ASSERT_TRUE(done.has_value());
+    EXPECT_FALSE(done->has_value());
+    EXPECT_TRUE(iter->end());
+}
+
+TEST_F(TypedQueryTest, NextIntoReusesRow) {
+    auto iter = conn_.query<Employee>(select_from<Employee>() | order_by("id"_c));
+    ASSERT_TRUE(iter.has_value());
+
+    Employee row{};
+    std::vector<int64_t> ids;
+    while (true) {
+        auto has_row = iter->next(row);
+        ASSERT_TRUE(has_row.has_value()) << has_row.error();
+        if (!*has_row) break;
+        ids.push_back(row.id.get());
+    }
+    EXPECT_EQ(ids, (std::vector<int64_t>{1, 2, 3}));
+}
+
+TEST_F(TypedQueryTest, MatchesColumnsByName) {
+    // Column order differs from field order and the optional email is not selected
+    auto iter = conn_.query<Employee>(
+        select_from<Employee>("salary"_c, "active"_c, "name"_c, "id"_c) | where("id"_c == 1));
+    ASSERT_TRUE(iter.has_value());
+    auto row = iter->next();
+    ASSERT_TRUE(row.has_value() && row->has_value()) << row.error();
+    EXPECT_EQ((*row)->id.get(), 1);
+    EXPECT_EQ((*row)->name.get(), "alice");
+    EXPECT_DOUBLE_EQ((*row)->salary, 1500.5);
+    EXPECT_TRUE((*row)->active);
+    EXPECT_FALSE((*row)->email.has_value());
+}
+
+TEST_F(TypedQueryTest, MissingRequiredColumnFails) {
+    auto iter = conn_.query<Employee>(select_from<Employee>("salary"_c, "id"_c) | where("id"_c == 3));
+    ASSERT_TRUE(iter.has_value());
+    auto row = iter->next();
+    ASSERT_FALSE(row.has_value());
+    EXPECT_NE(row.error().find("no result column for field 'name'"), std::string::npos) << row.error();
+}
+
+TEST_F(TypedQueryTest, ProjectionStruct) {
+    auto rows = conn_.query<EmployeeName>(select_from<Employee>("name"_c) | order_by("name"_c))->collect();
+    ASSERT_TRUE(rows.has_value());
+    ASSERT_EQ(rows->size(), 3u);
+    EXPECT_EQ(rows->at(2).name, "carol");
+}
+
+TEST_F(TypedQueryTest, ScalarFromFirstColumn) {
+    auto count = conn_.query<int64_t>(select_from<Employee>(count_star()));
+    ASSERT_TRUE(count.has_value());
+    auto value = count->next();
+    ASSERT_TRUE(value.has_value() && value->has_value());
+    EXPECT_EQ(**value, 3);
+
+    auto emails = conn_.query<std::optional<std::string>>(
+        select_from<Employee>("email"_c) | order_by("id"_c))->collect();
+    ASSERT_TRUE(emails.has_value());
+    EXPECT_EQ(emails->at(0), "a@example.com");
+    EXPECT_FALSE(emails->at(1).has_value());
+}
+
+TEST_F(TypedQueryTest, HandWrittenSql) {
+    auto rows = conn_.query<EmployeeName>(std::string("SELECT upper(name) AS name FROM Employee WHERE id = 2"))->collect();
+    ASSERT_TRUE(rows.has_value());
+    ASSERT_EQ(rows->size(), 1u);
+    EXPECT_EQ(rows->at(0).name, "BOB");
+}
+
+TEST_F(TypedQueryTest, NullIntoNonOptionalFails) {
+    auto rows = conn_.query<EmployeeName>(std::string("SELECT email AS name FROM Employee WHERE id = 2"))->collect();
+    ASSERT_FALSE(rows.has_value());
+    EXPECT_NE(rows.error().find("name"), std::string::npos);
+}
+
+TEST_F(TypedQueryTest, OutOfRangeIntegersFail) {
+    auto narrow = conn_.query<int32_t>(std::string("SELECT 4294967296 AS id"))->collect();
+    ASSERT_FALSE(narrow.has_value());
+    EXPECT_NE(narrow.error().find("4294967296"), std::string::npos);
+
+    EXPECT_FALSE(conn_.query<uint8_t>(std::string("SELECT 256"))->collect().has_value());
+    EXPECT_FALSE(conn_.query<uint32_t>(std::string("SELECT -1"))->collect().has_value());
+
+    auto fits = conn_.query<int16_t>(std::string("SELECT -32768"))->collect();
+    ASSERT_TRUE(fits.has_value()) << fits.error();
+    EXPECT_EQ(fits->front(), -32768);
+
+    // The bit pattern Statement::bind stores for large 64-bit unsigned values
+    auto wide = conn_.query<uint64_t>(std::string("SELECT -1"))->collect();
+    ASSERT_TRUE(wide.has_value()) << wide.error();
+    EXPECT_EQ(wide->front(), std::numeric_limits<uint64_t>::max());
+}
+
+TEST_F(TypedQueryTest, ConstraintValidationOnDecode) {
+    ASSERT_TRUE(conn_.execute(std::string(
+        "INSERT INTO Employee VALUES (4, 'a name far too long for varchar', NULL, 1.0, 1)")).has_value());
+    auto rows = conn_.query<Employee>(select_from<Employee>() | where("id"_c == 4))->collect();
+    EXPECT_FALSE(rows.has_value());
+}
+
+TEST_F(TypedQueryTest, DomainTypesAndBlobs) {
+    ASSERT_TRUE(conn_.execute(std::string(
+        "CREATE TABLE Event (id INTEGER, day TEXT, at TEXT, ts INTEGER, payload BLOB);"
+        "INSERT INTO Event VALUES (1, '2024-02-29', '2024-02-29 13:45:10', 1700000000, x'00ff10')")).has_value());
+
+    auto rows = conn_.query<Event>(select_from<Event>())->collect();
+    ASSERT_TRUE(rows.has_value()) << rows.error();
+    ASSERT_EQ(rows->size(), 1u);
+
+    const auto& e = rows->at(0);
+    EXPECT_EQ(e.day, Date(2024, 2, 29));
+    EXPECT_EQ(e.at.to_string(), DateTime(2024, 2, 29, 13, 45, 10).to_string());
+    EXPECT_EQ(e.ts.get(), 1700000000);
+    ASSERT_EQ(e.payload.size(), 3u);
+    EXPECT_EQ(e.payload[1], std::byte{0xff});
+}
+
+TEST_F(TypedQueryTest, ErrorsAreReported) {
+    auto iter = conn_.query<int64_t>(std::string("SELECT * FROM missing_table"));
+    EXPECT_FALSE(iter.has_value());
+}
+
+TEST_F(TypedQueryTest, DoubleLiteralsReadBackExactly) {
+    for (double value : {1e-9, 0.1, 1.0 / 3.0, 19.999999999, -2.5e-300, 6.02214076e23, -0.0}) {
+        auto rows = conn_.query<double>(std::string("SELECT ") + transpilation::to_sql(transpilation::Value{value}))
+                        ->collect();
+        ASSERT_TRUE(rows.has_value()) << rows.error();
+        EXPECT_EQ(std::bit_cast<uint64_t>(rows->front()), std::bit_cast<uint64_t>(value)) << rows->front();
+    }
+
+    auto inf = conn_.query<double>(std::string("SELECT ") +
+                                   transpilation::to_sql(transpilation::Value{std::numeric_limits<double>::infinity()}))
+                   ->collect();
+    ASSERT_TRUE(inf.has_value()) << inf.error();
+    EXPECT_TRUE(std::isinf(inf->front()));
+
+    // An inlined float reads back as the double it is bound as
+    auto inlined = conn_.query<double>(std::string("SELECT ") + transpilation::to_sql(transpilation::Value{0.1f}))
+                       ->collect();
+    ASSERT_TRUE(inlined.has_value()) << inlined.error();
+    auto stmt = conn_.prepare(std::string("SELECT ?1"));
+    ASSERT_TRUE(stmt.has_value());
+    ASSERT_TRUE(stmt->bind(1, 0.1f).has_value());
+    auto bound = stmt->query<double>()->collect();
+    ASSERT_TRUE(bound.has_value()) << bound.error();
+    EXPECT_EQ(std::bit_cast<uint64_t>(inlined->front()), std::bit_cast<uint64_t>(bound->front()));
+    EXPECT_EQ(inlined->front(), 0.10000000149011612);
+}
+
+TEST_F(TypedQueryTest, StringLiteralsReadBackExactly) {
+    using namespace std::string_literals;
+    for (const std::string& value : {"it's"s, "''"s, "a\0b"s, "\0'\0"s, std::string(70000, '\'')}) {
+        auto rows = conn_.query<std::string>(std::string("SELECT ") + transpilation::quote_string(value))->collect();
+        ASSERT_TRUE(rows.has_value()) << rows.error();
+        EXPECT_EQ(rows->front(), value);
+    }
+}
+
+} // namespace sqlgen::test
@@ -49,6 +49,28 @@ TEST(InsertTest, InsertOrReplace) {
     EXPECT_TRUE(sql.find("VALUES (?, ?, ?)") != std::string::npos);
 }
 
+TEST(InsertTest, MultiRowValues) {
+    auto query = insert<Person>().rows(3);
+    auto sql = query.to_sql();
+
+    EXPECT_EQ(sql, "INSERT INTO \"Person\" (\"name\", \"age\", \"height\") VALUES (?, ?, ?), (?, ?, ?), (?, ?, ?)");
+    EXPECT_EQ(Insert<Person>::field_count, 3u);
+}
+
+TEST(InsertTest, MultiRowNeedsAtLeastOneRow) {
+    auto sql = insert<Person>().rows(0).to_sql();
+
+    EXPECT_EQ(sql, "INSERT INTO \"Person\" (\"name\", \"age\", \"height\") VALUES (?, ?, ?)");
+    EXPECT_EQ(sql, insert<Person>().rows(1).to_sql());
+}
+
+TEST(InsertTest, MultiRowKeepsOrReplace) {
+    auto sql = insert_or_replace<User>().rows(2).to_sql();
+
+    EXPECT_TRUE(sql.find("INSERT OR REPLACE INTO \"User\"") != std::string::npos);
+    EXPECT_TRUE(sql.find("VALUES (?, ?, ?, ?), (?, ?, ?, ?)") != std::string::npos);
+}
+
 // UPDATE Tests
 TEST(UpdateTest, UpdateSingleColumn) {
     auto query = update<Person>(set("age"_c, 30));
@@ -130,6 +152,46 @@ TEST(DeleteTest, DeleteWithStringCondition) {
     EXPECT_TRUE(sql.find("WHERE \"username\" = 'deleted'") != std::string::npos);
 }
 
+// RETURNING Tests
+TEST(ReturningTest, InsertReturningColumns) {
+    auto query = insert<User>() | returning("id"_c, "username"_c);
+    auto sql = query.to_sql();
+
+    EXPECT_EQ(sql, "INSERT INTO \"User\" (\"id\", \"username\", \"email\", \"active\") "
+                   "VALUES (?, ?, ?, ?) RETURNING \"id\", \"username\"");
+}
+
+TEST(ReturningTest, InsertReturningAllFields) {
+    auto query = insert_or_replace<Person>().rows(2) | returning();
+    auto sql = query.to_sql();
+
+    EXPECT_TRUE(sql.find("INSERT OR REPLACE INTO \"Person\"") != std::string::npos);
+    EXPECT_TRUE(sql.find("VALUES (?, ?, ?), (?, ?, ?) RETURNING \"name\", \"age\", \"height\"") != std::string::npos);
+}
+
+TEST(ReturningTest, UpdateReturningAfterWhere) {
+    auto query = update<Person>(set("age"_c, 30)) | where("name"_c == "Alice") | returning("age"_c);
+    auto sql = query.to_sql();
+
+    EXPECT_EQ(sql, "UPDATE \"Person\" SET \"age\" = 30 WHERE \"name\" = 'Alice' RETURNING \"age\"");
+}
+
+TEST(ReturningTest, UpdateReturningBeforeWhere) {
+    auto query = update<Person>(set("age"_c, 30)) | returning("age"_c) | where("name"_c == "Alice");
+    auto sql = query.to_sql();
+
+    EXPECT_EQ(sql, "UPDATE \"Person\" SET \"age\" = 30 WHERE \"name\" = 'Alice' RETURNING \"age\"");
+}
+
+TEST(ReturningTest, DeleteReturning) {
+    auto query = delete_from<User>() | where("active"_c == false) | returning("id"_c);
+    auto sql = query.to_sql();
+
+    EXPECT_EQ(sql, "DELETE FROM \"User\" WHERE \"active\" = 0 RETURNING \"id\"");
+    EXPECT_EQ((delete_from<User>() | returning()).to_sql(),
+              "DELETE FROM \"User\" RETURNING \"id\", \"username\", \"email\", \"active\"");
+}
+
 // CREATE TABLE Tests
 TEST(CreateTableTest, BasicCreateTable) {
     auto query = create_table<Person>();
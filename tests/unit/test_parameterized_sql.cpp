@@ -0,0 +1,167 @@
+#include <glaze/glaze.hpp>
+#include <gtest/gtest.h>
+#include <sqlgen/core.hpp>
+#include <sqlgen/query_builders.hpp>
+#include <sqlgen/query_clauses.hpp>
+#include <sqlgen/advanced_conditions.hpp>
+#include <sqlgen/functions.hpp>
+
+using namespace sqlgen;
+using namespace sqlgen::literals;
+
+namespace test_parameterized_sql {
+
+struct Person {
+    int id;
+    std::string name;
+    int age;
+    double salary;
+};
+
+struct Orders {
+    int id;
+    int person_id;
+    double amount;
+};
+
+} // namespace test_parameterized_sql
+
+using test_parameterized_sql::Person;
+using test_parameterized_sql::Orders;
+
+TEST(ParameterizedSqlTest, SelectWhereUsesPlaceholder) {
+    auto query = select_from<Person>() | where("age"_c > 30);
+    auto [sql, params] = query.to_parameterized_sql();
+
+    EXPECT_EQ(sql, "SELECT \"id\", \"name\", \"age\", \"salary\" FROM \"Person\" WHERE \"age\" > ?1");
+    static_assert(std::is_same_v<decltype(params), std::tuple<int>>);
+    EXPECT_EQ(std::get<0>(params), 30);
+}
+
+TEST(ParameterizedSqlTest, SqlTextDoesNotDependOnLiteral) {
+    auto sql1 = (select_from<Person>() | where("age"_c > 30)).to_parameterized_sql().sql;
+    auto sql2 = (select_from<Person>() | where("age"_c > 31)).to_parameterized_sql().sql;
+    EXPECT_EQ(sql1, sql2);
+}
+
+TEST(ParameterizedSqlTest, StringLiteralsBecomeStdString) {
+    auto query = select_from<Person>("id"_c) | where("name"_c == "Alice" && "age"_c >= 18);
+    auto [sql, params] = query.to_parameterized_sql();
+
+    EXPECT_EQ(sql, "SELECT \"id\" FROM \"Person\" WHERE \"name\" = ?1 AND \"age\" >= ?2");
+    static_assert(std::is_same_v<decltype(params), std::tuple<std::string, int>>);
+    EXPECT_EQ(std::get<0>(params), "Alice");
+    EXPECT_EQ(std::get<1>(params), 18);
+}
+
+TEST(ParameterizedSqlTest, LimitAndOffsetAreBound) {
+    auto query = select_from<Person>("id"_c) | order_by("id"_c) | limit(10, 20);
+    auto [sql, params] = query.to_parameterized_sql();
+
+    EXPECT_EQ(sql, "SELECT \"id\" FROM \"Person\" ORDER BY \"id\" LIMIT ?1 OFFSET ?2");
+    EXPECT_EQ(std::get<0>(params), 10);
+    EXPECT_EQ(std::get<1>(params), 20);
+}
+
+TEST(ParameterizedSqlTest, LimitWithoutOffsetBindsZero) {
+    auto query = select_from<Person>("id"_c) | limit(5);
+    auto [sql, params] = query.to_parameterized_sql();
+
+    EXPECT_EQ(sql, "SELECT \"id\" FROM \"Person\" LIMIT ?1 OFFSET ?2");
+    EXPECT_EQ(std::get<0>(params), 5);
+    EXPECT_EQ(std::get<1>(params), 0);
+}
+
+TEST(ParameterizedSqlTest, AdvancedConditions) {
+    auto query = select_from<Person>("id"_c)
+        | where(in("age"_c, 20, 30) && between("salary"_c, 1000.0, 2000.0) && like("name"_c, "A%"));
+    auto [sql, params] = query.to_parameterized_sql();
+
+    EXPECT_EQ(sql, "SELECT \"id\" FROM \"Person\" WHERE \"age\" IN (?1, ?2) AND \"salary\" BETWEEN ?3 AND ?4 AND \"name\" LIKE ?5");
+    EXPECT_EQ(std::get<0>(params), 20);
+    EXPECT_EQ(std::get<1>(params), 30);
+    EXPECT_DOUBLE_EQ(std::get<2>(params), 1000.0);
+    EXPECT_DOUBLE_EQ(std::get<3>(params), 2000.0);
+    EXPECT_EQ(std::get<4>(params), "A%");
+}
+
+TEST(ParameterizedSqlTest, IsNullHasNoParams) {
+    auto query = delete_from<Person>() | where(is_null("name"_c));
+    auto [sql, params] = query.to_parameterized_sql();
+
+    EXPECT_EQ(sql, "DELETE FROM \"Person\" WHERE \"name\" IS NULL");
+    static_assert(std::tuple_size_v<decltype(params)> == 0);
+}
+
+TEST(ParameterizedSqlTest, FunctionArgumentsAreBound) {
+    auto query = select_from<Person>(round("salary"_c, 2)) | where(substring("name"_c, 1, 3) == "Ali");
+    auto [sql, params] = query.to_parameterized_sql();
+
+    EXPECT_EQ(sql, "SELECT ROUND(\"salary\", ?1) FROM \"Person\" WHERE SUBSTR(\"name\", ?2, ?3) = ?4");
+    EXPECT_EQ(std::get<0>(params), 2);
+    EXPECT_EQ(std::get<1>(params), 1);
+    EXPECT_EQ(std::get<2>(params), 3);
+    EXPECT_EQ(std::get<3>(params), "Ali");
+}
+
+TEST(ParameterizedSqlTest, NumberingFollowsTreeOrderNotEmitOrder) {
+    // days_between emits its second argument first
+    auto query = select_from<Person>(days_between("2024-01-01", "2024-12-31"));
+    auto [sql, params] = query.to_parameterized_sql();
+
+    EXPECT_EQ(sql, "SELECT (julianday(?2) - julianday(?1)) FROM \"Person\"");
+    EXPECT_EQ(std::get<0>(params), "2024-01-01");
+    EXPECT_EQ(std::get<1>(params), "2024-12-31");
+}
+
+TEST(ParameterizedSqlTest, JoinAndHaving) {
+    auto query = select_from<Person>("name"_t1, sum("amount"_t2))
+        | inner_join<Orders, "t2">("id"_t1 == "person_id"_t2)
+        | where("amount"_t2 > 5.0)
+        | group_by("name"_t1)
+        | having(sum("amount"_t2) > 100.0);
+    auto [sql, params] = query.to_parameterized_sql();
+
+    EXPECT_TRUE(sql.find("WHERE \"t2\".\"amount\" > ?1") != std::string::npos) << sql;
+    EXPECT_TRUE(sql.find("HAVING SUM(\"t2\".\"amount\") > ?2") != std::string::npos) << sql;
+    EXPECT_DOUBLE_EQ(std::get<0>(params), 5.0);
+    EXPECT_DOUBLE_EQ(std::get<1>(params), 100.0);
+}
+
+TEST(ParameterizedSqlTest, UpdateSetsAndWhere) {
+    auto query = update<Person>(set("age"_c, 31), set("name"_c, std::string("Bob"))) | where("id"_c == 7);
+    auto [sql, params] = query.to_parameterized_sql();
+
+    EXPECT_EQ(sql, "UPDATE \"Person\" SET \"age\" = ?1, \"name\" = ?2 WHERE \"id\" = ?3");
+    static_assert(std::is_same_v<decltype(params), std::tuple<int, std::string, int>>);
+    EXPECT_EQ(std::get<0>(params), 31);
+    EXPECT_EQ(std::get<1>(params), "Bob");
+    EXPECT_EQ(std::get<2>(params), 7);
+}
+
+TEST(ParameterizedSqlTest, DeleteWhere) {
+    auto query = delete_from<Person>() | where("age"_c < 18 || "name"_c == "test");
+    auto [sql, params] = query.to_parameterized_sql();
+
+    EXPECT_EQ(sql, "DELETE FROM \"Person\" WHERE \"age\" < ?1 OR \"name\" = ?2");
+    EXPECT_EQ(std::get<0>(params), 18);
+    EXPECT_EQ(std::get<1>(params), "test");
+}
+
+TEST(ParameterizedSqlTest, ReturningFollowsWhere) {
+    auto query = update<Person>(set("salary"_c, 10.0)) | returning("id"_c, "salary"_c * 2.0) | where("age"_c > 40);
+    auto [sql, params] = query.to_parameterized_sql();
+
+    EXPECT_EQ(sql, "UPDATE \"Person\" SET \"salary\" = ?1 WHERE \"age\" > ?2 RETURNING \"id\", (\"salary\" * ?3)");
+    static_assert(std::is_same_v<decltype(params), std::tuple<double, int, double>>);
+    EXPECT_EQ(std::get<1>(params), 40);
+    EXPECT_DOUBLE_EQ(std::get<2>(params), 2.0);
+
+    auto deleted = (delete_from<Person>() | where("id"_c == 3) | returning("name"_c)).to_parameterized_sql();
+    EXPECT_EQ(deleted.sql, "DELETE FROM \"Person\" WHERE \"id\" = ?1 RETURNING \"name\"");
+}
+
+TEST(ParameterizedSqlTest, PlainToSqlUnchanged) {
+    auto query = select_from<Person>("id"_c) | where("age"_c > 30) | limit(10);
+    EXPECT_EQ(query.to_sql(), "SELECT \"id\" FROM \"Person\" WHERE \"age\" > 30 LIMIT 10");
+}
@@ -0,0 +1,119 @@
+// Allocation counts of SQL emission
+// Replacing the global operator new affects the whole program, so these
+// tests are built into their own executable (glz_sqlgen_allocation_tests)
+// rather than glz_sqlgen_tests.
+
+#include <glaze/glaze.hpp>
+#include <gtest/gtest.h>
+#include <sqlgen/core.hpp>
+#include <sqlgen/constraints.hpp>
+#include <sqlgen/query_builders.hpp>
+#include <sqlgen/query_clauses.hpp>
+#include <cstdlib>
+#include <new>
+
+using namespace sqlgen;
+using namespace sqlgen::literals;
+
+// Count heap allocations made by the current thread
+// The deletes stay out of line: inlined into the tests, GCC would pair their
+// free() with operator new and warn about a mismatched deallocation
+namespace {
+thread_local size_t allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace test_sql_allocations {
+
+struct Account {
+    PrimaryKey<int64_t> id;
+    Varchar<32> owner;
+    std::optional<std::string> note;
+    double balance;
+};
+
+struct Wide {
+    int64_t c00, c01, c02, c03, c04, c05, c06, c07, c08, c09;
+    int64_t c10, c11, c12, c13, c14, c15, c16, c17, c18, c19;
+    double c20, c21, c22, c23, c24, c25, c26, c27, c28, c29;
+};
+
+} // namespace test_sql_allocations
+
+using test_sql_allocations::Account;
+using test_sql_allocations::Wide;
+
+TEST(SqlAllocationTest, StaticShapesDoNotAllocate) {
+    size_t total = 0;
+    const size_t before = allocations;
+    for (int i = 0; i < 100; ++i) {
+        total += select_from<Account>().to_sql().size();
+        total += insert<Account>().to_sql().size();
+        total += insert_or_replace<Account>().to_sql().size();
+        total += create_table<Account>(i % 2 == 0).to_sql().size();
+    }
+    const size_t after = allocations;
+
+    EXPECT_GT(total, 0u);
+    EXPECT_EQ(after - before, 0u);
+
+    // Shapes with runtime parts still build their SQL
+    const size_t dynamic_before = allocations;
+    auto multi = insert<Account>().rows(3).to_sql();
+    EXPECT_GT(allocations, dynamic_before);
+}
+
+TEST(SqlAllocationTest, WideProjectionAllocatesOnce) {
+    auto all_fields = select_from<Wide>() | where("c00"_c > 5 && "c29"_c < 2.5) | order_by("c10"_c) | limit(10);
+    auto listed = select_from<Wide>(
+        "c00"_c, "c01"_c, "c02"_c, "c03"_c, "c04"_c, "c05"_c, "c06"_c, "c07"_c, "c08"_c, "c09"_c,
+        "c10"_c, "c11"_c, "c12"_c, "c13"_c, "c14"_c, "c15"_c, "c16"_c, "c17"_c, "c18"_c, "c19"_c,
+        "c20"_c, "c21"_c, "c22"_c, "c23"_c, "c24"_c, "c25"_c, "c26"_c, "c27"_c, "c28"_c, "c29"_c)
+        | where("c00"_c == 1);
+
+    size_t before = allocations;
+    std::string sql = all_fields.to_sql();
+    EXPECT_EQ(allocations - before, 1u);
+    EXPECT_TRUE(sql.starts_with("SELECT \"c00\", \"c01\""));
+
+    before = allocations;
+    sql = listed.to_sql();
+    EXPECT_EQ(allocations - before, 1u);
+    EXPECT_NE(sql.find("\"c29\" FROM \"Wide\" WHERE \"c00\" = 1"), std::string::npos);
+
+    // Emitting into a buffer with room allocates nothing
+    std::string buffer;
+    buffer.reserve(1024);
+    before = allocations;
+    listed.emit(buffer);
+    all_fields.emit(buffer);
+    (update<Wide>(set("c01"_c, 2), set("c02"_c, 3)) | where("c00"_c == 1)).emit(buffer);
+    EXPECT_EQ(allocations - before, 0u);
+}
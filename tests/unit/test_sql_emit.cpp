@@ -0,0 +1,173 @@
+#include <glaze/glaze.hpp>
+#include <gtest/gtest.h>
+#include <sqlgen/core.hpp>
+#include <sqlgen/query_builders.hpp>
+#include <sqlgen/query_clauses.hpp>
+#include <sqlgen/advanced_conditions.hpp>
+#include <sqlgen/functions.hpp>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+using namespace sqlgen;
+using namespace sqlgen::literals;
+namespace t = sqlgen::transpilation;
+
+namespace test_sql_emit {
+
+struct Order {
+    int64_t id;
+    int64_t customer_id;
+    double total;
+    std::string status;
+};
+
+} // namespace test_sql_emit
+
+using test_sql_emit::Order;
+
+TEST(SqlEmitTest, EmitAppendsToBuffer) {
+    std::string out = "-- ";
+    t::emit(out, "total"_c > 10);
+    EXPECT_EQ(out, "-- \"total\" > 10");
+}
+
+TEST(SqlEmitTest, ToSqlMatchesEmit) {
+    auto cond = ("total"_c > 10 && "status"_c == "open") || "customer_id"_c == 7;
+    std::string out;
+    t::emit(out, cond);
+    EXPECT_EQ(t::to_sql(cond), out);
+    EXPECT_EQ(out, "(\"total\" > 10 AND \"status\" = 'open') OR \"customer_id\" = 7");
+}
+
+TEST(SqlEmitTest, Integers) {
+    EXPECT_EQ(t::to_sql(t::Value<int64_t>{std::numeric_limits<int64_t>::min()}), "-9223372036854775808");
+    EXPECT_EQ(t::to_sql(t::Value<uint64_t>{std::numeric_limits<uint64_t>::max()}), "18446744073709551615");
+    EXPECT_EQ(t::to_sql(t::Value<int>{0}), "0");
+    EXPECT_EQ(t::to_sql(t::Value<bool>{true}), "1");
+}
+
+TEST(SqlEmitTest, Doubles) {
+    EXPECT_EQ(t::to_sql(t::Value<double>{2.5}), "2.5");
+    EXPECT_EQ(t::to_sql(t::Value<double>{-3.0}), "-3");
+    EXPECT_EQ(t::to_sql(t::Value<double>{100.0}), "100");
+    EXPECT_EQ(t::to_sql(t::Value<double>{1e20}), "1e+20");
+    EXPECT_EQ(t::to_sql(t::Value<float>{0.25f}), "0.25");
+    EXPECT_EQ(t::to_sql(t::Value<float>{0.1f}), "0.10000000149011612");
+    EXPECT_EQ(t::to_sql(t::Value<double>{-0.0}), "-0.0");
+    EXPECT_EQ(t::to_sql(t::Value<float>{-0.0f}), "-0.0");
+    EXPECT_EQ(t::to_sql(t::Value<double>{0.0}), "0");
+    EXPECT_EQ(t::to_sql(t::Value<double>{1e-9}), "1e-09");
+    EXPECT_EQ(t::to_sql(t::Value<double>{0.1 + 0.2}), "0.30000000000000004");
+}
+
+TEST(SqlEmitTest, NonFiniteDoubles) {
+    EXPECT_EQ(t::to_sql(t::Value<double>{std::numeric_limits<double>::quiet_NaN()}), "NULL");
+    EXPECT_EQ(t::to_sql(t::Value<double>{std::numeric_limits<double>::infinity()}), "9e999");
+    EXPECT_EQ(t::to_sql(t::Value<double>{-std::numeric_limits<double>::infinity()}), "-9e999");
+}
+
+TEST(SqlEmitTest, SmallThresholdsAreKept) {
+    EXPECT_EQ(t::to_sql("price"_c > 0.0000001), "\"price\" > 1e-07");
+    EXPECT_EQ(t::to_sql("price"_c < 19.999999999), "\"price\" < 19.999999999");
+}
+
+/// Parse a literal back as a double and compare bit patterns with the
+/// double value widens to (what Statement::bind would bind)
+template <class T>
+void expect_round_trip(T value) {
+    const std::string literal = t::to_sql(t::Value<T>{value});
+    ASSERT_LE(literal.size(), t::sql_size_v<T>);
+
+    double parsed{};
+    auto [ptr, ec] = std::from_chars(literal.data(), literal.data() + literal.size(), parsed);
+    ASSERT_EQ(ec, std::errc{}) << literal;
+    ASSERT_EQ(ptr, literal.data() + literal.size()) << literal;
+    EXPECT_EQ(std::bit_cast<uint64_t>(parsed), std::bit_cast<uint64_t>(static_cast<double>(value))) << literal;
+}
+
+TEST(SqlEmitTest, DoubleLiteralsRoundTrip) {
+    for (double value : {0.0, -0.0, 1.0, 0.1, 1e-9, 1.0 / 3.0, 123456.789,
+                         std::numeric_limits<double>::min(),
+                         std::numeric_limits<double>::max(),
+                         std::numeric_limits<double>::lowest(),
+                         std::numeric_limits<double>::denorm_min()}) {
+        expect_round_trip(value);
+    }
+
+    // Random bit patterns cover every exponent and mantissa shape
+    std::mt19937_64 rng(20240611);
+    for (int i = 0; i < 100000; ++i) {
+        const double value = std::bit_cast<double>(rng());
+        if (std::isfinite(value)) {
+            expect_round_trip(value);
+        }
+    }
+}
+
+TEST(SqlEmitTest, FloatLiteralsRoundTrip) {
+    std::mt19937 rng(7);
+    for (int i = 0; i < 100000; ++i) {
+        const float value = std::bit_cast<float>(static_cast<uint32_t>(rng()));
+        if (std::isfinite(value)) {
+            expect_round_trip(value);
+        }
+    }
+}
+
+TEST(SqlEmitTest, BuildersAppendToBuffer) {
+    auto query = select_from<Order>("id"_c, "total"_c) | where("customer_id"_c == 3) | order_by("total"_c.desc());
+
+    std::string out = "EXPLAIN ";
+    query.emit(out);
+    EXPECT_EQ(out, "EXPLAIN " + query.to_sql());
+
+    out.clear();
+    select_from<Order>().emit(out);
+    EXPECT_EQ(out, select_from<Order>().to_sql());
+}
+
+TEST(SqlEmitTest, ReusedBufferKeepsCapacity) {
+    std::string out;
+    out.reserve(256);
+    const auto* data = out.data();
+
+    for (int64_t id = 0; id < 50; ++id) {
+        out.clear();
+        (update<Order>(set("total"_c, 1.5)) | where("id"_c == id)).emit(out);
+        EXPECT_EQ(out, (update<Order>(set("total"_c, 1.5)) | where("id"_c == id)).to_sql());
+        out.clear();
+        (delete_from<Order>() | where("id"_c == id)).emit(out);
+    }
+    EXPECT_EQ(out.data(), data);
+}
+
+TEST(SqlEmitTest, SizeHintCoversQueriesWithoutStrings) {
+    auto select = select_from<Order>("customer_id"_c, sum("total"_c))
+        | where(("total"_c > 10 && "id"_c < 1000000) || "customer_id"_c == -5)
+        | group_by("customer_id"_c)
+        | having(sum("total"_c) > 99.75)
+        | order_by("customer_id"_c)
+        | limit(20, 40);
+    EXPECT_LE(select.to_sql().size(), decltype(select)::sql_size);
+
+    auto joined = select_from<Order>() | inner_join<Order, "o2">("id"_c == "o2.customer_id"_c) | where("id"_c > 1);
+    EXPECT_LE(joined.to_sql().size(), decltype(joined)::sql_size);
+
+    auto insert_query = insert<Order>() | returning();
+    EXPECT_LE(insert_query.to_sql().size(), decltype(insert_query)::sql_size);
+
+    auto update_query = update<Order>(set("total"_c, "total"_c * 2), set("customer_id"_c, 9))
+        | where(between("id"_c, 1, 100))
+        | returning("id"_c, "total"_c);
+    EXPECT_LE(update_query.to_sql().size(), decltype(update_query)::sql_size);
+
+    auto delete_query = delete_from<Order>() | where(in("id"_c, 1, 2, 3)) | returning("id"_c);
+    EXPECT_LE(delete_query.to_sql().size(), decltype(delete_query)::sql_size);
+
+    auto func = year("status"_c) + days_between("status"_c, "status"_c);
+    EXPECT_LE(t::to_sql(func).size(), t::sql_size_v<decltype(func)>);
+}
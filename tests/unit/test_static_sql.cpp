@@ -0,0 +1,66 @@
+#include <glaze/glaze.hpp>
+#include <gtest/gtest.h>
+#include <sqlgen/core.hpp>
+#include <sqlgen/constraints.hpp>
+#include <sqlgen/query_builders.hpp>
+#include <sqlgen/query_clauses.hpp>
+
+using namespace sqlgen;
+using namespace sqlgen::literals;
+
+namespace test_static_sql {
+
+struct Account {
+    PrimaryKey<int64_t> id;
+    Varchar<32> owner;
+    std::optional<std::string> note;
+    double balance;
+};
+
+} // namespace test_static_sql
+
+using test_static_sql::Account;
+
+static_assert(std::is_same_v<decltype(select_from<Account>().to_sql()), std::string_view>);
+static_assert(std::is_same_v<decltype(insert<Account>().to_sql()), std::string_view>);
+static_assert(std::is_same_v<decltype(create_table<Account>().to_sql()), std::string_view>);
+static_assert(std::is_same_v<decltype(insert<Account>().rows(2).to_sql()), std::string>);
+static_assert(std::is_same_v<decltype((select_from<Account>() | where("id"_c == 1)).to_sql()), std::string>);
+
+TEST(StaticSqlTest, SelectAll) {
+    EXPECT_EQ(select_from<Account>().to_sql(),
+              "SELECT \"id\", \"owner\", \"note\", \"balance\" FROM \"Account\"");
+}
+
+TEST(StaticSqlTest, Insert) {
+    EXPECT_EQ(insert<Account>().to_sql(),
+              "INSERT INTO \"Account\" (\"id\", \"owner\", \"note\", \"balance\") VALUES (?, ?, ?, ?)");
+    EXPECT_EQ(insert_or_replace<Account>().to_sql(),
+              "INSERT OR REPLACE INTO \"Account\" (\"id\", \"owner\", \"note\", \"balance\") VALUES (?, ?, ?, ?)");
+}
+
+TEST(StaticSqlTest, CreateTableMatchesRuntimeBuild) {
+    EXPECT_EQ(create_table<Account>().to_sql(), transpilation::create_table_sql<Account>(false));
+    EXPECT_EQ(create_table<Account>(true).to_sql(), transpilation::create_table_sql<Account>(true));
+    EXPECT_NE(create_table<Account>().to_sql().find("\"owner\" VARCHAR(32) NOT NULL"), std::string_view::npos);
+}
+
+TEST(StaticSqlTest, TextIsSharedStaticStorage) {
+    auto first = insert<Account>().to_sql();
+    auto second = insert<Account>().to_sql();
+    EXPECT_EQ(first.data(), second.data());
+    EXPECT_EQ(first.data()[first.size()], '\0');
+    EXPECT_NE(first.data(), insert_or_replace<Account>().to_sql().data());
+}
+
+TEST(StaticSqlTest, IdentifiersAreQuotedAtCompileTime) {
+    static_assert(transpilation::Col<"owner">::quoted == "\"owner\"");
+    static_assert(transpilation::Col<"owner", "a">::quoted == "\"a\".\"owner\"");
+    static_assert(transpilation::Col<"say \"hi\"">::quoted == "\"say \"\"hi\"\"\"");
+    static_assert(transpilation::quoted_table_name<Account> == "\"Account\"");
+    static_assert(transpilation::quoted_field_list<Account> == "\"id\", \"owner\", \"note\", \"balance\"");
+    static_assert(transpilation::qualified_field_list<Account>.starts_with("\"Account\".\"id\", \"Account\".\"owner\""));
+
+    EXPECT_EQ(transpilation::quote_identifier("a\"b"), "\"a\"\"b\"");
+    EXPECT_EQ(transpilation::to_sql("x\"y"_c == 1), "\"x\"\"y\" = 1");
+}
@@ -1,5 +1,6 @@
 #include <glaze/glaze.hpp>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include "sqlgen/transpilation_core.hpp"
 
 using namespace sqlgen::transpilation;
@@ -78,6 +79,28 @@ TEST(TranspilationTest, QuoteString) {
     EXPECT_EQ(quote_string("test"), "'test'");
 }
 
+TEST(TranspilationTest, QuoteStringEscapesEveryQuote) {
+    EXPECT_EQ(quote_string(""), "''");
+    EXPECT_EQ(quote_string("'"), "''''");
+    EXPECT_EQ(quote_string("''x'"), "'''''x'''");
+    EXPECT_EQ(quote_string("a'b'c"), "'a''b''c'");
+
+    std::string payload(100000, 'x');
+    payload[0] = payload[4096] = payload.back() = '\'';
+    const std::string quoted = quote_string(payload);
+    EXPECT_EQ(quoted.size(), payload.size() + 2 + 3);
+    EXPECT_EQ(quoted.substr(0, 4), "'''x");
+    EXPECT_EQ(quoted.substr(quoted.size() - 4), "x'''");
+    EXPECT_EQ(std::count(quoted.begin(), quoted.end(), '\''), 8);
+}
+
+TEST(TranspilationTest, QuoteStringSplicesEmbeddedNul) {
+    using namespace std::string_literals;
+    EXPECT_EQ(quote_string("a\0b"s), "('a' || char(0) || 'b')");
+    EXPECT_EQ(quote_string("\0it's\0"s), "('' || char(0) || 'it''s' || char(0) || '')");
+    EXPECT_EQ(quote_string(std::string(1, '\0')), "('' || char(0) || '')");
+}
+
 TEST(TranspilationTest, ComplexExpression) {
     // Build: (price + tax) * quantity
     auto price = Col<"price">{};